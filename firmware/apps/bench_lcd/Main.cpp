@@ -0,0 +1,1151 @@
+// *****************************************************************************
+//
+// Project: PFPP.
+//
+// Module: LCD benchmark.
+//
+// *****************************************************************************
+
+//! \file
+//! \brief Host benchmark of the LS013B7 drawing primitives.
+//! Each primitive is compared against the previous per-pixel implementation,
+//! in time, and in the image it draws: the driver image, once flushed,
+//! is checked against the reference one.
+//! The asynchronous flush is run against a fake SSI TX FIFO, and its
+//! transactions compared to the synchronous flush ones.
+//! The COM inversion packets are checked against a sequence of ticks and flushes.
+//! \ingroup app
+
+// *****************************************************************************
+//
+//        Copyright (c) 2023, Martin Garon, All rights reserved.
+//
+// This source code is licensed under the GPL-3.0-style license found in the
+// LICENSE file in the root directory of this source tree.
+//
+// *****************************************************************************
+
+// *****************************************************************************
+//                              INCLUDE FILES
+// *****************************************************************************
+
+// Firmware Libraries.
+#include "drivers/inc/BitOrder.h"
+#include "drivers/inc/LS013B7.h"
+
+// Standard Libraries.
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdio>
+#include <functional>
+#include <vector>
+
+// *****************************************************************************
+//                      DEFINED CONSTANTS AND MACROS
+// *****************************************************************************
+
+// *****************************************************************************
+//                         TYPEDEFS AND STRUCTURES
+// *****************************************************************************
+
+struct BenchCase
+{
+    const char* mName{};
+    tRectangle mRect{};
+};
+
+struct BlitCase
+{
+    const char* mName{};
+    int32_t mX{};
+    int32_t mX0{};
+    int32_t mCount{};
+};
+
+// Transactions as seen on the bus, one per CS window.
+using Transactions = std::vector<std::vector<std::byte>>;
+
+// *****************************************************************************
+//                            FUNCTION PROTOTYPES
+// *****************************************************************************
+
+template<typename Fct>
+[[nodiscard]] static auto TimeIt(Fct&& aFct) noexcept -> double;
+
+static void RefPixelDraw(int32_t aX, int32_t aY, uint32_t aColor) noexcept;
+static void RefRectFill(const tRectangle& aRect, uint32_t aColor) noexcept;
+static void RefPixelDrawMultiple1BPP(
+    int32_t aX,
+    int32_t aY,
+    int32_t aX0,
+    int32_t aCount,
+    const uint8_t* aData,
+    const uint32_t* aPalette
+) noexcept;
+static void RefPixelDrawMultiple4BPP(
+    int32_t aX,
+    int32_t aY,
+    int32_t aX0,
+    int32_t aCount,
+    const uint8_t* aData,
+    const uint8_t* aPalette
+) noexcept;
+static void RefPixelDrawMultiple8BPP(
+    int32_t aX,
+    int32_t aY,
+    int32_t aCount,
+    const uint8_t* aData,
+    const uint8_t* aPalette
+) noexcept;
+static void RefPaletteEntryDraw(int32_t aX, int32_t aY, const uint8_t* aEntry) noexcept;
+
+static void DrawBackground(tDisplay& aDisplay) noexcept;
+[[nodiscard]] static auto IsSameAsRef(tDisplay& aDisplay) noexcept -> bool;
+[[nodiscard]] static auto CheckBitOrder() noexcept -> bool;
+[[nodiscard]] static auto CheckFills(tDisplay& aDisplay) noexcept -> bool;
+[[nodiscard]] static auto CheckBlits(tDisplay& aDisplay, const uint8_t* aData) noexcept -> bool;
+[[nodiscard]] static auto CheckPaletteImages(tDisplay& aDisplay) noexcept -> bool;
+static void RefRLEImageDraw(
+    int32_t aX,
+    int32_t aY,
+    const Drivers::RLEImage& aImage,
+    uint32_t aColor,
+    std::optional<uint32_t> aBkColor
+) noexcept;
+[[nodiscard]] static auto CheckRLEImages(tDisplay& aDisplay) noexcept -> bool;
+[[nodiscard]] static auto CheckOverlays(tDisplay& aDisplay) noexcept -> bool;
+
+[[nodiscard]] static auto RunFlushes() noexcept -> bool;
+[[nodiscard]] static auto RunMaintenance() noexcept -> bool;
+static void DrawScene(tDisplay& aDisplay, int32_t aSceneIx) noexcept;
+
+// *****************************************************************************
+//                             GLOBAL VARIABLES
+// *****************************************************************************
+
+static constexpr auto sIterations{100000};
+
+static constexpr std::array sBenchCases{
+    BenchCase{"narrow 4px column", {60, 0, 63, 127}},
+    BenchCase{"menu highlight bar", {20, 20, 100, 40}},
+    BenchCase{"menu frame", {5, 5, 122, 122}},
+    BenchCase{"full screen", {0, 0, 127, 127}}
+};
+
+static constexpr std::array sBlitCases{
+    BlitCase{"6px glyph row", 41, 0, 6},
+    BlitCase{"6px glyph, shifted", 43, 5, 6},
+    BlitCase{"image row, aligned", 0, 0, 128},
+    BlitCase{"image row, shifted", 3, 6, 120}
+};
+
+// Reference: per-pixel row mask, combined over the whole line.
+using RefLine = std::array<std::byte, 16>;
+static std::array<RefLine, 128> sRefImgBuf{};
+
+// Keeps the compiler from discarding the reference results.
+volatile std::byte sSink{};
+
+// Fake SSI: a TX FIFO that shifts out down to its interrupt level between interrupts,
+// or entirely in end of transmission mode.
+static constexpr std::size_t sFIFODepth{8};
+static constexpr std::size_t sFIFOIntLevel{sFIFODepth / 2};
+static std::size_t sFIFOLevel{0};
+static bool sIsTxIntEnabled{false};
+static bool sIsTxEOTEnabled{false};
+static unsigned int sEarlyEndWrCount{0};
+static bool sIsFlushDone{false};
+
+static Transactions sSyncTransactions{};
+static Transactions sAsyncTransactions{};
+static Transactions sMaintenanceTransactions{};
+
+// *****************************************************************************
+//                            EXPORTED FUNCTIONS
+// *****************************************************************************
+
+int main()
+{
+    Drivers::LS013B7DH03 lLCD{
+        [](std::span<const std::byte> /*aData*/, std::optional<std::byte> /*aAddr*/) noexcept {},
+        []() noexcept {},
+        []() noexcept {}
+    };
+    tDisplay& lDisplay{lLCD};
+
+    std::printf("%-20s %12s %12s %8s\n", "RectFill", "ref [ns]", "LS013B7 [ns]", "speedup");
+    for (const auto& lCase : sBenchCases) {
+        auto lColor{0U};
+        const auto lRefTime{
+            TimeIt([&lCase, &lColor]() noexcept {RefRectFill(lCase.mRect, lColor ^= 1);})
+        };
+        const auto lTime{
+            TimeIt(
+                [&lDisplay, &lCase, &lColor]() noexcept
+                {
+                    lDisplay.pfnRectFill(lDisplay.pvDisplayData, &lCase.mRect, lColor ^= 1);
+                }
+            )
+        };
+
+        std::printf("%-20s %12.1f %12.1f %7.1fx\n", lCase.mName, lRefTime, lTime, lRefTime / lTime);
+    }
+    auto lIsValid{CheckBitOrder()};
+    lIsValid = lIsValid && CheckFills(lDisplay);
+
+    static constexpr std::array<uint8_t, 17> sImgData{
+        0x3c, 0x42, 0x81, 0xa5, 0x81, 0x99, 0x42, 0x3c,
+        0x3c, 0x42, 0x81, 0xa5, 0x81, 0x99, 0x42, 0x3c,
+        0xff
+    };
+    static constexpr std::array<uint32_t, 2> sPalette{0, 1};
+
+    std::printf("\n%-20s %12s %12s %8s\n", "1 BPP blit", "ref [ns]", "LS013B7 [ns]", "speedup");
+    for (const auto& lCase : sBlitCases) {
+        auto lRowIx{0};
+        const auto lRefTime{
+            TimeIt(
+                [&lCase, &lRowIx]() noexcept
+                {
+                    RefPixelDrawMultiple1BPP(
+                        lCase.mX, lRowIx++ & 0x7f, lCase.mX0, lCase.mCount,
+                        sImgData.data(), sPalette.data()
+                    );
+                }
+            )
+        };
+        const auto lTime{
+            TimeIt(
+                [&lDisplay, &lCase, &lRowIx]() noexcept
+                {
+                    lDisplay.pfnPixelDrawMultiple(
+                        lDisplay.pvDisplayData,
+                        lCase.mX, lRowIx++ & 0x7f, lCase.mX0, lCase.mCount, 1,
+                        sImgData.data(), reinterpret_cast<const uint8_t*>(sPalette.data())
+                    );
+                }
+            )
+        };
+
+        std::printf("%-20s %12.1f %12.1f %7.1fx\n", lCase.mName, lRefTime, lTime, lRefTime / lTime);
+    }
+    lIsValid = lIsValid && CheckBlits(lDisplay, sImgData.data());
+
+    // Full screen art: bands of 16 px bars, every other group of 8 rows.
+    // As a 1 BPP image drawn row by row, and as runs.
+    static constexpr auto sIsArtRowBlank{[](const int32_t aRowIx) noexcept {return (aRowIx / 8) % 2 == 0;}};
+    static constexpr auto sArtImg{
+        []() noexcept
+        {
+            std::array<uint8_t, 128 * 16> lImg{};
+            for (auto lRowIx{0}; lRowIx < 128; ++lRowIx) {
+                for (auto lByteIx{0}; lByteIx < 16; ++lByteIx) {
+                    lImg[lRowIx * 16 + lByteIx] = (sIsArtRowBlank(lRowIx) || (lByteIx % 4 < 2)) ? 0x00 : 0xff;
+                }
+            }
+            return lImg;
+        }()
+    };
+    static constexpr auto sArtRuns{
+        []() noexcept
+        {
+            // Blank rows: a single long run. Banded rows: 16 px runs, adding up to the width.
+            std::array<uint8_t, 64 * 2 + 64 * 8> lRuns{};
+            auto lRunIx{0U};
+            for (auto lRowIx{0}; lRowIx < 128; ++lRowIx) {
+                if (sIsArtRowBlank(lRowIx)) {
+                    lRuns[lRunIx++] = Drivers::RLEImage::sLongRunFlag;
+                    lRuns[lRunIx++] = 128;
+                    continue;
+                }
+                for (auto lBarIx{0}; lBarIx < 8; ++lBarIx) {
+                    lRuns[lRunIx++] = 16;
+                }
+            }
+            return lRuns;
+        }()
+    };
+    static constexpr Drivers::RLEImage sArt{128, 128, sArtRuns};
+
+    std::printf("\n%-20s %12s %12s %12s\n", "Full screen art", "ref [ns]", "1 BPP [ns]", "RLE [ns]");
+    const auto lRefArtTime{
+        TimeIt(
+            []() noexcept
+            {
+                for (auto lRowIx{0}; lRowIx < 128; ++lRowIx) {
+                    RefPixelDrawMultiple1BPP(0, lRowIx, 0, 128, &sArtImg[lRowIx * 16], sPalette.data());
+                }
+            }
+        )
+    };
+    const auto lBlitTime{
+        TimeIt(
+            [&lDisplay]() noexcept
+            {
+                for (auto lRowIx{0}; lRowIx < 128; ++lRowIx) {
+                    lDisplay.pfnPixelDrawMultiple(
+                        lDisplay.pvDisplayData,
+                        0, lRowIx, 0, 128, 1,
+                        &sArtImg[lRowIx * 16], reinterpret_cast<const uint8_t*>(sPalette.data())
+                    );
+                }
+            }
+        )
+    };
+    const auto lRLETime{
+        TimeIt([&lLCD]() noexcept {lLCD.RLEImageDraw(0, 0, sArt, 1, 0);})
+    };
+    std::printf("%-20s %12.1f %12.1f %12.1f\n", "128x128, 50% bands", lRefArtTime, lBlitTime, lRLETime);
+    std::printf("%-20s %12s %12zu %12zu\n", "  size [bytes]", "", sArtImg.size(), sArtRuns.size());
+    if (!IsSameAsRef(lDisplay)) {
+        std::printf("RLE, full screen art: image differs from the reference.\n");
+        lIsValid = false;
+    }
+    lIsValid = lIsValid && CheckRLEImages(lDisplay);
+    lIsValid = lIsValid && CheckOverlays(lDisplay);
+
+    lIsValid = lIsValid && CheckPaletteImages(lDisplay);
+
+    sSink = sRefImgBuf[64][8];
+    lIsValid = lIsValid && RunFlushes() && RunMaintenance();
+    return lIsValid ? 0 : 1;
+}
+
+// *****************************************************************************
+//                              LOCAL FUNCTIONS
+// *****************************************************************************
+
+template<typename Fct>
+static auto TimeIt(Fct&& aFct) noexcept -> double
+{
+    const auto lStart{std::chrono::steady_clock::now()};
+    for (auto lIx{0}; lIx < sIterations; ++lIx) {
+        aFct();
+    }
+    const std::chrono::duration<double, std::nano> lElapsed{std::chrono::steady_clock::now() - lStart};
+
+    return lElapsed.count() / sIterations;
+}
+
+
+static void RefPixelDraw(const int32_t aX, const int32_t aY, const uint32_t aColor) noexcept
+{
+    auto& lByte{sRefImgBuf[aY][aX / 8]};
+    const auto lMask{std::byte{0x80} >> (aX % 8)};
+    lByte = aColor ? (lByte & ~lMask) : (lByte | lMask);
+}
+
+
+static void RefRectFill(const tRectangle& aRect, const uint32_t aColor) noexcept
+{
+    RefLine lNewRow{};
+    for (auto lX{aRect.i16XMin}; lX <= aRect.i16XMax; ++lX) {
+        lNewRow[lX / 8] |= std::byte{0x80} >> (lX % 8);
+    }
+
+    for (auto lRowIx{aRect.i16YMin}; lRowIx <= aRect.i16YMax; ++lRowIx) {
+        auto& lRow{sRefImgBuf[lRowIx]};
+        if (aColor) {
+            std::transform(
+                lNewRow.cbegin(), lNewRow.cend(),
+                lRow.cbegin(), lRow.begin(),
+                [](const auto aMask, const auto aByte) noexcept {return aByte & ~aMask;}
+            );
+        }
+        else {
+            std::transform(
+                lNewRow.cbegin(), lNewRow.cend(),
+                lRow.cbegin(), lRow.begin(),
+                std::bit_or<>{}
+            );
+        }
+    }
+}
+
+
+static void RefPixelDrawMultiple1BPP(
+    const int32_t aX,
+    const int32_t aY,
+    const int32_t aX0,
+    const int32_t aCount,
+    const uint8_t* const aData,
+    const uint32_t* const aPalette
+) noexcept
+{
+    // Reference: one pixel at a time, palette lookup per pixel.
+    auto& lRow{sRefImgBuf[aY]};
+    for (auto lIx{0}; lIx < aCount; ++lIx) {
+        const auto lSourceBitIx{aX0 + lIx};
+        const auto lColorIx{(aData[lSourceBitIx / 8] >> (7 - (lSourceBitIx % 8))) & 0x1};
+        const auto lX{aX + lIx};
+        const auto lMask{std::byte{0x80} >> (lX % 8)};
+        lRow[lX / 8] = aPalette[lColorIx] ? (lRow[lX / 8] & ~lMask) : (lRow[lX / 8] | lMask);
+    }
+}
+
+
+static void DrawBackground(tDisplay& aDisplay) noexcept
+{
+    // Diagonal stripes in both the driver and the reference image:
+    // a pixel wrongly lit or cleared shows either way.
+    for (auto lRowIx{0}; lRowIx < 128; ++lRowIx) {
+        for (auto lX{0}; lX < 128; ++lX) {
+            const auto lColor{static_cast<uint32_t>(((lX + lRowIx) / 3) % 2)};
+            RefPixelDraw(lX, lRowIx, lColor);
+            aDisplay.pfnPixelDraw(aDisplay.pvDisplayData, lX, lRowIx, lColor);
+        }
+    }
+}
+
+
+static auto IsSameAsRef(tDisplay& aDisplay) noexcept -> bool
+{
+    // The panel buffer holds the image as flushed, in the reference format.
+    aDisplay.pfnFlush(aDisplay.pvDisplayData);
+    const auto& lLCD{*static_cast<const Drivers::LS013B7DH03*>(aDisplay.pvDisplayData)};
+    for (auto lRowIx{0}; lRowIx < 128; ++lRowIx) {
+        if (!std::ranges::equal(lLCD.GetPanelLine(lRowIx), sRefImgBuf[lRowIx])) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+
+static auto CheckBitOrder() noexcept -> bool
+{
+    // The conversions as run against the portable path, which is all a static_assert sees.
+    // On the host, that is the portable path against itself: built for a Cortex-M3/M4,
+    // this covers RBIT and REV. Every single bit, every byte value in every byte
+    // over a pattern, and a pseudo-random sequence of words.
+    const auto lIsSame{
+        [](const uint32_t aWord) noexcept {
+            using namespace Drivers::BitOrder;
+            return (ReverseBytes(aWord) == ReverseBytesPortable(aWord))
+                && (ReverseBits(aWord) == ReverseBitsPortable(aWord))
+                && (ReverseBitsInBytes(aWord) == ReverseBytesPortable(ReverseBitsPortable(aWord)));
+        }
+    };
+
+    auto lIsValid{true};
+    for (auto lShift{0}; lShift < 32; ++lShift) {
+        lIsValid &= lIsSame(uint32_t{1} << lShift) && lIsSame(~(uint32_t{1} << lShift));
+    }
+
+    for (uint32_t lByte{0}; lByte < 256; ++lByte) {
+        for (auto lShift{0}; lShift < 32; lShift += 8) {
+            const auto lPattern{uint32_t{0x5a3cc3a5} & ~(uint32_t{0xff} << lShift)};
+            lIsValid &= lIsSame(lPattern | (lByte << lShift));
+        }
+    }
+
+    // Pseudo-random words, from the Numerical Recipes LCG.
+    uint32_t lWord{0x12345678};
+    for (auto lIx{0}; lIx < 1024; ++lIx) {
+        lWord = lWord * 1664525 + 1013904223;
+        lIsValid &= lIsSame(lWord);
+    }
+
+    if (!lIsValid) {
+        std::printf("Bit order: conversions differ from the portable path.\n");
+    }
+    return lIsValid;
+}
+
+
+static auto CheckFills(tDisplay& aDisplay) noexcept -> bool
+{
+    // Each timed case, lit then cleared, with a line across its last row.
+    DrawBackground(aDisplay);
+    for (const auto& lCase : sBenchCases) {
+        for (const auto lColor : {1U, 0U}) {
+            RefRectFill(lCase.mRect, lColor);
+            aDisplay.pfnRectFill(aDisplay.pvDisplayData, &lCase.mRect, lColor);
+            if (!IsSameAsRef(aDisplay)) {
+                std::printf("RectFill, %s: image differs from the reference.\n", lCase.mName);
+                return false;
+            }
+
+            const tRectangle lLine{lCase.mRect.i16XMin, lCase.mRect.i16YMax, lCase.mRect.i16XMax, lCase.mRect.i16YMax};
+            RefRectFill(lLine, !lColor);
+            aDisplay.pfnLineDrawH(aDisplay.pvDisplayData, lLine.i16XMin, lLine.i16XMax, lLine.i16YMin, !lColor);
+            if (!IsSameAsRef(aDisplay)) {
+                std::printf("LineDrawH, %s: image differs from the reference.\n", lCase.mName);
+                return false;
+            }
+        }
+    }
+
+    // Every head and tail alignment of a span, within one word and across words.
+    for (int16_t lX1{0}; lX1 < 64; ++lX1) {
+        for (auto lX2{lX1}; lX2 < std::min(lX1 + 72, 128); ++lX2) {
+            const auto lRowIx{static_cast<int16_t>((lX1 + lX2) % 128)};
+            const auto lColor{static_cast<uint32_t>(lX2 % 2)};
+            RefRectFill({lX1, lRowIx, static_cast<int16_t>(lX2), lRowIx}, lColor);
+            aDisplay.pfnLineDrawH(aDisplay.pvDisplayData, lX1, lX2, lRowIx, lColor);
+            if (!IsSameAsRef(aDisplay)) {
+                std::printf("LineDrawH, %d to %d: image differs from the reference.\n", lX1, lX2);
+                return false;
+            }
+        }
+    }
+
+    std::printf("%-20s %12s\n", "  image", "same as ref");
+    return true;
+}
+
+
+static auto CheckBlits(tDisplay& aDisplay, const uint8_t* const aData) noexcept -> bool
+{
+    // Every palette: clear bits are drawn in palette[0], not left alone.
+    static constexpr std::array sPalettes{
+        std::array<uint32_t, 2>{0, 1},
+        std::array<uint32_t, 2>{1, 0},
+        std::array<uint32_t, 2>{1, 1},
+        std::array<uint32_t, 2>{0, 0}
+    };
+
+    // Every image bit and word alignment against every source bit alignment,
+    // rows within one byte, one word, and across words.
+    DrawBackground(aDisplay);
+    for (const auto& lPalette : sPalettes) {
+        const auto lPaletteData{reinterpret_cast<const uint8_t*>(lPalette.data())};
+        for (auto lX{0}; lX < 40; ++lX) {
+            for (auto lX0{0}; lX0 < 16; ++lX0) {
+                for (const auto lCount : {1, 5, 8, 9, 31, 32, 33, 70}) {
+                    const auto lRowIx{(lX * 16 + lX0 + lCount) % 128};
+                    RefPixelDrawMultiple1BPP(lX, lRowIx, lX0, lCount, aData, lPalette.data());
+                    aDisplay.pfnPixelDrawMultiple(aDisplay.pvDisplayData, lX, lRowIx, lX0, lCount, 1, aData, lPaletteData);
+                    if (!IsSameAsRef(aDisplay)) {
+                        std::printf(
+                            "1 BPP, palette {%u, %u}, x %d, x0 %d, %d pixels: image differs from the reference.\n",
+                            lPalette[0], lPalette[1], lX, lX0, lCount
+                        );
+                        return false;
+                    }
+                }
+            }
+        }
+    }
+
+    // Without a palette, bits are drawn black and white.
+    for (auto lX{0}; lX < 40; ++lX) {
+        for (const auto lX0 : {0, 3}) {
+            const auto lRowIx{(lX * 5 + lX0) % 128};
+            RefPixelDrawMultiple1BPP(lX, lRowIx, lX0, 33, aData, sPalettes[0].data());
+            aDisplay.pfnPixelDrawMultiple(aDisplay.pvDisplayData, lX, lRowIx, lX0, 33, 1, aData, nullptr);
+            if (!IsSameAsRef(aDisplay)) {
+                std::printf("1 BPP, no palette, x %d, x0 %d: image differs from the reference.\n", lX, lX0);
+                return false;
+            }
+        }
+    }
+
+    // Empty rows draw nothing.
+    const auto lPaletteData{reinterpret_cast<const uint8_t*>(sPalettes[2].data())};
+    for (const auto lCount : {0, -1}) {
+        aDisplay.pfnPixelDrawMultiple(aDisplay.pvDisplayData, 0, 0, 0, lCount, 1, aData, lPaletteData);
+        aDisplay.pfnPixelDrawMultiple(aDisplay.pvDisplayData, 77, 5, 3, lCount, 1, aData, lPaletteData);
+    }
+    if (!IsSameAsRef(aDisplay)) {
+        std::printf("1 BPP, empty rows: image differs from the reference.\n");
+        return false;
+    }
+
+    std::printf("%-20s %12s\n", "  image", "same as ref");
+    return true;
+}
+
+
+static void RefPixelDrawMultiple4BPP(
+    const int32_t aX,
+    const int32_t aY,
+    const int32_t aX0,
+    const int32_t aCount,
+    const uint8_t* const aData,
+    const uint8_t* const aPalette
+) noexcept
+{
+    // Reference: one pixel at a time, its palette entry translated as grlib does.
+    // Upper nibble first, an odd aX0 starting on the lower one.
+    // The byte ahead of the palette holds the index of its last entry: past it, unlit.
+    for (auto lIx{0}; lIx < aCount; ++lIx) {
+        const auto lNibbleIx{(aX0 & 0x1) + lIx};
+        const auto lByte{aData[lNibbleIx / 2]};
+        const auto lColorIx{(lNibbleIx % 2) ? (lByte & 0xf) : (lByte >> 4)};
+        if (lColorIx <= aPalette[-1]) {
+            RefPaletteEntryDraw(aX + lIx, aY, &aPalette[lColorIx * 3]);
+        }
+        else {
+            RefPixelDraw(aX + lIx, aY, 0);
+        }
+    }
+}
+
+
+static void RefPixelDrawMultiple8BPP(
+    const int32_t aX,
+    const int32_t aY,
+    const int32_t aCount,
+    const uint8_t* const aData,
+    const uint8_t* const aPalette
+) noexcept
+{
+    // Reference: one pixel at a time, its palette entry translated as grlib does.
+    // The byte ahead of the palette holds the index of its last entry: past it, unlit.
+    for (auto lIx{0}; lIx < aCount; ++lIx) {
+        if (aData[lIx] <= aPalette[-1]) {
+            RefPaletteEntryDraw(aX + lIx, aY, &aPalette[aData[lIx] * 3]);
+        }
+        else {
+            RefPixelDraw(aX + lIx, aY, 0);
+        }
+    }
+}
+
+
+static void RefPaletteEntryDraw(const int32_t aX, const int32_t aY, const uint8_t* const aEntry) noexcept
+{
+    // Blue, green, red: lit from mid-gray luminance on.
+    const auto lLuma{aEntry[2] * 19661U + aEntry[1] * 38666U + aEntry[0] * 7209U};
+    RefPixelDraw(aX, aY, lLuma / (65536 * 128));
+}
+
+
+static auto CheckPaletteImages(tDisplay& aDisplay) noexcept -> bool
+{
+    // Gray palette entries, lit from mid-gray on, in scrambled order, behind the index
+    // of the last one. Past it, the array holds white entries that a read beyond
+    // the palette would draw lit.
+    static constexpr auto sMakePalette4BPP{
+        [](const int32_t aColorCount) noexcept
+        {
+            std::array<uint8_t, 1 + 16 * 3> lPalette{};
+            lPalette.fill(0xff);
+            lPalette[0] = static_cast<uint8_t>(aColorCount - 1);
+            for (auto lColorIx{0}; lColorIx < aColorCount; ++lColorIx) {
+                const auto lGray{static_cast<uint8_t>(((lColorIx * 5) % 16) * 17)};
+                std::fill_n(&lPalette[1 + lColorIx * 3], 3, lGray);
+            }
+            return lPalette;
+        }
+    };
+    static constexpr std::array sPalettes4BPP{sMakePalette4BPP(16), sMakePalette4BPP(6)};
+
+    // Pseudo-random pixel data.
+    static constexpr auto sPixelData{
+        []() noexcept
+        {
+            std::array<uint8_t, 128> lData{};
+            uint32_t lSeed{0x1234567};
+            for (auto& lByte : lData) {
+                lSeed = lSeed * 1103515245 + 12345;
+                lByte = static_cast<uint8_t>(lSeed >> 16);
+            }
+            return lData;
+        }()
+    };
+
+    // Every image byte and word alignment, both source nibbles first, short and long rows,
+    // from a full palette and a 6-entry one.
+    std::printf("\n%-20s %12s\n", "Palette image", "image");
+    DrawBackground(aDisplay);
+    for (const auto& lPaletteData : sPalettes4BPP) {
+        const auto lPalette{&lPaletteData[1]};
+        for (auto lX{0}; lX < 40; ++lX) {
+            for (const auto lCount : {1, 2, 7, 8, 9, 33, 60}) {
+                for (const auto lX0 : {0, 1}) {
+                    const auto lRowIx{(lX * 3 + lCount + lX0) % 128};
+                    const auto lData{&sPixelData[(lX + lCount) % 32]};
+                    RefPixelDrawMultiple4BPP(lX, lRowIx, lX0, lCount, lData, lPalette);
+                    aDisplay.pfnPixelDrawMultiple(aDisplay.pvDisplayData, lX, lRowIx, lX0, lCount, 4, lData, lPalette);
+                    if (!IsSameAsRef(aDisplay)) {
+                        std::printf(
+                            "4 BPP, %d entries, x %d, x0 %d, %d pixels: image differs from the reference.\n",
+                            lPalette[-1] + 1, lX, lX0, lCount
+                        );
+                        return false;
+                    }
+                }
+            }
+        }
+    }
+    std::printf("%-20s %12s\n", "4 BPP, palettes", "same as ref");
+
+    // 8 BPP, from palettes of 256, 200 and 17 entries in turn, then the first again:
+    // each is resolved anew. Past its last entry, the array holds white ones
+    // that a read beyond the palette would draw lit.
+    static constexpr auto sMakePalette8BPP{
+        [](const int32_t aColorCount, const int32_t aStep) noexcept
+        {
+            std::array<uint8_t, 1 + 256 * 3> lPalette{};
+            lPalette.fill(0xff);
+            lPalette[0] = static_cast<uint8_t>(aColorCount - 1);
+            for (auto lColorIx{0}; lColorIx < aColorCount; ++lColorIx) {
+                const auto lGray{static_cast<uint8_t>((lColorIx * aStep + 64) % 256)};
+                std::fill_n(&lPalette[1 + lColorIx * 3], 3, lGray);
+            }
+            return lPalette;
+        }
+    };
+    static constexpr std::array sPalettes8BPP{
+        sMakePalette8BPP(256, 5), sMakePalette8BPP(200, 7), sMakePalette8BPP(17, 9)
+    };
+    for (const auto lPaletteIx : {0, 1, 2, 0}) {
+        const auto lPalette{&sPalettes8BPP[lPaletteIx][1]};
+        for (auto lX{0}; lX < 40; ++lX) {
+            for (const auto lCount : {1, 7, 9, 33, 88}) {
+                const auto lRowIx{(lX * 3 + lCount + lPaletteIx) % 128};
+                const auto lData{&sPixelData[(lX + lCount) % 32]};
+                RefPixelDrawMultiple8BPP(lX, lRowIx, lCount, lData, lPalette);
+                aDisplay.pfnPixelDrawMultiple(aDisplay.pvDisplayData, lX, lRowIx, 0, lCount, 8, lData, lPalette);
+                if (!IsSameAsRef(aDisplay)) {
+                    std::printf(
+                        "8 BPP, %d entries, x %d, %d pixels: image differs from the reference.\n",
+                        lPalette[-1] + 1, lX, lCount
+                    );
+                    return false;
+                }
+            }
+        }
+    }
+    std::printf("%-20s %12s\n", "8 BPP, palettes", "same as ref");
+
+    return true;
+}
+
+
+static void RefRLEImageDraw(
+    const int32_t aX,
+    const int32_t aY,
+    const Drivers::RLEImage& aImage,
+    const uint32_t aColor,
+    const std::optional<uint32_t> aBkColor
+) noexcept
+{
+    // Reference: one pixel at a time, each run alternating from clear pixels.
+    auto lData{aImage.mData};
+    for (auto lRowIx{0}; lRowIx < aImage.mHeight; ++lRowIx) {
+        auto lIsSet{false};
+        for (auto lPixelIx{0}; lPixelIx < aImage.mWidth; lIsSet = !lIsSet) {
+            const auto lRun{Drivers::RLEImage::ReadRun(lData)};
+            for (auto lIx{0}; (lIx < lRun) && (lPixelIx < aImage.mWidth); ++lIx, ++lPixelIx) {
+                const auto lX{aX + lPixelIx};
+                const auto lY{aY + lRowIx};
+                if ((lX < 0) || (lX >= 128) || (lY < 0) || (lY >= 128)) {
+                    continue;
+                }
+                if (lIsSet) {
+                    RefPixelDraw(lX, lY, aColor);
+                }
+                else if (aBkColor) {
+                    RefPixelDraw(lX, lY, *aBkColor);
+                }
+            }
+        }
+    }
+}
+
+
+static auto CheckRLEImages(tDisplay& aDisplay) noexcept -> bool
+{
+    // Random images: rows of short and long runs, all set and all clear rows,
+    // and rows starting with set pixels, i.e. with an empty first run.
+    // Widths within a byte, across words, and wider than the panel.
+    auto lSeed{0x1234567U};
+    const auto lRandom{
+        [&lSeed](const int aMax) noexcept
+        {
+            lSeed = lSeed * 1664525U + 1013904223U;
+            return static_cast<int>((lSeed >> 8) % static_cast<unsigned int>(aMax));
+        }
+    };
+    static constexpr auto sImgHeight{9};
+    std::vector<std::vector<uint8_t>> lImgData{};
+    std::vector<Drivers::RLEImage> lImgs{};
+    for (const auto lWidth : {1, 13, 33, 70, 150}) {
+        auto& lData{lImgData.emplace_back(lWidth * sImgHeight * 2)};
+        auto lSize{0U};
+        for (auto lRowIx{0}; lRowIx < sImgHeight; ++lRowIx) {
+            auto lIsSet{false};
+            auto lPixelIx{0};
+            while (lPixelIx < lWidth) {
+                int32_t lRun{};
+                switch (lRowIx % 4) {
+                case 0: lRun = lRandom(4); break;
+                case 1: lRun = lIsSet ? lWidth : 0; break;
+                case 2: lRun = lIsSet ? 0 : lWidth; break;
+                default: lRun = ((lPixelIx == 0) && !lIsSet) ? 0 : 1 + lRandom(lWidth); break;
+                }
+                lRun = std::min(lRun, lWidth - lPixelIx);
+                lSize += Drivers::RLEImage::WriteRun(std::span{lData}.subspan(lSize), lRun);
+                lPixelIx += lRun;
+                lIsSet = !lIsSet;
+            }
+        }
+        lData.resize(lSize);
+        lImgs.push_back(
+            Drivers::RLEImage{static_cast<uint16_t>(lWidth), static_cast<uint16_t>(sImgHeight), lData}
+        );
+    }
+
+    // Placed across every edge, in every color combination, over a fill.
+    struct Colors
+    {
+        uint32_t mColor{};
+        std::optional<uint32_t> mBkColor{};
+    };
+    static constexpr std::array sColors{
+        Colors{1, std::nullopt},
+        Colors{0, std::nullopt},
+        Colors{1, 0},
+        Colors{0, 1}
+    };
+
+    std::printf("\n%-20s %12s\n", "RLE image", "image");
+    auto& lLCD{*static_cast<Drivers::LS013B7DH03*>(aDisplay.pvDisplayData)};
+    DrawBackground(aDisplay);
+    for (const auto& lImg : lImgs) {
+        for (const auto lX : {-160, -40, -3, 0, 5, 31, 64, 100, 127, 130}) {
+            for (const auto lY : {-5, 0, 60, 123}) {
+                for (const auto& lColors : sColors) {
+                    const tRectangle lFill{
+                        static_cast<int16_t>(std::clamp(lX + 2, 0, 127)), static_cast<int16_t>(std::clamp(lY + 1, 0, 127)),
+                        static_cast<int16_t>(std::clamp(lX + 20, 0, 127)), static_cast<int16_t>(std::clamp(lY + 3, 0, 127))
+                    };
+                    RefRectFill(lFill, !lColors.mColor);
+                    aDisplay.pfnRectFill(aDisplay.pvDisplayData, &lFill, !lColors.mColor);
+                    RefRLEImageDraw(lX, lY, lImg, lColors.mColor, lColors.mBkColor);
+                    lLCD.RLEImageDraw(lX, lY, lImg, lColors.mColor, lColors.mBkColor);
+                    if (!IsSameAsRef(aDisplay)) {
+                        std::printf(
+                            "RLE, %d px wide at %d, %d, colors %u/%d: image differs from the reference.\n",
+                            lImg.mWidth, lX, lY,
+                            lColors.mColor, lColors.mBkColor ? static_cast<int>(*lColors.mBkColor) : -1
+                        );
+                        return false;
+                    }
+                }
+            }
+        }
+    }
+
+    std::printf("%-20s %12s\n", "  clipped placements", "same as ref");
+    return true;
+}
+
+
+static auto CheckOverlays(tDisplay& aDisplay) noexcept -> bool
+{
+    // A popup drawn over the image, then closed: the image under it comes back,
+    // drawing out of it is kept, and only the overlay lines are sent again.
+    // Overlays within a word, across words, and clipped by the panel.
+    static constexpr std::array sRects{
+        tRectangle{20, 30, 90, 60},
+        tRectangle{3, 100, 37, 127},
+        tRectangle{-10, -5, 40, 10},
+        tRectangle{33, 70, 34, 71}
+    };
+
+    std::printf("\n%-20s %12s\n", "Overlay", "lines sent");
+    auto& lLCD{*static_cast<Drivers::LS013B7DH03*>(aDisplay.pvDisplayData)};
+    std::array<uint32_t, Drivers::ILCD::GetOverlaySaveSize(sRects[0])> lSaveBuf{};
+    const auto lTakeChangedRows{
+        [&lLCD, &aDisplay]() noexcept
+        {
+            aDisplay.pfnFlush(aDisplay.pvDisplayData);
+            std::vector<int32_t> lRows{};
+            for (auto lRowIx{0}; lRowIx < 128; ++lRowIx) {
+                if (lLCD.TakeLineChanged(lRowIx)) {
+                    lRows.push_back(lRowIx);
+                }
+            }
+            return lRows;
+        }
+    };
+
+    DrawBackground(aDisplay);
+    static_cast<void>(lTakeChangedRows());
+    for (const auto& lRect : sRects) {
+        const auto lSaveBufSpan{std::span{lSaveBuf}.first(Drivers::ILCD::GetOverlaySaveSize(lRect))};
+        if (lLCD.OverlayOpen(lRect, lSaveBufSpan.first(lSaveBufSpan.size() / 4))
+            || !lLCD.OverlayOpen(lRect, lSaveBufSpan)
+            || lLCD.OverlayOpen(lRect, lSaveBufSpan)) {
+            std::printf("Overlay, %d, %d: opened with a short buffer, or twice.\n", lRect.i16XMin, lRect.i16YMin);
+            return false;
+        }
+
+        // The popup, as clipped by grlib: an outline and a filled body.
+        // Next to it, a fill that stays.
+        const auto lClip{
+            [](const int32_t aX1, const int32_t aY1, const int32_t aX2, const int32_t aY2) noexcept
+            {
+                return tRectangle{
+                    static_cast<int16_t>(std::max(aX1, 0)), static_cast<int16_t>(std::max(aY1, 0)),
+                    static_cast<int16_t>(std::min(aX2, 127)), static_cast<int16_t>(std::min(aY2, 127))
+                };
+            }
+        };
+        const auto lOutline{lClip(lRect.i16XMin, lRect.i16YMin, lRect.i16XMax, lRect.i16YMax)};
+        const auto lBody{lClip(lRect.i16XMin + 1, lRect.i16YMin + 1, lRect.i16XMax - 1, lRect.i16YMax - 1)};
+        aDisplay.pfnRectFill(aDisplay.pvDisplayData, &lOutline, 1);
+        if ((lBody.i16XMin <= lBody.i16XMax) && (lBody.i16YMin <= lBody.i16YMax)) {
+            aDisplay.pfnRectFill(aDisplay.pvDisplayData, &lBody, 0);
+        }
+        const auto lBeside{lClip(lOutline.i16XMax + 1, lOutline.i16YMin, 127, lOutline.i16YMin + 1)};
+        RefRectFill(lBeside, 1);
+        aDisplay.pfnRectFill(aDisplay.pvDisplayData, &lBeside, 1);
+        static_cast<void>(lTakeChangedRows());
+
+        lLCD.OverlayClose();
+        const auto lRows{lTakeChangedRows()};
+        const auto lIsWithin{
+            std::ranges::all_of(
+                lRows,
+                [&lOutline](const int32_t aRowIx) noexcept
+                {
+                    return (aRowIx >= lOutline.i16YMin) && (aRowIx <= lOutline.i16YMax);
+                }
+            )
+        };
+        if (!IsSameAsRef(aDisplay) || !lIsWithin) {
+            std::printf(
+                "Overlay, %d, %d, %d, %d: closed image differs from the reference, or lines out of it sent.\n",
+                lRect.i16XMin, lRect.i16YMin, lRect.i16XMax, lRect.i16YMax
+            );
+            return false;
+        }
+
+        std::printf(
+            "  %3d..%-3d x %3d..%-3d %12zu\n",
+            lRect.i16XMin, lRect.i16XMax, lRect.i16YMin, lRect.i16YMax, lRows.size()
+        );
+    }
+
+    return true;
+}
+
+
+static auto RunFlushes() noexcept -> bool
+{
+    Drivers::LS013B7DH03 lSyncLCD{
+        [](std::span<const std::byte> aData, std::optional<std::byte> aAddr) noexcept
+        {
+            auto& lTransaction{sSyncTransactions.emplace_back()};
+            if (aAddr) {
+                lTransaction.push_back(*aAddr);
+            }
+            lTransaction.insert(lTransaction.end(), aData.begin(), aData.end());
+        },
+        []() noexcept {},
+        []() noexcept {}
+    };
+
+    Drivers::LS013B7DH03 lAsyncLCD{
+        [](std::span<const std::byte> aData, std::optional<std::byte> aAddr) noexcept
+        {
+            auto& lTransaction{sAsyncTransactions.emplace_back()};
+            if (aAddr) {
+                lTransaction.push_back(*aAddr);
+            }
+            lTransaction.insert(lTransaction.end(), aData.begin(), aData.end());
+        },
+        Drivers::LS013B7DH03::AsyncSPI{
+            .mBeginWr{[]() noexcept {sAsyncTransactions.emplace_back();}},
+            .mPut{
+                [](std::span<const std::byte> aData) noexcept
+                {
+                    const auto lCount{std::min(sFIFODepth - sFIFOLevel, aData.size())};
+                    sAsyncTransactions.back().insert(
+                        sAsyncTransactions.back().end(),
+                        aData.begin(),
+                        aData.begin() + lCount
+                    );
+                    sFIFOLevel += lCount;
+                    return lCount;
+                }
+            },
+            .mEndWr{
+                []() noexcept
+                {
+                    // CS is released once all has shifted out: nothing to wait for.
+                    if (sFIFOLevel != 0) {
+                        ++sEarlyEndWrCount;
+                    }
+                }
+            },
+            .mTxIntEnable{[](const bool aIsEnabled) noexcept {sIsTxIntEnabled = aIsEnabled;}},
+            .mTxEOTEnable{[](const bool aIsEnabled) noexcept {sIsTxEOTEnabled = aIsEnabled;}}
+        },
+        []() noexcept {sIsFlushDone = true;},
+        []() noexcept {},
+        []() noexcept {}
+    };
+
+    tDisplay& lSyncDisplay{lSyncLCD};
+    tDisplay& lAsyncDisplay{lAsyncLCD};
+    lSyncLCD.Init();
+    lAsyncLCD.Init();
+
+    std::printf("\n%-20s %8s %8s %8s %8s\n", "Async flush", "txns", "bytes", "ISRs", "busy");
+    static constexpr std::array sSceneNames{"menu", "menu, redrawn", "highlight moved", "full screen"};
+    for (auto lSceneIx{0}; lSceneIx < static_cast<int32_t>(sSceneNames.size()); ++lSceneIx) {
+        DrawScene(lSyncDisplay, lSceneIx);
+        lSyncDisplay.pfnFlush(lSyncDisplay.pvDisplayData);
+
+        // Keep drawing while the transfer runs: the next scene is flushed
+        // only once it completes, as the GUI does on the completion event.
+        DrawScene(lAsyncDisplay, lSceneIx);
+        sIsFlushDone = false;
+        lAsyncDisplay.pfnFlush(lAsyncDisplay.pvDisplayData);
+        auto lISRCount{0};
+        auto lBusyFlushCount{0};
+        while (sIsTxIntEnabled) {
+            lAsyncLCD.OnSPITxReady();
+            sFIFOLevel = sIsTxEOTEnabled ? 0 : std::min(sFIFOLevel, sFIFOIntLevel);
+            ++lISRCount;
+            if (lAsyncLCD.IsFlushBusy()) {
+                lAsyncDisplay.pfnFlush(lAsyncDisplay.pvDisplayData);
+                ++lBusyFlushCount;
+            }
+        }
+
+        const auto lStats{lAsyncLCD.GetFlushStats()};
+        std::printf(
+            "%-20s %8u %8u %8d %8d\n",
+            sSceneNames[lSceneIx], lStats.mTransactions, lStats.mBytes, lISRCount, lBusyFlushCount
+        );
+    }
+
+    if (sAsyncTransactions != sSyncTransactions) {
+        std::printf("Async flush transactions differ from the sync flush ones.\n");
+        return false;
+    }
+    if (sEarlyEndWrCount != 0) {
+        std::printf("Async flush: %u transactions closed before their last byte shifted out.\n", sEarlyEndWrCount);
+        return false;
+    }
+
+    return true;
+}
+
+
+static auto RunMaintenance() noexcept -> bool
+{
+    Drivers::LS013B7DH03 lLCD{
+        [](std::span<const std::byte> aData, std::optional<std::byte> aAddr) noexcept
+        {
+            auto& lTransaction{sMaintenanceTransactions.emplace_back()};
+            if (aAddr) {
+                lTransaction.push_back(*aAddr);
+            }
+            lTransaction.insert(lTransaction.end(), aData.begin(), aData.end());
+        },
+        []() noexcept {},
+        []() noexcept {}
+    };
+    tDisplay& lDisplay{lLCD};
+    lLCD.Init();
+
+    // Each step: a flush, drawn or empty, or a tick. Then the mode byte of
+    // each transaction sent, data updates being 0x80 and display mode 0x00,
+    // with 0x40 for the COM polarity.
+    struct Step
+    {
+        enum class Kind {DrawnFlush, EmptyFlush, Tick};
+        Kind mKind{};
+        std::vector<uint8_t> mModes{};
+    };
+    using Kind = Step::Kind;
+    static const std::array sSteps{
+        Step{Kind::EmptyFlush, {}},
+        Step{Kind::Tick, {}},
+        Step{Kind::Tick, {0x40}},
+        Step{Kind::DrawnFlush, {0x80}},
+        Step{Kind::Tick, {}},
+        Step{Kind::DrawnFlush, {0xc0}},
+        Step{Kind::DrawnFlush, {0xc0}},
+        Step{Kind::EmptyFlush, {}},
+        Step{Kind::Tick, {}},
+        Step{Kind::Tick, {0x00}},
+        Step{Kind::Tick, {0x40}}
+    };
+
+    static constexpr tRectangle sFrame{5, 5, 122, 122};
+    auto lColor{0U};
+    auto lStepIx{0};
+    for (const auto& lStep : sSteps) {
+        sMaintenanceTransactions.clear();
+        switch (lStep.mKind) {
+        case Kind::DrawnFlush:
+            lColor = !lColor;
+            lDisplay.pfnRectFill(lDisplay.pvDisplayData, &sFrame, lColor);
+            [[fallthrough]];
+        case Kind::EmptyFlush: lDisplay.pfnFlush(lDisplay.pvDisplayData); break;
+        case Kind::Tick: lLCD.OnMaintenanceTick(); break;
+        }
+
+        std::vector<uint8_t> lModes{};
+        for (const auto& lTransaction : sMaintenanceTransactions) {
+            lModes.push_back(std::to_integer<uint8_t>(lTransaction.front()));
+        }
+        if (lModes != lStep.mModes) {
+            std::printf("Maintenance step %d: unexpected transactions.\n", lStepIx);
+            return false;
+        }
+        ++lStepIx;
+    }
+
+    // Bus use of an idle panel, and of a panel redrawn on every tick.
+    auto lIdleBytes{0U};
+    auto lDrawnPackets{0U};
+    for (auto lTickIx{0}; lTickIx < 120; ++lTickIx) {
+        sMaintenanceTransactions.clear();
+        lLCD.OnMaintenanceTick();
+        for (const auto& lTransaction : sMaintenanceTransactions) {
+            lIdleBytes += static_cast<unsigned int>(lTransaction.size());
+        }
+    }
+    for (auto lTickIx{0}; lTickIx < 120; ++lTickIx) {
+        lColor = !lColor;
+        lDisplay.pfnRectFill(lDisplay.pvDisplayData, &sFrame, lColor);
+        lDisplay.pfnFlush(lDisplay.pvDisplayData);
+        sMaintenanceTransactions.clear();
+        lLCD.OnMaintenanceTick();
+        lDrawnPackets += static_cast<unsigned int>(sMaintenanceTransactions.size());
+    }
+
+    std::printf("\n%-20s %8s %8s\n", "Maintenance", "ticks", "bytes");
+    std::printf("%-20s %8d %8u\n", "idle", 120, lIdleBytes);
+    std::printf("%-20s %8d %8u\n", "drawn every tick", 120, lDrawnPackets * 2);
+
+    return true;
+}
+
+
+static void DrawScene(tDisplay& aDisplay, const int32_t aSceneIx) noexcept
+{
+    static constexpr tRectangle sFrame{5, 5, 122, 122};
+    static constexpr tRectangle sInner{6, 6, 121, 121};
+    static constexpr tRectangle sFullScreen{0, 0, 127, 127};
+    const tRectangle lHighlight{
+        10, static_cast<int16_t>(20 + 12 * (aSceneIx / 2)),
+        117, static_cast<int16_t>(30 + 12 * (aSceneIx / 2))
+    };
+
+    if (aSceneIx == 3) {
+        aDisplay.pfnRectFill(aDisplay.pvDisplayData, &sFullScreen, 1);
+        return;
+    }
+
+    aDisplay.pfnRectFill(aDisplay.pvDisplayData, &sFrame, 1);
+    aDisplay.pfnRectFill(aDisplay.pvDisplayData, &sInner, 0);
+    aDisplay.pfnRectFill(aDisplay.pvDisplayData, &lHighlight, 1);
+}
+
+// *****************************************************************************
+//                                END OF FILE
+// *****************************************************************************
@@ -0,0 +1,366 @@
+// *****************************************************************************
+//
+// Project: PFPP.
+//
+// Module: SPI benchmark.
+//
+// *****************************************************************************
+
+//! \file
+//! \brief Host benchmark of the SPIMasterDev transfers, on a model of the SSI.
+//! RdData(), WrData() and the interrupt driven write are checked to send and
+//! receive every byte in order, and to release CS only once the last byte is out.
+//! RdData() must not overrun the RX FIFO, writes must leave it empty.
+//! Their bus use and driverlib calls are compared to a byte at a time transfer,
+//! as PushPullByte() does.
+//! The SSI register images of SPISlaveCfg::ToSSIRegs() are checked against the
+//! ones SSIConfigSetExpClk() writes, for the bit rates used and any bit rate
+//! reachable from the SSI clock. Switching slaves must not cost driverlib calls.
+//! \ingroup app
+
+// *****************************************************************************
+//
+//        Copyright (c) 2023, Martin Garon, All rights reserved.
+//
+// This source code is licensed under the GPL-3.0-style license found in the
+// LICENSE file in the root directory of this source tree.
+//
+// *****************************************************************************
+
+// *****************************************************************************
+//                              INCLUDE FILES
+// *****************************************************************************
+
+// This application.
+#include "SSIModel.h"
+
+// Firmware Libraries.
+#include "corelink/inc/SPIMasterDev.h"
+
+// Fake TI Library.
+#include <inc/hw_ssi.h>
+#include <inc/hw_types.h>
+#include <driverlib/ssi.h>
+
+// Standard Libraries.
+#include <array>
+#include <cstdio>
+#include <optional>
+#include <vector>
+
+// *****************************************************************************
+//                      DEFINED CONSTANTS AND MACROS
+// *****************************************************************************
+
+// *****************************************************************************
+//                         TYPEDEFS AND STRUCTURES
+// *****************************************************************************
+
+// *****************************************************************************
+//                            FUNCTION PROTOTYPES
+// *****************************************************************************
+
+[[nodiscard]] static auto CheckTransfers(unsigned int aBitRate) noexcept -> bool;
+[[nodiscard]] static auto CheckSSIRegs() noexcept -> bool;
+[[nodiscard]] static auto CheckSlaveSwitch() noexcept -> bool;
+[[nodiscard]] static auto GetDriverlibSSIRegs(const CoreLink::SPISlaveCfg& aSPICfg) noexcept -> CoreLink::SSIRegs;
+[[nodiscard]] static auto ToBytes(const std::vector<uint8_t>& aValues) noexcept -> std::vector<std::byte>;
+static void ByteAtATimeWrData(
+    const CoreLink::SPISlaveCfg& aSPICfg,
+    std::span<const std::byte> aData,
+    std::optional<std::byte> aAddr
+) noexcept;
+
+// *****************************************************************************
+//                             GLOBAL VARIABLES
+// *****************************************************************************
+
+// As the standalone board: SSI2 at 50 MHz.
+static constexpr uint32_t sClkRate{50000000UL};
+static constexpr CoreLink::SPIMasterDev sSPIMasterDev{SSIModel::sBaseAddr, sClkRate};
+
+// The board slaves, computed at compile time. LCD at 1 MHz, RTC at 4 MHz: /2 /25 and /2 /6.
+static_assert(
+    sSPIMasterDev.MakeCfg({.mBitRate{1000000U}}).mSSIRegs == CoreLink::SSIRegs{.mCR0{0x1807}, .mCPSR{2}}
+);
+static_assert(
+    sSPIMasterDev.MakeCfg({.mBitRate{4000000U}}).mSSIRegs == CoreLink::SSIRegs{.mCR0{0x0507}, .mCPSR{2}}
+);
+
+// Another SSI, to run SSIConfigSetExpClk() without touching the one modelled.
+static constexpr uint32_t sCheckBaseAddr{0x40008000UL};
+
+// Up to the SSI master limit, half the SSI clock.
+static constexpr std::array sBitRates{1000000U, 4000000U, 12500000U, 25000000U};
+
+// A slave replying with its own count of bytes received.
+static uint8_t sSlaveCount{0};
+
+// *****************************************************************************
+//                            EXPORTED FUNCTIONS
+// *****************************************************************************
+
+int main()
+{
+    auto lIsValid{true};
+    for (const auto lBitRate : sBitRates) {
+        lIsValid &= CheckTransfers(lBitRate);
+    }
+    std::printf("Transfers %s.\n", lIsValid ? "valid" : "INVALID");
+    lIsValid &= CheckSSIRegs();
+    lIsValid &= CheckSlaveSwitch();
+
+    // The LCD writes: a run of 128 lines of 18 bytes, after the mode byte.
+    // The pipelined read sends as many bytes, as WrData() did before being write only.
+    std::vector<std::byte> lData(128 * 18 + 1, std::byte{0x5a});
+    std::printf("\n2305 B        %-20s %-20s %-20s\n", "byte at a time", "pipelined read", "write only");
+    std::printf("%-13s", "");
+    for (auto lColIx{0}; lColIx < 3; ++lColIx) {
+        std::printf(" %-20s", "% bus   calls/byte");
+    }
+    std::printf("\n");
+    for (const auto lBitRate : sBitRates) {
+        const CoreLink::SPISlaveCfg lSPICfg{.mBitRate{lBitRate}, .mCSn{{0, 1}}};
+        const auto lPrintCost{
+            [](const auto aTransfer) noexcept
+            {
+                SSIModel::Reset({});
+                aTransfer();
+                const auto lStats{SSIModel::GetStats()};
+                std::printf(
+                    " %5.1f   %10.2f   ",
+                    100.0 * static_cast<double>(lStats.mShiftCycles) / static_cast<double>(lStats.mCSCycles),
+                    static_cast<double>(lStats.mCalls) / static_cast<double>(lStats.mBytes)
+                );
+            }
+        };
+
+        std::printf("%8.1f MHz ", lBitRate / 1e6);
+        lPrintCost([&]() noexcept {ByteAtATimeWrData(lSPICfg, lData, std::byte{0x80});});
+        lPrintCost([&]() noexcept {sSPIMasterDev.RdData(lSPICfg, std::span{lData}.subspan(1), std::byte{0x80});});
+        lPrintCost([&]() noexcept {sSPIMasterDev.WrData(lSPICfg, lData, std::byte{0x80});});
+        std::printf("\n");
+    }
+
+    return lIsValid ? 0 : 1;
+}
+
+// *****************************************************************************
+//                              LOCAL FUNCTIONS
+// *****************************************************************************
+
+static auto CheckTransfers(const unsigned int aBitRate) noexcept -> bool
+{
+    const CoreLink::SPISlaveCfg lSPICfg{.mBitRate{aBitRate}, .mCSn{{0, 1}}};
+    static constexpr std::array sSizes{0U, 1U, 7U, 8U, 9U, 17U, 300U};
+    for (const auto lSize : sSizes) {
+        for (const auto lAddr : {std::optional<std::byte>{}, std::optional{std::byte{0xa5}}}) {
+            std::vector<uint8_t> lValues(lSize);
+            for (std::size_t lIx{0}; lIx < lSize; ++lIx) {
+                lValues[lIx] = static_cast<uint8_t>(lIx * 7 + 3);
+            }
+            auto lExpected{lValues};
+            if (lAddr) {
+                lExpected.insert(lExpected.begin(), std::to_integer<uint8_t>(*lAddr));
+            }
+
+            // Written bytes go out in order. The RX FIFO is left empty.
+            const auto lIsWrValid{
+                [&]() noexcept
+                {
+                    const auto lStats{SSIModel::GetStats()};
+                    return (SSIModel::GetTransactions() == std::vector<std::vector<uint8_t>>{lExpected})
+                        && (lStats.mRxCount == 0) && !lStats.mIsOverrunFlagged && (lStats.mEarlyCSReleases == 0);
+                }
+            };
+            SSIModel::Reset({});
+            sSPIMasterDev.WrData(lSPICfg, ToBytes(lValues), lAddr);
+            if (!lIsWrValid()) {
+                std::printf("WrData of %u bytes at %u Hz failed.\n", lSize, aBitRate);
+                return false;
+            }
+
+            // Same for the interrupt driven write, put in FIFO sized chunks.
+            SSIModel::Reset({});
+            const auto lTxData{ToBytes(lExpected)};
+            std::span<const std::byte> lTxLeft{lTxData};
+            sSPIMasterDev.BeginWr(lSPICfg);
+            while (!lTxLeft.empty()) {
+                lTxLeft = lTxLeft.subspan(sSPIMasterDev.PutData(lTxLeft));
+            }
+            sSPIMasterDev.EndWr(lSPICfg);
+            if (!lIsWrValid()) {
+                std::printf("PutData of %u bytes at %u Hz failed.\n", lSize, aBitRate);
+                return false;
+            }
+
+            // Read bytes are the replies following the address, in order.
+            sSlaveCount = 0;
+            SSIModel::Reset([](uint8_t) noexcept {return sSlaveCount++;});
+            std::vector<std::byte> lRxData(lSize);
+            sSPIMasterDev.RdData(lSPICfg, lRxData, lAddr);
+            const auto lStats{SSIModel::GetStats()};
+            std::vector<uint8_t> lReplies(lSize);
+            for (std::size_t lIx{0}; lIx < lSize; ++lIx) {
+                lReplies[lIx] = static_cast<uint8_t>(lIx + (lAddr ? 1 : 0));
+            }
+            auto lSent{std::vector<uint8_t>(lSize, 0)};
+            if (lAddr) {
+                lSent.insert(lSent.begin(), std::to_integer<uint8_t>(*lAddr));
+            }
+            if ((ToBytes(lReplies) != lRxData) || (SSIModel::GetTransactions() != std::vector<std::vector<uint8_t>>{lSent})
+                || (lStats.mOverruns != 0) || (lStats.mRxCount != 0) || (lStats.mEarlyCSReleases != 0)) {
+                std::printf("RdData of %u bytes at %u Hz failed.\n", lSize, aBitRate);
+                return false;
+            }
+        }
+    }
+
+    return true;
+}
+
+
+static auto CheckSSIRegs() noexcept -> bool
+{
+    using tProtocol = CoreLink::SPISlaveCfg::tProtocol;
+    static constexpr std::array sProtocols{
+        tProtocol::MOTO_0, tProtocol::MOTO_1, tProtocol::MOTO_2, tProtocol::MOTO_3, tProtocol::TI, tProtocol::NMW
+    };
+    static constexpr std::array sDataWidths{4U, 8U, 16U};
+
+    // SSIConfigSetExpClk() takes a divider of at least 2, and gets a prescaler
+    // above 254 from 254 * 257: not valid in ToSSIRegs().
+    static constexpr uint32_t sMaxDivider{254 * 257 - 1};
+    unsigned int lCheckCount{0};
+    unsigned int lMismatchCount{0};
+    const auto lCheck{
+        [&](const CoreLink::SPISlaveCfg& aSPICfg) noexcept
+        {
+            ++lCheckCount;
+            const auto lSSIRegs{sSPIMasterDev.MakeCfg(aSPICfg).mSSIRegs};
+            const auto lDivider{(aSPICfg.mBitRate != 0) ? (sClkRate / aSPICfg.mBitRate) : 0};
+            if ((lDivider < 2) || (lDivider > sMaxDivider)) {
+                if (lSSIRegs.IsValid()) {
+                    ++lMismatchCount;
+                    std::printf("  %u b/s: valid, out of reach\n", aSPICfg.mBitRate);
+                }
+                return;
+            }
+
+            const auto lDriverlibSSIRegs{GetDriverlibSSIRegs(aSPICfg)};
+            if (lSSIRegs != lDriverlibSSIRegs) {
+                ++lMismatchCount;
+                std::printf(
+                    "  %u b/s: CR0 0x%04x CPSR %u, driverlib CR0 0x%04x CPSR %u\n",
+                    aSPICfg.mBitRate,
+                    static_cast<unsigned int>(lSSIRegs.mCR0),
+                    static_cast<unsigned int>(lSSIRegs.mCPSR),
+                    static_cast<unsigned int>(lDriverlibSSIRegs.mCR0),
+                    static_cast<unsigned int>(lDriverlibSSIRegs.mCPSR)
+                );
+            }
+        }
+    };
+
+    // The bit rates used, in every frame format.
+    for (const auto lBitRate : sBitRates) {
+        for (const auto lProtocol : sProtocols) {
+            for (const auto lDataWidth : sDataWidths) {
+                lCheck({.mProtocol{lProtocol}, .mBitRate{lBitRate}, .mDataWidth{lDataWidth}});
+            }
+        }
+    }
+
+    // Every divider, the bit rates just above rounded down to it, and both ends out of reach.
+    for (uint32_t lDivider{1}; lDivider <= (sMaxDivider + 2); ++lDivider) {
+        lCheck({.mBitRate{sClkRate / lDivider}});
+        lCheck({.mBitRate{(sClkRate / lDivider) + 1}});
+    }
+    lCheck({.mBitRate{0}});
+
+    std::printf("SSI registers: %u configs, %u mismatches with driverlib.\n", lCheckCount, lMismatchCount);
+    return lMismatchCount == 0;
+}
+
+
+static auto CheckSlaveSwitch() noexcept -> bool
+{
+    // As the LCD and RTC, precomputed: alternating costs no more calls than staying on one.
+    static constexpr auto sLCDSPICfg{sSPIMasterDev.MakeCfg({.mBitRate{1000000U}, .mCSn{{0, 1}}})};
+    static constexpr auto sRTCSPICfg{sSPIMasterDev.MakeCfg({.mBitRate{4000000U}, .mCSn{{0, 2}}})};
+    static constexpr std::array sData{std::byte{0x5a}};
+    const auto lGetCalls{
+        [](const CoreLink::SPISlaveCfg& aSPICfg, const CoreLink::SPISlaveCfg& aNextSPICfg) noexcept
+        {
+            sSPIMasterDev.WrData(aSPICfg, sData);
+            SSIModel::Reset({});
+            sSPIMasterDev.WrData(aNextSPICfg, sData);
+            return SSIModel::GetStats().mCalls;
+        }
+    };
+
+    const auto lSameCalls{lGetCalls(sRTCSPICfg, sRTCSPICfg)};
+    const auto lSwitchCalls{lGetCalls(sLCDSPICfg, sRTCSPICfg)};
+    std::printf(
+        "Slave switch: %llu calls for an RTC write after the LCD, %llu after the RTC.\n",
+        static_cast<unsigned long long>(lSwitchCalls),
+        static_cast<unsigned long long>(lSameCalls)
+    );
+    return lSwitchCalls == lSameCalls;
+}
+
+
+static auto GetDriverlibSSIRegs(const CoreLink::SPISlaveCfg& aSPICfg) noexcept -> CoreLink::SSIRegs
+{
+    using tProtocol = CoreLink::SPISlaveCfg::tProtocol;
+    uint32_t lProtocol{SSI_FRF_MOTO_MODE_0};
+    switch (aSPICfg.mProtocol) {
+    case tProtocol::MOTO_0: lProtocol = SSI_FRF_MOTO_MODE_0; break;
+    case tProtocol::MOTO_1: lProtocol = SSI_FRF_MOTO_MODE_1; break;
+    case tProtocol::MOTO_2: lProtocol = SSI_FRF_MOTO_MODE_2; break;
+    case tProtocol::MOTO_3: lProtocol = SSI_FRF_MOTO_MODE_3; break;
+    case tProtocol::TI:     lProtocol = SSI_FRF_TI; break;
+    case tProtocol::NMW:    lProtocol = SSI_FRF_NMW; break;
+    }
+
+    SSIConfigSetExpClk(sCheckBaseAddr, sClkRate, lProtocol, SSI_MODE_MASTER, aSPICfg.mBitRate, aSPICfg.mDataWidth);
+    return CoreLink::SSIRegs{
+        .mCR0{SSIRegister(sCheckBaseAddr + SSI_O_CR0)},
+        .mCPSR{SSIRegister(sCheckBaseAddr + SSI_O_CPSR)}
+    };
+}
+
+
+static auto ToBytes(const std::vector<uint8_t>& aValues) noexcept -> std::vector<std::byte>
+{
+    std::vector<std::byte> lBytes{};
+    for (const auto lValue : aValues) {
+        lBytes.push_back(std::byte{lValue});
+    }
+
+    return lBytes;
+}
+
+
+static void ByteAtATimeWrData(
+    const CoreLink::SPISlaveCfg& aSPICfg,
+    const std::span<const std::byte> aData,
+    const std::optional<std::byte> aAddr
+) noexcept
+{
+    // Each byte waits for the previous one to come back in.
+    [[maybe_unused]] auto lByte{sSPIMasterDev.PushPullByte(aSPICfg, std::byte{0})};
+    SSIModel::Reset({});
+    aSPICfg.mCSn.AssertCSn();
+    if (aAddr) {
+        lByte = sSPIMasterDev.PushPullByte(*aAddr);
+    }
+    for (const auto lData : aData) {
+        lByte = sSPIMasterDev.PushPullByte(lData);
+    }
+    aSPICfg.mCSn.DeassertCSn();
+}
+
+// *****************************************************************************
+//                                END OF FILE
+// *****************************************************************************
@@ -0,0 +1,364 @@
+// *****************************************************************************
+//
+// Project: PFPP.
+//
+// Module: SPI benchmark.
+//
+// *****************************************************************************
+
+//! \file
+//! \brief Host model of a TM4C SSI master, behind the driverlib calls.
+//! \ingroup app
+
+// *****************************************************************************
+//
+//        Copyright (c) 2023, Martin Garon, All rights reserved.
+//
+// This source code is licensed under the GPL-3.0-style license found in the
+// LICENSE file in the root directory of this source tree.
+//
+// *****************************************************************************
+
+// *****************************************************************************
+//                              INCLUDE FILES
+// *****************************************************************************
+
+// This module.
+#include "SSIModel.h"
+
+// Fake TI Library.
+#include <inc/hw_ssi.h>
+#include <inc/hw_types.h>
+#include <driverlib/gpio.h>
+#include <driverlib/ssi.h>
+
+// Standard Libraries.
+#include <algorithm>
+#include <deque>
+#include <map>
+
+// *****************************************************************************
+//                      DEFINED CONSTANTS AND MACROS
+// *****************************************************************************
+
+// *****************************************************************************
+//                         TYPEDEFS AND STRUCTURES
+// *****************************************************************************
+
+// A byte in the TX FIFO, and when it got there.
+struct TxEntry
+{
+    uint8_t mByte{};
+    uint64_t mCycle{};
+};
+
+// *****************************************************************************
+//                            FUNCTION PROTOTYPES
+// *****************************************************************************
+
+static void Call() noexcept;
+static void Advance() noexcept;
+[[nodiscard]] static auto GetByteCycles() noexcept -> uint64_t;
+
+// *****************************************************************************
+//                             GLOBAL VARIABLES
+// *****************************************************************************
+
+static SSIModel::Slave sSlave{};
+static SSIModel::Stats sStats{};
+static std::vector<std::vector<uint8_t>> sTransactions{};
+
+static uint64_t sCycle{0};
+static std::deque<TxEntry> sTxFIFO{};
+static std::deque<uint8_t> sRxFIFO{};
+static bool sIsOverrunFlagged{false};
+
+// The byte in the shift register, if any, and when it is out.
+static bool sIsShifting{false};
+static uint8_t sShiftByte{};
+static uint64_t sShiftEndCycle{0};
+
+static bool sIsCSAsserted{false};
+static uint64_t sCSAssertCycle{0};
+
+// The SSI registers by address, kept through Reset() as the hardware would.
+static std::map<uint32_t, uint32_t> sRegisters{};
+
+// *****************************************************************************
+//                            EXPORTED FUNCTIONS
+// *****************************************************************************
+
+namespace SSIModel
+{
+
+
+void Reset(Slave aSlave) noexcept
+{
+    sSlave = std::move(aSlave);
+    sStats = {};
+    sTransactions.clear();
+    sTxFIFO.clear();
+    sRxFIFO.clear();
+    sIsOverrunFlagged = false;
+    sIsShifting = false;
+    sIsCSAsserted = false;
+}
+
+
+auto GetTransactions() noexcept -> const std::vector<std::vector<uint8_t>>&
+{
+    return sTransactions;
+}
+
+
+auto GetStats() noexcept -> Stats
+{
+    auto lStats{sStats};
+    lStats.mRxCount = sRxFIFO.size();
+    lStats.mIsOverrunFlagged = sIsOverrunFlagged;
+    return lStats;
+}
+
+
+} // namespace SSIModel
+
+
+void SSIConfigSetExpClk(
+    const uint32_t ui32Base,
+    const uint32_t ui32SSIClk,
+    uint32_t ui32Protocol,
+    const uint32_t /*ui32Mode*/,
+    const uint32_t ui32BitRate,
+    const uint32_t ui32DataWidth
+)
+{
+    // The driverlib algorithm, for a master.
+    Call();
+    HWREG(ui32Base + SSI_O_CR1) = 0;
+
+    const uint32_t ui32MaxBitRate{ui32SSIClk / ui32BitRate};
+    uint32_t ui32PreDiv{0};
+    uint32_t ui32SCR{0};
+    do {
+        ui32PreDiv += 2;
+        ui32SCR = (ui32MaxBitRate / ui32PreDiv) - 1;
+    } while (ui32SCR > 255);
+    HWREG(ui32Base + SSI_O_CPSR) = ui32PreDiv;
+
+    const uint32_t ui32SPH_SPO{(ui32Protocol & 3) << 6};
+    ui32Protocol &= SSI_CR0_FRF_M;
+    HWREG(ui32Base + SSI_O_CR0) = (ui32SCR << 8) | ui32SPH_SPO | ui32Protocol | (ui32DataWidth - 1);
+}
+
+
+void SSIEnable(const uint32_t ui32Base)
+{
+    Call();
+    HWREG(ui32Base + SSI_O_CR1) |= SSI_CR1_SSE;
+}
+
+
+void SSIDisable(const uint32_t ui32Base)
+{
+    Call();
+    HWREG(ui32Base + SSI_O_CR1) &= ~SSI_CR1_SSE;
+}
+
+
+void SSIDataPut(const uint32_t ui32Base, const uint32_t ui32Data)
+{
+    while (!SSIDataPutNonBlocking(ui32Base, ui32Data)) {
+        // Spin.
+    }
+}
+
+
+auto SSIDataPutNonBlocking(const uint32_t /*ui32Base*/, const uint32_t ui32Data) -> int32_t
+{
+    Call();
+    if (sTxFIFO.size() >= SSIModel::sFIFODepth) {
+        return 0;
+    }
+
+    sTxFIFO.push_back(TxEntry{static_cast<uint8_t>(ui32Data), sCycle});
+    Advance();
+    return 1;
+}
+
+
+void SSIDataGet(const uint32_t ui32Base, uint32_t* const pui32Data)
+{
+    while (!SSIDataGetNonBlocking(ui32Base, pui32Data)) {
+        // Spin: a byte comes in only if one is going out.
+        if (!sIsShifting && sTxFIFO.empty()) {
+            *pui32Data = 0;
+            return;
+        }
+    }
+}
+
+
+auto SSIDataGetNonBlocking(const uint32_t /*ui32Base*/, uint32_t* const pui32Data) -> int32_t
+{
+    Call();
+    if (sRxFIFO.empty()) {
+        return 0;
+    }
+
+    *pui32Data = sRxFIFO.front();
+    sRxFIFO.pop_front();
+    return 1;
+}
+
+
+auto SSIBusy(const uint32_t /*ui32Base*/) -> bool
+{
+    Call();
+    return sIsShifting || !sTxFIFO.empty();
+}
+
+
+void SSIIntEnable(const uint32_t /*ui32Base*/, const uint32_t /*ui32IntFlags*/)
+{
+    Call();
+}
+
+
+void SSIIntDisable(const uint32_t /*ui32Base*/, const uint32_t /*ui32IntFlags*/)
+{
+    Call();
+}
+
+
+void SSIIntClear(const uint32_t /*ui32Base*/, const uint32_t ui32IntFlags)
+{
+    Call();
+    if ((ui32IntFlags & SSI_RXOR) != 0) {
+        sIsOverrunFlagged = false;
+    }
+}
+
+
+void SSIDMAEnable(const uint32_t /*ui32Base*/, const uint32_t /*ui32DMAFlags*/)
+{
+    Call();
+}
+
+
+void SSIDMADisable(const uint32_t /*ui32Base*/, const uint32_t /*ui32DMAFlags*/)
+{
+    Call();
+}
+
+
+auto SSIRegister(const uint32_t aAddr) -> uint32_t&
+{
+    // A register access costs next to nothing against a driverlib call.
+    return sRegisters[aAddr];
+}
+
+
+void GPIOPinWrite(const uint32_t /*ui32Port*/, const uint8_t /*ui8Pins*/, const uint8_t ui8Val)
+{
+    Call();
+    if (ui8Val == 0) {
+        sIsCSAsserted = true;
+        sCSAssertCycle = sCycle;
+        sTransactions.emplace_back();
+        return;
+    }
+
+    if (sIsCSAsserted) {
+        sIsCSAsserted = false;
+        sStats.mCSCycles += sCycle - sCSAssertCycle;
+        sStats.mEarlyCSReleases += (sIsShifting || !sTxFIFO.empty());
+    }
+}
+
+
+void GPIOPinTypeGPIOOutput(const uint32_t /*ui32Port*/, const uint8_t /*ui8Pins*/)
+{
+    Call();
+}
+
+
+void GPIOPadConfigSet(
+    const uint32_t /*ui32Port*/,
+    const uint8_t /*ui8Pins*/,
+    const uint32_t /*ui32Strength*/,
+    const uint32_t /*ui32PadType*/
+)
+{
+    Call();
+}
+
+// *****************************************************************************
+//                              LOCAL FUNCTIONS
+// *****************************************************************************
+
+static void Call() noexcept
+{
+    ++sStats.mCalls;
+    sCycle += SSIModel::sCallCycles;
+    Advance();
+}
+
+
+static void Advance() noexcept
+{
+    // Shift out every byte due by now, each one clocking in the slave reply.
+    for (;;) {
+        if (sIsShifting) {
+            if (sShiftEndCycle > sCycle) {
+                return;
+            }
+
+            sIsShifting = false;
+            ++sStats.mBytes;
+            sStats.mShiftCycles += GetByteCycles();
+            if (!sTransactions.empty()) {
+                sTransactions.back().push_back(sShiftByte);
+            }
+            const auto lReply{sSlave ? sSlave(sShiftByte) : uint8_t{0}};
+            if (sRxFIFO.size() < SSIModel::sFIFODepth) {
+                sRxFIFO.push_back(lReply);
+            }
+            else {
+                ++sStats.mOverruns;
+                sIsOverrunFlagged = true;
+            }
+        }
+
+        if (sTxFIFO.empty()) {
+            return;
+        }
+
+        // Back to back with the previous byte, if queued by the time it was out.
+        const auto lStartCycle{std::max(sShiftEndCycle, sTxFIFO.front().mCycle)};
+        if (lStartCycle > sCycle) {
+            return;
+        }
+        sShiftByte = sTxFIFO.front().mByte;
+        sTxFIFO.pop_front();
+        sShiftEndCycle = lStartCycle + GetByteCycles();
+        sIsShifting = true;
+    }
+}
+
+
+static auto GetByteCycles() noexcept -> uint64_t
+{
+    // From the registers: data width * prescaler * serial clock rate, in SSI clocks.
+    const auto lCR0{sRegisters[SSIModel::sBaseAddr + SSI_O_CR0]};
+    const auto lCPSR{sRegisters[SSIModel::sBaseAddr + SSI_O_CPSR]};
+    if (lCPSR == 0) {
+        return 8;
+    }
+
+    const auto lSCR{(lCR0 & SSI_CR0_SCR_M) >> SSI_CR0_SCR_S};
+    return uint64_t{(lCR0 & SSI_CR0_DSS_M) + 1} * lCPSR * (lSCR + 1);
+}
+
+// *****************************************************************************
+//                                END OF FILE
+// *****************************************************************************
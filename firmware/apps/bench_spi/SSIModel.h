@@ -0,0 +1,100 @@
+#ifndef APPS__SSIMODEL_H_
+#define APPS__SSIMODEL_H_
+// *****************************************************************************
+//
+// Project: PFPP.
+//
+// Module: SPI benchmark.
+//
+// *****************************************************************************
+
+//! \file
+//! \brief Host model of a TM4C SSI master, behind the driverlib calls.
+//! \ingroup app
+
+// *****************************************************************************
+//
+//        Copyright (c) 2023, Martin Garon, All rights reserved.
+//
+// This source code is licensed under the GPL-3.0-style license found in the
+// LICENSE file in the root directory of this source tree.
+//
+// *****************************************************************************
+
+// *****************************************************************************
+//                              INCLUDE FILES
+// *****************************************************************************
+
+// Standard Libraries.
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+// *****************************************************************************
+//                       DEFINED CONSTANTS AND MACROS
+// *****************************************************************************
+
+// *****************************************************************************
+//                         TYPEDEFS AND STRUCTURES
+// *****************************************************************************
+
+//! \brief 8-entry TX and RX FIFOs around a shift register, on a CPU cycle clock.
+//! Each driverlib call costs the CPU sCallCycles, and the clock only moves
+//! with the calls: the shift register gets ahead of the CPU between them.
+//! A byte shifts out in 8 bit times, set by the CR0 and CPSR registers as
+//! written by SSIConfigSetExpClk() or HWREG(), back to back with the next one
+//! if it is in the TX FIFO by then. Each byte out clocks in the slave reply, lost when
+//! the RX FIFO is full, flagging an overrun until cleared. CS is asserted
+//! by a GPIO write of 0.
+namespace SSIModel
+{
+
+
+//! \brief The SSI modelled: SSI2, as on the standalone board.
+static constexpr uint32_t sBaseAddr{0x4000A000UL};
+static constexpr std::size_t sFIFODepth{8};
+static constexpr uint64_t sCallCycles{20};
+
+//! \brief Bus activity since the last Reset().
+struct Stats
+{
+    uint64_t mBytes{};
+    uint64_t mShiftCycles{};
+    uint64_t mCSCycles{};
+    uint64_t mCalls{};
+    unsigned int mOverruns{};
+    unsigned int mEarlyCSReleases{};
+
+    // State at the time of GetStats().
+    std::size_t mRxCount{};
+    bool mIsOverrunFlagged{};
+};
+
+//! \brief The slave: its reply to each byte received, in a CS window.
+using Slave = std::function<uint8_t(uint8_t aByte)>;
+
+void Reset(Slave aSlave) noexcept;
+
+//! \brief The bytes clocked out, one vector per CS window.
+[[nodiscard]] auto GetTransactions() noexcept -> const std::vector<std::vector<uint8_t>>&;
+[[nodiscard]] auto GetStats() noexcept -> Stats;
+
+
+} // namespace SSIModel
+
+// *****************************************************************************
+//                            EXPORTED VARIABLES
+// *****************************************************************************
+
+// *****************************************************************************
+//                                 EXTERNS
+// *****************************************************************************
+
+// *****************************************************************************
+//                            EXPORTED FUNCTIONS
+// *****************************************************************************
+
+// *****************************************************************************
+//                                END OF FILE
+// *****************************************************************************
+#endif // APPS__SSIMODEL_H_
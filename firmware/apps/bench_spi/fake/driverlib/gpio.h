@@ -0,0 +1,14 @@
+// Host stand-in for the TivaWare GPIO API: pin writes drive the SSI model CS.
+#ifndef FAKE__DRIVERLIB_GPIO_H_
+#define FAKE__DRIVERLIB_GPIO_H_
+
+#include <cstdint>
+
+#define GPIO_STRENGTH_2MA 0x00000001
+#define GPIO_PIN_TYPE_STD 0x00000008
+
+void GPIOPinWrite(uint32_t ui32Port, uint8_t ui8Pins, uint8_t ui8Val);
+void GPIOPinTypeGPIOOutput(uint32_t ui32Port, uint8_t ui8Pins);
+void GPIOPadConfigSet(uint32_t ui32Port, uint8_t ui8Pins, uint32_t ui32Strength, uint32_t ui32PadType);
+
+#endif // FAKE__DRIVERLIB_GPIO_H_
@@ -0,0 +1,4 @@
+// Host stand-in for the TivaWare ROM API: driverlib calls go to the SSI model.
+#ifndef FAKE__DRIVERLIB_ROM_H_
+#define FAKE__DRIVERLIB_ROM_H_
+#endif // FAKE__DRIVERLIB_ROM_H_
@@ -0,0 +1,22 @@
+// Host stand-in for the TivaWare ROM mapping: MAP_ calls go to the SSI model.
+#ifndef FAKE__DRIVERLIB_ROM_MAP_H_
+#define FAKE__DRIVERLIB_ROM_MAP_H_
+
+#define MAP_SSIConfigSetExpClk SSIConfigSetExpClk
+#define MAP_SSIEnable SSIEnable
+#define MAP_SSIDisable SSIDisable
+#define MAP_SSIDataPut SSIDataPut
+#define MAP_SSIDataPutNonBlocking SSIDataPutNonBlocking
+#define MAP_SSIDataGet SSIDataGet
+#define MAP_SSIDataGetNonBlocking SSIDataGetNonBlocking
+#define MAP_SSIBusy SSIBusy
+#define MAP_SSIIntEnable SSIIntEnable
+#define MAP_SSIIntDisable SSIIntDisable
+#define MAP_SSIIntClear SSIIntClear
+#define MAP_SSIDMAEnable SSIDMAEnable
+#define MAP_SSIDMADisable SSIDMADisable
+#define MAP_GPIOPinWrite GPIOPinWrite
+#define MAP_GPIOPinTypeGPIOOutput GPIOPinTypeGPIOOutput
+#define MAP_GPIOPadConfigSet GPIOPadConfigSet
+
+#endif // FAKE__DRIVERLIB_ROM_MAP_H_
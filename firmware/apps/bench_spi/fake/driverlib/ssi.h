@@ -0,0 +1,42 @@
+// Host stand-in for the TivaWare SSI API, served by the SSI model.
+#ifndef FAKE__DRIVERLIB_SSI_H_
+#define FAKE__DRIVERLIB_SSI_H_
+
+#include <cstdint>
+
+#define SSI_FRF_MOTO_MODE_0 0x00000000
+#define SSI_FRF_MOTO_MODE_1 0x00000002
+#define SSI_FRF_MOTO_MODE_2 0x00000001
+#define SSI_FRF_MOTO_MODE_3 0x00000003
+#define SSI_FRF_TI 0x00000010
+#define SSI_FRF_NMW 0x00000020
+
+#define SSI_MODE_MASTER 0x00000000
+#define SSI_TXFF 0x00000008
+#define SSI_RXOR 0x00000001
+#define SSI_DMARX 0x00000010
+#define SSI_DMA_TX 0x00000002
+#define SSI_DMA_RX 0x00000001
+
+void SSIConfigSetExpClk(
+    uint32_t ui32Base,
+    uint32_t ui32SSIClk,
+    uint32_t ui32Protocol,
+    uint32_t ui32Mode,
+    uint32_t ui32BitRate,
+    uint32_t ui32DataWidth
+);
+void SSIEnable(uint32_t ui32Base);
+void SSIDisable(uint32_t ui32Base);
+void SSIDataPut(uint32_t ui32Base, uint32_t ui32Data);
+int32_t SSIDataPutNonBlocking(uint32_t ui32Base, uint32_t ui32Data);
+void SSIDataGet(uint32_t ui32Base, uint32_t* pui32Data);
+int32_t SSIDataGetNonBlocking(uint32_t ui32Base, uint32_t* pui32Data);
+bool SSIBusy(uint32_t ui32Base);
+void SSIIntEnable(uint32_t ui32Base, uint32_t ui32IntFlags);
+void SSIIntDisable(uint32_t ui32Base, uint32_t ui32IntFlags);
+void SSIIntClear(uint32_t ui32Base, uint32_t ui32IntFlags);
+void SSIDMAEnable(uint32_t ui32Base, uint32_t ui32DMAFlags);
+void SSIDMADisable(uint32_t ui32Base, uint32_t ui32DMAFlags);
+
+#endif // FAKE__DRIVERLIB_SSI_H_
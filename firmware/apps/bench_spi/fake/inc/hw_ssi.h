@@ -0,0 +1,24 @@
+// Host stand-in for the TivaWare SSI register definitions.
+#ifndef FAKE__INC_HW_SSI_H_
+#define FAKE__INC_HW_SSI_H_
+
+#define SSI_O_CR0 0x00000000
+#define SSI_O_CR1 0x00000004
+#define SSI_O_DR 0x00000008
+#define SSI_O_SR 0x0000000C
+#define SSI_O_CPSR 0x00000010
+
+#define SSI_CR0_SCR_M 0x0000FF00
+#define SSI_CR0_SPH 0x00000080
+#define SSI_CR0_SPO 0x00000040
+#define SSI_CR0_FRF_M 0x00000030
+#define SSI_CR0_FRF_MOTO 0x00000000
+#define SSI_CR0_FRF_TI 0x00000010
+#define SSI_CR0_FRF_NMW 0x00000020
+#define SSI_CR0_DSS_M 0x0000000F
+#define SSI_CR0_SCR_S 8
+
+#define SSI_CR1_SSE 0x00000002
+#define SSI_CR1_EOT 0x00000010
+
+#endif // FAKE__INC_HW_SSI_H_
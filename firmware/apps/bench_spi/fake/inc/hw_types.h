@@ -0,0 +1,11 @@
+// Host stand-in for the TivaWare register access: registers are served by the SSI model.
+#ifndef FAKE__INC_HW_TYPES_H_
+#define FAKE__INC_HW_TYPES_H_
+
+#include <cstdint>
+
+uint32_t& SSIRegister(uint32_t aAddr);
+
+#define HWREG(x) SSIRegister(x)
+
+#endif // FAKE__INC_HW_TYPES_H_
@@ -0,0 +1,510 @@
+// *****************************************************************************
+//
+// Project: PFPP.
+//
+// Module: GUI checks.
+//
+// *****************************************************************************
+
+//! \file
+//! \brief Host checks of the GUI drawing helpers.
+//! The glyph cache is compared against the grlib string renderer, the
+//! screen damage tracking checked for overlaps and for what it redraws, and
+//! the status bar redraws checked against whole bars, on the LS013B7 driver
+//! and the graphics library built for the host.
+//! \ingroup app
+
+// *****************************************************************************
+//
+//        Copyright (c) 2023, Martin Garon, All rights reserved.
+//
+// This source code is licensed under the GPL-3.0-style license found in the
+// LICENSE file in the root directory of this source tree.
+//
+// *****************************************************************************
+
+// *****************************************************************************
+//                              INCLUDE FILES
+// *****************************************************************************
+
+// Firmware Libraries.
+#include "drivers/inc/GlyphCache.h"
+#include "drivers/inc/LS013B7.h"
+#include "utils/gui/Screen.h"
+#include "utils/gui/StatusBar.h"
+
+// Standard Libraries.
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstdio>
+#include <optional>
+#include <span>
+
+// *****************************************************************************
+//                      DEFINED CONSTANTS AND MACROS
+// *****************************************************************************
+
+// *****************************************************************************
+//                         TYPEDEFS AND STRUCTURES
+// *****************************************************************************
+
+// *****************************************************************************
+//                            FUNCTION PROTOTYPES
+// *****************************************************************************
+
+[[nodiscard]] static auto CreateLCD() noexcept -> Drivers::LS013B7DH03;
+static void InitContext(tContext& aContext, tDisplay& aDisplay) noexcept;
+[[nodiscard]] static auto IsSameImage(
+    Drivers::LS013B7DH03& aLCD1,
+    Drivers::LS013B7DH03& aLCD2
+) noexcept -> bool;
+[[nodiscard]] static auto CheckGlyphCache() noexcept -> bool;
+[[nodiscard]] static auto CheckDamage() noexcept -> bool;
+[[nodiscard]] static auto CheckMenuRedraw() noexcept -> bool;
+[[nodiscard]] static auto CheckStatusBar() noexcept -> bool;
+[[nodiscard]] static auto TakeChangedLineCount(Drivers::LS013B7DH03& aLCD) noexcept -> int;
+
+// *****************************************************************************
+//                             GLOBAL VARIABLES
+// *****************************************************************************
+
+static constexpr auto sWidth{128};
+static constexpr auto sHeight{128};
+
+// How many times each pixel was filled, by a display that only counts.
+static std::array<std::array<uint8_t, sWidth>, sHeight> sFillCounts{};
+
+// *****************************************************************************
+//                            EXPORTED FUNCTIONS
+// *****************************************************************************
+
+int main()
+{
+    auto lIsValid{CheckGlyphCache()};
+    lIsValid = CheckDamage() && lIsValid;
+    lIsValid = CheckMenuRedraw() && lIsValid;
+    lIsValid = CheckStatusBar() && lIsValid;
+    return lIsValid ? 0 : 1;
+}
+
+// *****************************************************************************
+//                              LOCAL FUNCTIONS
+// *****************************************************************************
+
+static auto CreateLCD() noexcept -> Drivers::LS013B7DH03
+{
+    // Flushed lines are read back from the panel buffer: nothing to send.
+    return Drivers::LS013B7DH03{
+        [](std::span<const std::byte>, std::optional<std::byte>) noexcept {},
+        []() noexcept {},
+        []() noexcept {}
+    };
+}
+
+
+static void InitContext(tContext& aContext, tDisplay& aDisplay) noexcept
+{
+    // As set by the GUI AO.
+    GrContextInit(&aContext, &aDisplay);
+    GrContextForegroundSet(&aContext, ClrWhite);
+    GrContextBackgroundSet(&aContext, ClrBlack);
+    GrContextFontSet(&aContext, &g_sFontFixed6x8);
+}
+
+
+static auto IsSameImage(
+    Drivers::LS013B7DH03& aLCD1,
+    Drivers::LS013B7DH03& aLCD2
+) noexcept -> bool
+{
+    tDisplay& lDisplay1{aLCD1};
+    tDisplay& lDisplay2{aLCD2};
+    lDisplay1.pfnFlush(lDisplay1.pvDisplayData);
+    lDisplay2.pfnFlush(lDisplay2.pvDisplayData);
+    for (auto lRowIx{0}; lRowIx < sHeight; ++lRowIx) {
+        if (!std::ranges::equal(aLCD1.GetPanelLine(lRowIx), aLCD2.GetPanelLine(lRowIx))) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+
+static auto TakeChangedLineCount(Drivers::LS013B7DH03& aLCD) noexcept -> int
+{
+    tDisplay& lDisplay{aLCD};
+    lDisplay.pfnFlush(lDisplay.pvDisplayData);
+    auto lLineCount{0};
+    for (auto lRowIx{0}; lRowIx < sHeight; ++lRowIx) {
+        lLineCount += aLCD.TakeLineChanged(lRowIx);
+    }
+
+    return lLineCount;
+}
+
+
+static auto CheckGlyphCache() noexcept -> bool
+{
+    // Same strings drawn through the cache and through grlib, over the same image:
+    // placed across the display edges and within narrower clip regions.
+    static constexpr std::array sStrings{
+        "Hello, World!",
+        "0123456789 ABCDEFGHIJKLMNOPQRSTUVWXYZ",
+        "~ }|{"
+    };
+    static constexpr std::array sClipRegions{
+        tRectangle{0, 0, sWidth - 1, sHeight - 1},
+        tRectangle{10, 20, 100, 90},
+        tRectangle{33, 3, 33, 120},
+        tRectangle{64, 64, 127, 127}
+    };
+
+    auto lCacheLCD{CreateLCD()};
+    auto lRefLCD{CreateLCD()};
+    lCacheLCD.Init();
+    lRefLCD.Init();
+
+    const Drivers::GlyphCache lGlyphCache{
+        lCacheLCD,
+        [](
+            void* const aDisplayData,
+            const int32_t aX,
+            const int32_t aY,
+            const int32_t aPixelCount,
+            std::span<const uint32_t> aBits,
+            const uint32_t aColor,
+            std::optional<uint32_t> aBkColor
+        ) noexcept
+        {
+            static_cast<Drivers::LS013B7DH03*>(aDisplayData)->BitRowDraw(aX, aY, aPixelCount, aBits, aColor, aBkColor);
+        }
+    };
+
+    tContext lCacheContext{};
+    tContext lRefContext{};
+    InitContext(lCacheContext, lCacheLCD);
+    InitContext(lRefContext, lRefLCD);
+    lCacheContext.pfnStringRenderer = Drivers::GlyphCache::StringRender;
+    lRefContext.pfnStringRenderer = GrDefaultStringRenderer;
+
+    std::printf("%-20s %12s\n", "Glyph cache", "image");
+    auto lIsValid{true};
+    for (const auto& lClipRegion : sClipRegions) {
+        GrContextClipRegionSet(&lCacheContext, &lClipRegion);
+        GrContextClipRegionSet(&lRefContext, &lClipRegion);
+        for (const auto lString : sStrings) {
+            for (auto lY{-9}; lY < sHeight + 2; lY += 13) {
+                for (auto lX{-41}; lX < sWidth + 2; lX += 11) {
+                    const auto lIsOpaque{((lX + lY) & 0x1) != 0};
+                    GrStringDraw(&lCacheContext, lString, -1, lX, lY, lIsOpaque);
+                    GrStringDraw(&lRefContext, lString, -1, lX, lY, lIsOpaque);
+                    if (!IsSameImage(lCacheLCD, lRefLCD)) {
+                        std::printf(
+                            "Glyph cache, '%s' at %d, %d, clip %d, %d, %d, %d: image differs from grlib.\n",
+                            lString, lX, lY,
+                            lClipRegion.i16XMin, lClipRegion.i16YMin, lClipRegion.i16XMax, lClipRegion.i16YMax
+                        );
+                        lIsValid = false;
+                    }
+                }
+            }
+        }
+
+        // Inverted colors, so later strings draw over set pixels.
+        std::swap(lCacheContext.ui32Foreground, lCacheContext.ui32Background);
+        std::swap(lRefContext.ui32Foreground, lRefContext.ui32Background);
+    }
+
+    // Clipped strings are drawn from the cache too.
+    const auto lStats{lGlyphCache.GetStats()};
+    if (lStats.mFallbacks != 0) {
+        std::printf("Glyph cache: %u strings fell back to grlib.\n", lStats.mFallbacks);
+        lIsValid = false;
+    }
+    std::printf("%-20s %12s\n", "  clipped strings", lIsValid ? "same as grlib" : "DIFF");
+    return lIsValid;
+}
+
+
+static auto CheckDamage() noexcept -> bool
+{
+    // Render() clears each damage rectangle once: on a display counting fills,
+    // every damaged pixel must be filled exactly once.
+    tDisplay lCounter{
+        .i32Size{sizeof(tDisplay)}
+        , .pvDisplayData{nullptr}
+        , .ui16Width{sWidth}
+        , .ui16Height{sHeight}
+        , .pfnPixelDraw{[](void*, int32_t, int32_t, uint32_t) noexcept {}}
+        , .pfnPixelDrawMultiple{
+            [](void*, int32_t, int32_t, int32_t, int32_t, int32_t, const uint8_t*, const uint8_t*) noexcept {}
+        }
+        , .pfnLineDrawH{[](void*, int32_t, int32_t, int32_t, uint32_t) noexcept {}}
+        , .pfnLineDrawV{[](void*, int32_t, int32_t, int32_t, uint32_t) noexcept {}}
+        , .pfnRectFill{
+            [](void*, const tRectangle* const psRect, uint32_t) noexcept
+            {
+                for (auto lY{psRect->i16YMin}; lY <= psRect->i16YMax; ++lY) {
+                    for (auto lX{psRect->i16XMin}; lX <= psRect->i16XMax; ++lX) {
+                        ++sFillCounts[lY][lX];
+                    }
+                }
+            }
+        }
+        , .pfnColorTranslate{[](void*, const uint32_t ui32Value) noexcept -> uint32_t {return ui32Value;}}
+        , .pfnFlush{[](void*) noexcept {}}
+    };
+
+    tContext lContext{};
+    GrContextInit(&lContext, &lCounter);
+    Utils::GUI::Screen lScreen{lContext};
+    lScreen.Show({});
+    static_cast<void>(lScreen.Render());
+
+    // Random rectangles, partly off the display, more than there are damage slots.
+    auto lSeed{0x2545f491U};
+    const auto lRandom{
+        [&lSeed](const int aMax) noexcept
+        {
+            lSeed = lSeed * 1664525U + 1013904223U;
+            return static_cast<int>((lSeed >> 8) % static_cast<unsigned int>(aMax));
+        }
+    };
+
+    std::printf("\n%-20s %12s\n", "Damage", "fills");
+    auto lIsValid{true};
+    for (auto lPass{0}; lPass < 2000; ++lPass) {
+        sFillCounts = {};
+        std::array<std::array<bool, sWidth>, sHeight> lIsDamaged{};
+        const auto lRectCount{1 + lRandom(8)};
+        for (auto lRectIx{0}; lRectIx < lRectCount; ++lRectIx) {
+            const auto lX{lRandom(sWidth + 20) - 10};
+            const auto lY{lRandom(sHeight + 20) - 10};
+            const tRectangle lRect{
+                static_cast<int16_t>(lX), static_cast<int16_t>(lY),
+                static_cast<int16_t>(lX + lRandom(50)), static_cast<int16_t>(lY + lRandom(50))
+            };
+            lScreen.Invalidate(lRect);
+            for (auto lRowIx{std::max<int>(lRect.i16YMin, 0)}; lRowIx <= std::min<int>(lRect.i16YMax, sHeight - 1); ++lRowIx) {
+                for (auto lColIx{std::max<int>(lRect.i16XMin, 0)}; lColIx <= std::min<int>(lRect.i16XMax, sWidth - 1); ++lColIx) {
+                    lIsDamaged[lRowIx][lColIx] = true;
+                }
+            }
+        }
+        static_cast<void>(lScreen.Render());
+
+        for (auto lRowIx{0}; lRowIx < sHeight; ++lRowIx) {
+            for (auto lColIx{0}; lColIx < sWidth; ++lColIx) {
+                const auto lFillCount{sFillCounts[lRowIx][lColIx]};
+                if ((lFillCount > 1) || (lIsDamaged[lRowIx][lColIx] && (lFillCount == 0))) {
+                    std::printf(
+                        "Damage, pass %d: pixel %d, %d filled %u times.\n",
+                        lPass, lColIx, lRowIx, lFillCount
+                    );
+                    lIsValid = false;
+                    lRowIx = sHeight;
+                    break;
+                }
+            }
+        }
+    }
+
+    std::printf("%-20s %12s\n", "  random rectangles", lIsValid ? "once each" : "OVERLAP");
+    return lIsValid;
+}
+
+
+static auto CheckMenuRedraw() noexcept -> bool
+{
+    // The config menu of the GUI AO: moving the selection redraws both rows, and the frame
+    // under them. Only the lines of both rows are sent.
+    static constexpr auto sRowLineCount{12};
+    std::array<Utils::GUI::Widget, 5> lWidgets{
+        {
+            {Utils::GUI::Widget::Kind::Frame, {5, 5, 122, 122}, "Config Menu"},
+            {Utils::GUI::Widget::Kind::ListRow, {10, 20, 117, 31}, "Feed Config", true},
+            {Utils::GUI::Widget::Kind::ListRow, {10, 34, 117, 45}, "Calendar"},
+            {Utils::GUI::Widget::Kind::ListRow, {10, 48, 117, 59}, "About"},
+            {Utils::GUI::Widget::Kind::ListRow, {10, 62, 117, 73}, "Quit"}
+        }
+    };
+
+    auto lLCD{CreateLCD()};
+    lLCD.Init();
+    tContext lContext{};
+    InitContext(lContext, lLCD);
+    Utils::GUI::Screen lScreen{lContext};
+
+    lScreen.Show(lWidgets);
+    const auto lShowDrawCount{lScreen.Render()};
+    const auto lShowLineCount{TakeChangedLineCount(lLCD)};
+
+    lScreen.Select(1, false);
+    lScreen.Select(2, true);
+    const auto lMoveDrawCount{lScreen.Render()};
+    const auto lMoveLineCount{TakeChangedLineCount(lLCD)};
+
+    std::printf("\n%-20s %8s %8s\n", "Config menu", "widgets", "lines");
+    std::printf("%-20s %8u %8d\n", "shown", lShowDrawCount, lShowLineCount);
+    std::printf("%-20s %8u %8d\n", "selection moved", lMoveDrawCount, lMoveLineCount);
+
+    const auto lIsValid{
+        (lShowDrawCount == lWidgets.size())
+        && (lMoveDrawCount == 4)
+        && (lMoveLineCount == 2 * sRowLineCount)
+    };
+    if (!lIsValid) {
+        std::printf("Config menu: expected 4 widgets and %d lines redrawn on a selection move.\n", 2 * sRowLineCount);
+    }
+
+    return lIsValid;
+}
+
+
+static auto CheckStatusBar() noexcept -> bool
+{
+    // Where the GUI AO puts the bar. The reference redraws the whole bar, formatted here,
+    // on every tick: both images must match, and the bar must draw only the cells that differ.
+    static constexpr auto sX{7};
+    static constexpr auto sY{108};
+    static constexpr auto sCellCount{19};
+    static constexpr auto sLineCount{8};
+
+    auto lBarLCD{CreateLCD()};
+    auto lRefLCD{CreateLCD()};
+    lBarLCD.Init();
+    lRefLCD.Init();
+    tContext lBarContext{};
+    tContext lRefContext{};
+    InitContext(lBarContext, lBarLCD);
+    InitContext(lRefContext, lRefLCD);
+    Utils::GUI::StatusBar lStatusBar{lBarContext, sX, sY};
+
+    using Text = std::array<char, sCellCount + 1>;
+    const auto lFormat{
+        [](const int aSeconds, const std::optional<int> aNextFeedMinutes, const bool aIsMotorOn) noexcept
+        {
+            Text lText{};
+            const auto lTimeOfDay{aSeconds % (24 * 3600)};
+            if (aNextFeedMinutes) {
+                const auto lNextFeed{*aNextFeedMinutes % (24 * 60)};
+                std::snprintf(
+                    lText.data(), lText.size(), "%02d:%02d:%02d >%02d:%02d %s",
+                    lTimeOfDay / 3600, (lTimeOfDay / 60) % 60, lTimeOfDay % 60,
+                    lNextFeed / 60, lNextFeed % 60,
+                    aIsMotorOn ? "ON " : "OFF"
+                );
+            } else {
+                std::snprintf(
+                    lText.data(), lText.size(), "%02d:%02d:%02d  --:-- %s",
+                    lTimeOfDay / 3600, (lTimeOfDay / 60) % 60, lTimeOfDay % 60,
+                    aIsMotorOn ? "ON " : "OFF"
+                );
+            }
+            return lText;
+        }
+    };
+
+    // Only the lines of the bar are ever sent.
+    const auto lIsWithinBar{
+        [&lBarLCD]() noexcept
+        {
+            tDisplay& lDisplay{lBarLCD};
+            lDisplay.pfnFlush(lDisplay.pvDisplayData);
+            auto lIsWithin{true};
+            for (auto lRowIx{0}; lRowIx < sHeight; ++lRowIx) {
+                const auto lIsChanged{lBarLCD.TakeLineChanged(lRowIx)};
+                lIsWithin = lIsWithin && (!lIsChanged || ((lRowIx >= sY) && (lRowIx < sY + sLineCount)));
+            }
+            return lIsWithin;
+        }
+    };
+
+    // Two hours of 1 s ticks, across midnight. The next feed time and the motor change
+    // on some ticks, as the feeder manager would have them.
+    static constexpr auto sStartTime{23 * 3600 + 1234};
+    static constexpr auto sTickCount{2 * 3600};
+    std::optional<int> lNextFeedMinutes{};
+    auto lIsMotorOn{false};
+    auto lText{lFormat(sStartTime, lNextFeedMinutes, lIsMotorOn)};
+
+    lStatusBar.SetTime(std::chrono::seconds{sStartTime});
+    lStatusBar.Show();
+    auto lDrawCount{lStatusBar.Render()};
+    GrStringDraw(&lRefContext, lText.data(), sCellCount, sX, sY, true);
+    auto lIsValid{(lDrawCount == sCellCount) && IsSameImage(lBarLCD, lRefLCD)};
+    if (!lIsValid) {
+        std::printf("Status bar: shown with %u cells drawn, or image differs.\n", lDrawCount);
+    }
+    // The clear of Init() goes out with the first flush.
+    static_cast<void>(TakeChangedLineCount(lBarLCD));
+
+    auto lBarCellCount{0U};
+    for (auto lTickIx{1}; lTickIx <= sTickCount; ++lTickIx) {
+        const auto lTime{sStartTime + lTickIx};
+        if ((lTickIx % 1500) == 0) {
+            lNextFeedMinutes = lTime / 60 + 45;
+        } else if ((lTickIx % 1500) == 900) {
+            lNextFeedMinutes.reset();
+        }
+        if ((lTickIx % 700) < 2) {
+            lIsMotorOn = !lIsMotorOn;
+        }
+
+        const auto lNextText{lFormat(lTime, lNextFeedMinutes, lIsMotorOn)};
+        auto lChangedCount{0U};
+        for (auto lCellIx{0}; lCellIx < sCellCount; ++lCellIx) {
+            lChangedCount += (lNextText[lCellIx] != lText[lCellIx]);
+        }
+        lText = lNextText;
+
+        lStatusBar.SetTime(std::chrono::seconds{lTime});
+        lStatusBar.SetNextFeedTime(
+            lNextFeedMinutes ? std::optional{std::chrono::minutes{*lNextFeedMinutes}} : std::nullopt
+        );
+        lStatusBar.SetMotorOn(lIsMotorOn);
+        const auto lIsDamaged{lStatusBar.IsDamaged()};
+        const auto lTickDrawCount{lStatusBar.Render()};
+        lDrawCount += lTickDrawCount;
+        lBarCellCount += sCellCount;
+
+        GrStringDraw(&lRefContext, lText.data(), sCellCount, sX, sY, true);
+        if ((lTickDrawCount != lChangedCount)
+            || (lIsDamaged != (lChangedCount != 0))
+            || !lIsWithinBar()
+            || !IsSameImage(lBarLCD, lRefLCD)) {
+            std::printf(
+                "Status bar, '%s': %u cells drawn, %u changed, or image differs.\n",
+                lText.data(), lTickDrawCount, lChangedCount
+            );
+            lIsValid = false;
+            break;
+        }
+    }
+
+    // Hidden, the bar draws nothing. Shown again, all of it is redrawn.
+    lStatusBar.Hide();
+    lStatusBar.SetTime(std::chrono::seconds{sStartTime});
+    const auto lHiddenDrawCount{lStatusBar.Render()};
+    lStatusBar.Show();
+    const auto lShownDrawCount{lStatusBar.Render()};
+    GrStringDraw(&lRefContext, lFormat(sStartTime, lNextFeedMinutes, lIsMotorOn).data(), sCellCount, sX, sY, true);
+    if ((lHiddenDrawCount != 0) || (lShownDrawCount != sCellCount) || !IsSameImage(lBarLCD, lRefLCD)) {
+        std::printf(
+            "Status bar: %u cells drawn hidden, %u shown again, or image differs.\n",
+            lHiddenDrawCount, lShownDrawCount
+        );
+        lIsValid = false;
+    }
+
+    std::printf("\n%-20s %8s %8s\n", "Status bar", "cells", "bar");
+    std::printf("%-20s %8u %8u\n", "2 h of 1 s ticks", lDrawCount - sCellCount, lBarCellCount);
+    std::printf("%-20s %8s\n", "  image", lIsValid ? "same as whole bar" : "DIFF");
+    return lIsValid;
+}
+
+// *****************************************************************************
+//                                END OF FILE
+// *****************************************************************************
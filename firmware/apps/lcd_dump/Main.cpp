@@ -0,0 +1,466 @@
+// *****************************************************************************
+//
+// Project: PFPP.
+//
+// Module: LCD dump decoder.
+//
+// *****************************************************************************
+
+//! \file
+//! \brief Host decoder of the LCD dumps printed by the "lcd" shell command.
+//! Reads a log of the shell output, from a file or stdin, and writes each dump
+//! as a PBM image. Diff dumps are applied over the previous dumps, so a log of
+//! periodic "lcd diff" gives one image per dump of what the panel showed.
+//! Other shell output in the log is skipped.
+//! With --check, random scenes drawn on each LS013B7 panel size are dumped
+//! through the shell dispatch instead, and must decode to what the panel shows.
+//! \ingroup app
+
+// *****************************************************************************
+//
+//        Copyright (c) 2023, Martin Garon, All rights reserved.
+//
+// This source code is licensed under the GPL-3.0-style license found in the
+// LICENSE file in the root directory of this source tree.
+//
+// *****************************************************************************
+
+// *****************************************************************************
+//                              INCLUDE FILES
+// *****************************************************************************
+
+// This application.
+#include "ShellLog.h"
+
+// Firmware Libraries.
+#include "drivers/inc/LS013B7.h"
+#include "drivers/inc/RLEImage.h"
+#include "utils/shell/LCDDumpCmd.h"
+#include "utils/shell/Shell.h"
+
+// Standard Libraries.
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <optional>
+#include <span>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// *****************************************************************************
+//                      DEFINED CONSTANTS AND MACROS
+// *****************************************************************************
+
+// *****************************************************************************
+//                         TYPEDEFS AND STRUCTURES
+// *****************************************************************************
+
+//! \brief The panel as rebuilt from the dumps: one byte per pixel, non-zero for dark pixels.
+struct Panel
+{
+    int mWidth{};
+    int mHeight{};
+    std::vector<uint8_t> mPixels{};
+};
+
+//! \brief Called with the panel as rebuilt at the end of each dump.
+//! \return false on an error.
+using OnDump = std::function<
+    bool(const Panel& aPanel, const std::string& aMode, unsigned int aLineCount, unsigned int aByteCount)
+>;
+
+// *****************************************************************************
+//                            FUNCTION PROTOTYPES
+// *****************************************************************************
+
+[[nodiscard]] static auto DecodeLog(std::istream& aInput, const OnDump& aOnDump) noexcept -> int;
+template<typename LCD>
+[[nodiscard]] static auto CheckScenes() noexcept -> bool;
+[[nodiscard]] static auto ParseHex(std::string_view aText) noexcept -> std::optional<std::vector<uint8_t>>;
+[[nodiscard]] static auto DecodeLine(Panel& aPanel, int aRowIx, std::string_view aRuns) noexcept -> bool;
+[[nodiscard]] static auto WritePBM(const std::filesystem::path& aPath, const Panel& aPanel) noexcept -> bool;
+
+// *****************************************************************************
+//                             GLOBAL VARIABLES
+// *****************************************************************************
+
+// *****************************************************************************
+//                            EXPORTED FUNCTIONS
+// *****************************************************************************
+
+int main(int argc, char* argv[])
+{
+    // lcd_dump [<log>] [-o <output dir>]
+    // lcd_dump --check
+    std::filesystem::path lInputPath{};
+    std::filesystem::path lOutputDir{"dumps"};
+    for (auto lArgIx{1}; lArgIx < argc; ++lArgIx) {
+        const std::string_view lOption{argv[lArgIx]};
+        if (lOption == "--check") {
+            std::printf("%-12s %8s %8s %8s\n", "Panel", "dumps", "lines", "decoded");
+            const auto lIsValid{
+                CheckScenes<Drivers::LS013B7DH03>()
+                && CheckScenes<Drivers::LS013B7DH05>()
+                && CheckScenes<Drivers::LS027B7DH01>()
+            };
+            return lIsValid ? 0 : 1;
+        }
+        if ((lOption == "-o") && (lArgIx + 1 < argc)) {
+            lOutputDir = argv[++lArgIx];
+        }
+        else {
+            lInputPath = argv[lArgIx];
+        }
+    }
+
+    std::ifstream lFile{};
+    if (!lInputPath.empty()) {
+        lFile.open(lInputPath);
+        if (!lFile) {
+            std::fprintf(stderr, "%s: can't open.\n", lInputPath.c_str());
+            return 1;
+        }
+    }
+    auto& lInput{lInputPath.empty() ? std::cin : lFile};
+    std::filesystem::create_directories(lOutputDir);
+
+    auto lDumpCount{0};
+    std::printf("%-12s %6s %8s %8s\n", "Dump", "mode", "lines", "bytes");
+    const auto lErrorCount{
+        DecodeLog(
+            lInput,
+            [&lOutputDir, &lDumpCount](
+                const Panel& aPanel,
+                const std::string& aMode,
+                const unsigned int aLineCount,
+                const unsigned int aByteCount
+            ) noexcept
+            {
+                char lName[32]{};
+                std::snprintf(lName, sizeof(lName), "dump_%04d.pbm", lDumpCount++);
+                std::printf("%-12s %6s %8u %8u\n", lName, aMode.c_str(), aLineCount, aByteCount);
+                if (!WritePBM(lOutputDir / lName, aPanel)) {
+                    std::fprintf(stderr, "%s: can't write.\n", lName);
+                    return false;
+                }
+                return true;
+            }
+        )
+    };
+
+    return (lErrorCount == 0) ? 0 : 1;
+}
+
+// *****************************************************************************
+//                              LOCAL FUNCTIONS
+// *****************************************************************************
+
+static auto DecodeLog(std::istream& aInput, const OnDump& aOnDump) noexcept -> int
+{
+    Panel lPanel{};
+    auto lIsInDump{false};
+    auto lDumpCount{0};
+    auto lErrorCount{0};
+    auto lLineCount{0U};
+    std::string lMode{};
+    for (std::string lText{}; std::getline(aInput, lText); ) {
+        // Serial logs come with CR LF line endings.
+        if (!lText.empty() && (lText.back() == '\r')) {
+            lText.pop_back();
+        }
+        std::istringstream lFields{lText};
+        std::string lFirst{};
+        lFields >> lFirst;
+
+        if (lFirst == "lcd") {
+            auto lWidth{0};
+            auto lHeight{0};
+            lFields >> lWidth >> lHeight >> lMode;
+            if (!lFields || (lWidth <= 0) || (lHeight <= 0) || ((lMode != "full") && (lMode != "diff"))) {
+                continue;
+            }
+
+            // A panel of another size starts over, all light.
+            if ((lWidth != lPanel.mWidth) || (lHeight != lPanel.mHeight)) {
+                lPanel = Panel{lWidth, lHeight, std::vector<uint8_t>(static_cast<std::size_t>(lWidth) * lHeight, 0)};
+            }
+            lIsInDump = true;
+            lLineCount = 0;
+            continue;
+        }
+
+        if (!lIsInDump) {
+            continue;
+        }
+
+        if (lFirst == "end") {
+            auto lExpectedLineCount{0U};
+            auto lByteCount{0U};
+            lFields >> lExpectedLineCount >> lByteCount;
+            lIsInDump = false;
+            if (!lFields || (lExpectedLineCount != lLineCount)) {
+                std::fprintf(stderr, "dump %d: %u lines of %u.\n", lDumpCount, lLineCount, lExpectedLineCount);
+                ++lErrorCount;
+            }
+
+            if (!aOnDump(lPanel, lMode, lLineCount, lByteCount)) {
+                ++lErrorCount;
+            }
+            ++lDumpCount;
+            continue;
+        }
+
+        auto lRowIx{0};
+        std::string lRuns{};
+        std::istringstream lRowFields{lText};
+        lRowFields >> lRowIx >> lRuns;
+        if (!lRowFields || !DecodeLine(lPanel, lRowIx, lRuns)) {
+            std::fprintf(stderr, "dump %d: bad line '%s'.\n", lDumpCount, lText.c_str());
+            ++lErrorCount;
+            continue;
+        }
+        ++lLineCount;
+    }
+
+    return lErrorCount;
+}
+
+
+template<typename LCD>
+static auto CheckScenes() noexcept -> bool
+{
+    // Random fills, flushed, then dumped through the shell as on the target: full
+    // dumps now and then, diff ones otherwise, with other shell output in between.
+    // Each dump must decode to the panel as flushed, and a diff dump must hold
+    // exactly the lines changed since the previous dump.
+    LCD lLCD{
+        [](std::span<const std::byte> /*aData*/, std::optional<std::byte> /*aAddr*/) noexcept {},
+        []() noexcept {},
+        []() noexcept {}
+    };
+    tDisplay& lDisplay{lLCD};
+    const int lWidth{lDisplay.ui16Width};
+    const int lHeight{lDisplay.ui16Height};
+    lLCD.Init();
+
+    Utils::Shell lShell{};
+    Utils::AddLCDDumpCmd(lShell, lLCD);
+    const auto lDispatch{
+        [&lShell](const char* const aCmdLine) noexcept
+        {
+            std::array<char, 32> lCmdLine{};
+            std::strncpy(lCmdLine.data(), aCmdLine, lCmdLine.size() - 1);
+            lShell.CmdLineDispatch(lCmdLine.data());
+        }
+    };
+
+    // The first dump is a full one: the panel starts cleared, as after Init().
+    lDispatch("lcd bad");
+    if (TakeShellLog() != "format: lcd [diff]\n") {
+        std::printf("%dx%d: bad arguments not reported.\n", lWidth, lHeight);
+        return false;
+    }
+    lDispatch("lcd");
+
+    auto lSeed{0x0dd5eedU};
+    const auto lRandom{
+        [&lSeed](const int aMax) noexcept
+        {
+            lSeed = lSeed * 1664525U + 1013904223U;
+            return static_cast<int>((lSeed >> 8) % static_cast<unsigned int>(aMax));
+        }
+    };
+
+    // The panel as flushed, and the count of lines the dump must hold, for each dump.
+    struct Expected
+    {
+        std::vector<uint8_t> mPixels{};
+        unsigned int mLineCount{};
+    };
+    std::vector<Expected> lExpected{};
+    const auto lTakePanel{
+        [&lLCD, lWidth, lHeight]() noexcept
+        {
+            std::vector<uint8_t> lPixels(static_cast<std::size_t>(lWidth) * lHeight);
+            for (auto lRowIx{0}; lRowIx < lHeight; ++lRowIx) {
+                const auto lLine{lLCD.GetPanelLine(lRowIx)};
+                for (auto lX{0}; lX < lWidth; ++lX) {
+                    lPixels[static_cast<std::size_t>(lRowIx) * lWidth + lX] =
+                        (lLine[lX / 8] & (std::byte{0x80} >> (lX % 8))) == std::byte{0};
+                }
+            }
+            return lPixels;
+        }
+    };
+    lExpected.push_back({lTakePanel(), static_cast<unsigned int>(lHeight)});
+
+    static constexpr auto sSceneCount{200};
+    for (auto lSceneIx{0}; lSceneIx < sSceneCount; ++lSceneIx) {
+        // Some scenes draw nothing, some clear the panel: all its lines are then dumped.
+        const auto lIsCleared{lRandom(20) == 0};
+        if (lIsCleared) {
+            lLCD.Clear();
+        }
+        const auto lFillCount{lRandom(4) == 0 ? 0 : lRandom(12)};
+        for (auto lFillIx{0}; lFillIx < lFillCount; ++lFillIx) {
+            const auto lX{lRandom(lWidth)};
+            const auto lY{lRandom(lHeight)};
+            const tRectangle lRect{
+                static_cast<int16_t>(lX), static_cast<int16_t>(lY),
+                static_cast<int16_t>(std::min(lX + lRandom(lWidth), lWidth - 1)),
+                static_cast<int16_t>(std::min(lY + lRandom(30), lHeight - 1))
+            };
+            lDisplay.pfnRectFill(lDisplay.pvDisplayData, &lRect, static_cast<uint32_t>(lRandom(2)));
+        }
+        lDisplay.pfnFlush(lDisplay.pvDisplayData);
+
+        const auto lIsFull{(lSceneIx % 10) == 9};
+        auto lPixels{lTakePanel()};
+        auto lLineCount{static_cast<unsigned int>(lHeight)};
+        if (!lIsFull && !lIsCleared) {
+            lLineCount = 0;
+            for (auto lRowIx{0}; lRowIx < lHeight; ++lRowIx) {
+                const auto lRowStart{static_cast<std::ptrdiff_t>(lRowIx) * lWidth};
+                lLineCount += !std::equal(
+                    lPixels.begin() + lRowStart, lPixels.begin() + lRowStart + lWidth,
+                    lExpected.back().mPixels.begin() + lRowStart
+                );
+            }
+        }
+        lExpected.push_back({std::move(lPixels), lLineCount});
+
+        lDispatch("help");
+        lDispatch(lIsFull ? "lcd" : "lcd diff");
+    }
+
+    // The log of the whole session, decoded in one go, as a serial log would be.
+    std::istringstream lLog{TakeShellLog()};
+    std::size_t lDumpIx{0};
+    auto lLineCount{0U};
+    const auto lErrorCount{
+        DecodeLog(
+            lLog,
+            [&lExpected, &lDumpIx, &lLineCount](
+                const Panel& aPanel,
+                const std::string& /*aMode*/,
+                const unsigned int aLineCount,
+                const unsigned int /*aByteCount*/
+            ) noexcept
+            {
+                const auto lIsSame{
+                    (lDumpIx < lExpected.size())
+                    && (aPanel.mPixels == lExpected[lDumpIx].mPixels)
+                    && (aLineCount == lExpected[lDumpIx].mLineCount)
+                };
+                if (!lIsSame) {
+                    std::printf(
+                        "dump %zu: %u lines, %u expected, or decoded image differs.\n",
+                        lDumpIx, aLineCount, (lDumpIx < lExpected.size()) ? lExpected[lDumpIx].mLineCount : 0
+                    );
+                }
+                lLineCount += aLineCount;
+                ++lDumpIx;
+                return lIsSame;
+            }
+        )
+    };
+
+    const auto lIsValid{(lErrorCount == 0) && (lDumpIx == lExpected.size())};
+    std::printf(
+        "%4dx%-7d %8zu %8u %8s\n",
+        lWidth, lHeight, lDumpIx, lLineCount, lIsValid ? "exactly" : "DIFF"
+    );
+    return lIsValid;
+}
+
+
+static auto ParseHex(const std::string_view aText) noexcept -> std::optional<std::vector<uint8_t>>
+{
+    const auto lDigit{
+        [](const char aChar) noexcept -> int
+        {
+            if ((aChar >= '0') && (aChar <= '9')) {
+                return aChar - '0';
+            }
+            if ((aChar >= 'a') && (aChar <= 'f')) {
+                return aChar - 'a' + 10;
+            }
+            return -1;
+        }
+    };
+
+    if ((aText.size() % 2) != 0) {
+        return std::nullopt;
+    }
+
+    std::vector<uint8_t> lBytes{};
+    for (std::size_t lIx{0}; lIx < aText.size(); lIx += 2) {
+        const auto lHigh{lDigit(aText[lIx])};
+        const auto lLow{lDigit(aText[lIx + 1])};
+        if ((lHigh < 0) || (lLow < 0)) {
+            return std::nullopt;
+        }
+        lBytes.push_back(static_cast<uint8_t>((lHigh << 4) | lLow));
+    }
+
+    return lBytes;
+}
+
+
+static auto DecodeLine(Panel& aPanel, const int aRowIx, const std::string_view aRuns) noexcept -> bool
+{
+    const auto lBytes{ParseHex(aRuns)};
+    if (!lBytes || (aRowIx < 0) || (aRowIx >= aPanel.mHeight)) {
+        return false;
+    }
+
+    // Runs alternate from light pixels, and add up to the width.
+    std::span<const uint8_t> lData{*lBytes};
+    const auto lRow{&aPanel.mPixels[static_cast<std::size_t>(aRowIx) * aPanel.mWidth]};
+    auto lPixelCount{0};
+    for (uint8_t lValue{0}; !lData.empty(); lValue = !lValue) {
+        const auto lRun{Drivers::RLEImage::ReadRun(lData)};
+        if (lPixelCount + lRun > aPanel.mWidth) {
+            return false;
+        }
+        std::fill_n(lRow + lPixelCount, lRun, lValue);
+        lPixelCount += lRun;
+    }
+
+    return lPixelCount == aPanel.mWidth;
+}
+
+
+static auto WritePBM(const std::filesystem::path& aPath, const Panel& aPanel) noexcept -> bool
+{
+    std::ofstream lFile{aPath, std::ios::binary};
+    if (!lFile) {
+        return false;
+    }
+
+    // Rows packed MSB first, a set bit being a dark pixel.
+    lFile << "P4\n" << aPanel.mWidth << ' ' << aPanel.mHeight << '\n';
+    for (auto lY{0}; lY < aPanel.mHeight; ++lY) {
+        for (auto lX{0}; lX < aPanel.mWidth; lX += 8) {
+            uint8_t lByte{0};
+            for (auto lBitIx{0}; (lBitIx < 8) && (lX + lBitIx < aPanel.mWidth); ++lBitIx) {
+                lByte |= aPanel.mPixels[static_cast<std::size_t>(lY) * aPanel.mWidth + lX + lBitIx] << (7 - lBitIx);
+            }
+            lFile.put(static_cast<char>(lByte));
+        }
+    }
+
+    return static_cast<bool>(lFile);
+}
+
+// *****************************************************************************
+//                                END OF FILE
+// *****************************************************************************
@@ -0,0 +1,145 @@
+// *****************************************************************************
+//
+// Project: PFPP.
+//
+// Module: LCD dump decoder.
+//
+// *****************************************************************************
+
+//! \file
+//! \brief Host stand-in of the shell: commands are dispatched as on the target,
+//! and what they print is kept for TakeShellLog().
+//! Only what the lcd command uses is provided.
+//! \ingroup app
+
+// *****************************************************************************
+//
+//        Copyright (c) 2023, Martin Garon, All rights reserved.
+//
+// This source code is licensed under the GPL-3.0-style license found in the
+// LICENSE file in the root directory of this source tree.
+//
+// *****************************************************************************
+
+// *****************************************************************************
+//                              INCLUDE FILES
+// *****************************************************************************
+
+// This application.
+#include "ShellLog.h"
+
+// Firmware Libraries.
+#include "utils/shell/Shell.h"
+
+// Standard Libraries.
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <utility>
+
+// *****************************************************************************
+//                      DEFINED CONSTANTS AND MACROS
+// *****************************************************************************
+
+// *****************************************************************************
+//                         TYPEDEFS AND STRUCTURES
+// *****************************************************************************
+
+// *****************************************************************************
+//                            FUNCTION PROTOTYPES
+// *****************************************************************************
+
+// *****************************************************************************
+//                             GLOBAL VARIABLES
+// *****************************************************************************
+
+static std::string sShellLog{};
+
+// *****************************************************************************
+//                            EXPORTED FUNCTIONS
+// *****************************************************************************
+
+auto TakeShellLog() noexcept -> std::string
+{
+    return std::exchange(sShellLog, {});
+}
+
+
+namespace Utils
+{
+
+
+Shell::Shell() noexcept
+{
+    // Ctor body.
+}
+
+
+void Shell::AddShellCmd(const ShellCmd aShellCmd) noexcept
+{
+    mCmds.insert(std::make_pair(aShellCmd.GetName(), aShellCmd));
+}
+
+
+void Shell::AddShellCmd(
+    const char* const aName,
+    const Utils::ShellCmd::tFunction aFunction,
+    void* const aParam
+) noexcept
+{
+    mCmds.emplace(
+        std::make_pair(
+            std::string_view{aName},
+            ShellCmd{aName, aFunction, aParam}
+        )
+    );
+}
+
+
+void Shell::Printf(const char* const aFormat, ...) noexcept
+{
+    std::va_list lArgs{};
+    va_start(lArgs, aFormat);
+    std::array<char, 256> lText{};
+    const auto lSize{std::vsnprintf(lText.data(), lText.size(), aFormat, lArgs)};
+    va_end(lArgs);
+    if (lSize > 0) {
+        sShellLog.append(lText.data(), std::min<std::size_t>(static_cast<std::size_t>(lSize), lText.size() - 1));
+    }
+}
+
+
+void Shell::CmdLineDispatch(const char* const aCmdLine) noexcept
+{
+    // As on the target, the line is split in place.
+    static constexpr auto sMaxTokens{10};
+    std::array<const char*, sMaxTokens> lTokens{};
+    auto lTokenCount{0};
+    lTokens[0] = std::strtok(const_cast<char*>(aCmdLine), " \n\r\t");
+    while ((lTokenCount < sMaxTokens - 1) && lTokens[lTokenCount]) {
+        ++lTokenCount;
+        lTokens[lTokenCount] = std::strtok(nullptr, " \n\r\t");
+    }
+
+    if (lTokenCount == 0) {
+        return;
+    }
+
+    if (const auto lCmd{mCmds.find(lTokens[0])}; lCmd != mCmds.cend()) {
+        lCmd->second.Execute(this, lTokenCount - 1, &lTokens[1]);
+    }
+    else {
+        Printf("Unknown command '%s'.\n", lTokens[0]);
+    }
+}
+
+
+} // namespace Utils
+
+// *****************************************************************************
+//                              LOCAL FUNCTIONS
+// *****************************************************************************
+
+// *****************************************************************************
+//                                END OF FILE
+// *****************************************************************************
@@ -0,0 +1,57 @@
+#ifndef APPS__LCD_DUMP__SHELLLOG_H_
+#define APPS__LCD_DUMP__SHELLLOG_H_
+// *****************************************************************************
+//
+// Project: PFPP.
+//
+// Module: LCD dump decoder.
+//
+// *****************************************************************************
+
+//! \file
+//! \brief What the host stand-in of the shell printed.
+//! \ingroup app
+
+// *****************************************************************************
+//
+//        Copyright (c) 2023, Martin Garon, All rights reserved.
+//
+// This source code is licensed under the GPL-3.0-style license found in the
+// LICENSE file in the root directory of this source tree.
+//
+// *****************************************************************************
+
+// *****************************************************************************
+//                              INCLUDE FILES
+// *****************************************************************************
+
+// Standard Libraries.
+#include <string>
+
+// *****************************************************************************
+//                      DEFINED CONSTANTS AND MACROS
+// *****************************************************************************
+
+// *****************************************************************************
+//                         TYPEDEFS AND STRUCTURES
+// *****************************************************************************
+
+// *****************************************************************************
+//                            EXPORTED VARIABLES
+// *****************************************************************************
+
+// *****************************************************************************
+//                                 EXTERNS
+// *****************************************************************************
+
+// *****************************************************************************
+//                            EXPORTED FUNCTIONS
+// *****************************************************************************
+
+//! \brief Returns what the shell printed since the last call, as a serial log would show it.
+[[nodiscard]] auto TakeShellLog() noexcept -> std::string;
+
+// *****************************************************************************
+//                                END OF FILE
+// *****************************************************************************
+#endif // APPS__LCD_DUMP__SHELLLOG_H_
@@ -0,0 +1,341 @@
+// *****************************************************************************
+//
+// Project: PFPP.
+//
+// Module: LCD render backend.
+//
+// *****************************************************************************
+
+//! \file
+//! \brief Host render backend of the LS013B7 driver.
+//! Screens are drawn through the driver, and its SPI stream decoded back into
+//! the panel image. Each frame is written as PBM, with its SPI usage.
+//! Frames can be compared against golden images of a previous run.
+//! The gui_* frames go through the graphics library and the GUI screens,
+//! like the firmware. They are compared only on request: their golden images
+//! are to be rendered with the TivaWare graphics library, not committed yet.
+//! \ingroup app
+
+// *****************************************************************************
+//
+//        Copyright (c) 2023, Martin Garon, All rights reserved.
+//
+// This source code is licensed under the GPL-3.0-style license found in the
+// LICENSE file in the root directory of this source tree.
+//
+// *****************************************************************************
+
+// *****************************************************************************
+//                              INCLUDE FILES
+// *****************************************************************************
+
+// Firmware Libraries.
+#include "drivers/inc/LS013B7.h"
+#include "utils/gui/Screen.h"
+
+// This project.
+#include "SharpDecoder.h"
+
+// Standard Libraries.
+#include <array>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <string_view>
+#include <vector>
+
+// *****************************************************************************
+//                      DEFINED CONSTANTS AND MACROS
+// *****************************************************************************
+
+// *****************************************************************************
+//                         TYPEDEFS AND STRUCTURES
+// *****************************************************************************
+
+struct Scene
+{
+    const char* mName{};
+    void (*mDraw)(tDisplay& aDisplay) noexcept{};
+    bool mIsGrlibDrawn{false};
+};
+
+// *****************************************************************************
+//                            FUNCTION PROTOTYPES
+// *****************************************************************************
+
+static void DrawMenu(tDisplay& aDisplay, int32_t aSelectedIx) noexcept;
+static void DrawIcon(tDisplay& aDisplay, int32_t aX, int32_t aY) noexcept;
+static void DrawGUIText(tDisplay& aDisplay) noexcept;
+[[nodiscard]] static auto IsSameFile(
+    const std::filesystem::path& aPath1,
+    const std::filesystem::path& aPath2
+) noexcept -> bool;
+
+// *****************************************************************************
+//                             GLOBAL VARIABLES
+// *****************************************************************************
+
+static constexpr auto sWidth{128};
+static constexpr auto sHeight{128};
+
+static SharpDecoder sDecoder{sWidth, sHeight};
+
+// Drawing context and screen of the gui_* scenes, as set by the GUI AO.
+static tContext sContext{};
+static Utils::GUI::Screen sScreen{sContext};
+
+// Same layouts as the GUI AO main and config menus.
+static std::array<Utils::GUI::Widget, 4> sMainMenu{
+    {
+        {Utils::GUI::Widget::Kind::Frame, {5, 5, 122, 122}, "Main Menu"},
+        {Utils::GUI::Widget::Kind::Button, {20, 20, 100, 40}, "Hold to Feed"},
+        {Utils::GUI::Widget::Kind::Button, {20, 60, 100, 80}, "Timed Feed"},
+        {Utils::GUI::Widget::Kind::Button, {20, 80, 100, 100}, "Config Menu"}
+    }
+};
+static std::array<Utils::GUI::Widget, 5> sConfigMenu{
+    {
+        {Utils::GUI::Widget::Kind::Frame, {5, 5, 122, 122}, "Config Menu"},
+        {Utils::GUI::Widget::Kind::ListRow, {10, 20, 117, 31}, "Feed Config"},
+        {Utils::GUI::Widget::Kind::ListRow, {10, 34, 117, 45}, "Calendar"},
+        {Utils::GUI::Widget::Kind::ListRow, {10, 48, 117, 59}, "About"},
+        {Utils::GUI::Widget::Kind::ListRow, {10, 62, 117, 73}, "Quit"}
+    }
+};
+
+static constexpr std::array sScenes{
+    Scene{"cleared", [](tDisplay&) noexcept {}},
+    Scene{"main_menu", [](tDisplay& aDisplay) noexcept {DrawMenu(aDisplay, 0);}},
+    Scene{"main_menu_redrawn", [](tDisplay& aDisplay) noexcept {DrawMenu(aDisplay, 0);}},
+    Scene{"main_menu_next", [](tDisplay& aDisplay) noexcept {DrawMenu(aDisplay, 1);}},
+    Scene{"icons",
+        [](tDisplay& aDisplay) noexcept
+        {
+            for (auto lIx{0}; lIx < 4; ++lIx) {
+                DrawIcon(aDisplay, 20 + 24 * lIx + lIx, 100);
+            }
+        }
+    },
+    Scene{"full_screen",
+        [](tDisplay& aDisplay) noexcept
+        {
+            static constexpr tRectangle sFullScreen{0, 0, sWidth - 1, sHeight - 1};
+            aDisplay.pfnRectFill(aDisplay.pvDisplayData, &sFullScreen, 1);
+        }
+    },
+    Scene{"gui_main_menu",
+        [](tDisplay&) noexcept
+        {
+            sScreen.Show(sMainMenu);
+            sScreen.Select(1, true);
+            static_cast<void>(sScreen.Render());
+        },
+        true
+    },
+    Scene{"gui_main_menu_next",
+        [](tDisplay&) noexcept
+        {
+            // Only the damage of both buttons gets redrawn.
+            sScreen.Select(1, false);
+            sScreen.Select(2, true);
+            static_cast<void>(sScreen.Render());
+        },
+        true
+    },
+    Scene{"gui_config_menu",
+        [](tDisplay&) noexcept
+        {
+            sScreen.Show(sConfigMenu);
+            sScreen.Select(3, true);
+            static_cast<void>(sScreen.Render());
+        },
+        true
+    },
+    Scene{"gui_text", DrawGUIText, true}
+};
+
+// *****************************************************************************
+//                            EXPORTED FUNCTIONS
+// *****************************************************************************
+
+int main(int argc, char* argv[])
+{
+    // render_lcd [-o <output dir>] [-g <golden dir>] [-a]
+    // -a compares the gui_* frames too.
+    std::filesystem::path lOutputDir{"frames"};
+    std::filesystem::path lGoldenDir{};
+    auto lIsGrlibChecked{false};
+    for (auto lArgIx{1}; lArgIx < argc; ++lArgIx) {
+        const std::string_view lOption{argv[lArgIx]};
+        if ((lOption == "-o") && (lArgIx + 1 < argc)) {
+            lOutputDir = argv[++lArgIx];
+        }
+        else if ((lOption == "-g") && (lArgIx + 1 < argc)) {
+            lGoldenDir = argv[++lArgIx];
+        }
+        else if (lOption == "-a") {
+            lIsGrlibChecked = true;
+        }
+    }
+    std::filesystem::create_directories(lOutputDir);
+
+    Drivers::LS013B7DH03 lLCD{
+        [](std::span<const std::byte> aData, std::optional<std::byte> aAddr) noexcept
+        {
+            sDecoder.OnTransaction(aData, aAddr);
+        },
+        []() noexcept {},
+        []() noexcept {}
+    };
+    tDisplay& lDisplay{lLCD};
+    lLCD.Init();
+
+    GrContextInit(&sContext, &lDisplay);
+    GrContextForegroundSet(&sContext, ClrWhite);
+    GrContextBackgroundSet(&sContext, ClrBlack);
+    GrContextFontSet(&sContext, &g_sFontFixed6x8);
+
+    // Without golden images, there is nothing to check against.
+    if (!lGoldenDir.empty() && !std::filesystem::is_directory(lGoldenDir)) {
+        std::printf(
+            "No golden directory '%s': render it with 'make golden' on a known-good tree.\n",
+            lGoldenDir.c_str()
+        );
+        return 1;
+    }
+
+    auto lFailureCount{0};
+    auto lMissingCount{0};
+    std::printf("%-20s %8s %8s %8s %8s\n", "Frame", "txns", "bytes", "lines", "golden");
+    for (const auto& lScene : sScenes) {
+        sDecoder.BeginFrame();
+        lScene.mDraw(lDisplay);
+        lDisplay.pfnFlush(lDisplay.pvDisplayData);
+
+        const auto lPath{lOutputDir / (std::string{lScene.mName} + ".pbm")};
+        const auto lStats{sDecoder.GetFrameStats()};
+        auto lGolden{"-"};
+        if (!sDecoder.WritePBM(lPath) || (lStats.mErrors != 0)) {
+            lGolden = "error";
+            ++lFailureCount;
+        }
+        else if (!lGoldenDir.empty() && (!lScene.mIsGrlibDrawn || lIsGrlibChecked)) {
+            const auto lGoldenPath{lGoldenDir / lPath.filename()};
+            if (!std::filesystem::exists(lGoldenPath)) {
+                lGolden = "missing";
+                ++lMissingCount;
+                ++lFailureCount;
+            }
+            else {
+                const auto lIsSame{IsSameFile(lPath, lGoldenPath)};
+                lGolden = lIsSame ? "same" : "DIFF";
+                lFailureCount += !lIsSame;
+            }
+        }
+
+        std::printf(
+            "%-20s %8u %8u %8u %8s\n",
+            lScene.mName, lStats.mTransactions, lStats.mBytes, lStats.mLinesWritten, lGolden
+        );
+    }
+
+    if (lMissingCount != 0) {
+        std::printf(
+            "%d golden image(s) missing from '%s': render them with 'make golden' against the TivaWare graphics library.\n",
+            lMissingCount, lGoldenDir.c_str()
+        );
+    }
+
+    return (lFailureCount == 0) ? 0 : 1;
+}
+
+// *****************************************************************************
+//                              LOCAL FUNCTIONS
+// *****************************************************************************
+
+static void DrawMenu(tDisplay& aDisplay, const int32_t aSelectedIx) noexcept
+{
+    // Title bar, frame, and one entry per line: the selected one highlighted.
+    static constexpr tRectangle sTitleBar{0, 0, sWidth - 1, 11};
+    static constexpr tRectangle sFrame{2, 14, sWidth - 3, sHeight - 3};
+    static constexpr tRectangle sInner{3, 15, sWidth - 4, sHeight - 4};
+    static constexpr auto sEntryCount{4};
+    static constexpr auto sEntryHeight{12};
+
+    aDisplay.pfnRectFill(aDisplay.pvDisplayData, &sTitleBar, 1);
+    aDisplay.pfnRectFill(aDisplay.pvDisplayData, &sFrame, 1);
+    aDisplay.pfnRectFill(aDisplay.pvDisplayData, &sInner, 0);
+
+    for (auto lEntryIx{0}; lEntryIx < sEntryCount; ++lEntryIx) {
+        const auto lY{18 + lEntryIx * sEntryHeight};
+        const auto lColor{(lEntryIx == aSelectedIx) ? 1U : 0U};
+        const tRectangle lEntry{
+            6, static_cast<int16_t>(lY),
+            sWidth - 7, static_cast<int16_t>(lY + sEntryHeight - 2)
+        };
+        aDisplay.pfnRectFill(aDisplay.pvDisplayData, &lEntry, lColor);
+        aDisplay.pfnLineDrawH(aDisplay.pvDisplayData, 10, 60, lY + 5, !lColor);
+    }
+}
+
+
+static void DrawIcon(tDisplay& aDisplay, const int32_t aX, const int32_t aY) noexcept
+{
+    // 8x8 1 BPP image, palette of translated colors.
+    static constexpr std::array<uint8_t, 8> sIcon{
+        0x3c, 0x42, 0x81, 0xa5, 0x81, 0x99, 0x42, 0x3c
+    };
+    static constexpr std::array<uint32_t, 2> sPalette{0, 1};
+
+    for (auto lRowIx{0}; lRowIx < static_cast<int32_t>(sIcon.size()); ++lRowIx) {
+        aDisplay.pfnPixelDrawMultiple(
+            aDisplay.pvDisplayData,
+            aX, aY + lRowIx, 0, 8, 1,
+            &sIcon[lRowIx], reinterpret_cast<const uint8_t*>(sPalette.data())
+        );
+    }
+}
+
+
+static void DrawGUIText(tDisplay&) noexcept
+{
+    // Opaque and transparent strings, over a filled area, and clipped by the display edges.
+    static constexpr tRectangle sFullScreen{0, 0, sWidth - 1, sHeight - 1};
+    static constexpr tRectangle sBox{0, 40, sWidth - 1, 63};
+    GrContextClipRegionSet(&sContext, &sFullScreen);
+    GrContextForegroundSet(&sContext, ClrBlack);
+    GrRectFill(&sContext, &sFullScreen);
+    GrContextForegroundSet(&sContext, ClrWhite);
+
+    GrStringDraw(&sContext, "Next feed 07:30", -1, 2, 2, true);
+    GrStringDrawCentered(&sContext, "Centered", -1, sWidth / 2, 24, false);
+    GrRectFill(&sContext, &sBox);
+    GrContextForegroundSet(&sContext, ClrBlack);
+    GrStringDraw(&sContext, "Inverted text", -1, 4, 44, false);
+    GrContextForegroundSet(&sContext, ClrWhite);
+    GrStringDraw(&sContext, "Clipped at the right edge", -1, 60, 80, true);
+    GrStringDraw(&sContext, "Bottom", -1, -3, sHeight - 5, true);
+}
+
+
+static auto IsSameFile(
+    const std::filesystem::path& aPath1,
+    const std::filesystem::path& aPath2
+) noexcept -> bool
+{
+    std::ifstream lFile1{aPath1, std::ios::binary};
+    std::ifstream lFile2{aPath2, std::ios::binary};
+    if (!lFile1 || !lFile2) {
+        return false;
+    }
+
+    const std::vector<char> lContent1{std::istreambuf_iterator<char>{lFile1}, {}};
+    const std::vector<char> lContent2{std::istreambuf_iterator<char>{lFile2}, {}};
+    return lContent1 == lContent2;
+}
+
+// *****************************************************************************
+//                                END OF FILE
+// *****************************************************************************
@@ -0,0 +1,159 @@
+// *****************************************************************************
+//
+// Project: PFPP.
+//
+// Module: LCD render backend.
+//
+// *****************************************************************************
+
+//! \file
+//! \brief Sharp memory LCD protocol decoder.
+//! \ingroup app
+
+// *****************************************************************************
+//
+//        Copyright (c) 2023, Martin Garon, All rights reserved.
+//
+// This source code is licensed under the GPL-3.0-style license found in the
+// LICENSE file in the root directory of this source tree.
+//
+// *****************************************************************************
+
+// *****************************************************************************
+//                              INCLUDE FILES
+// *****************************************************************************
+
+// This project.
+#include "SharpDecoder.h"
+
+// Firmware Libraries.
+#include "drivers/inc/BitOrder.h"
+
+// Standard Libraries.
+#include <algorithm>
+#include <fstream>
+
+// *****************************************************************************
+//                      DEFINED CONSTANTS AND MACROS
+// *****************************************************************************
+
+// *****************************************************************************
+//                         TYPEDEFS AND STRUCTURES
+// *****************************************************************************
+
+// *****************************************************************************
+//                            FUNCTION PROTOTYPES
+// *****************************************************************************
+
+// Gate line addresses are sent LSB first.
+static constexpr auto BitSwap(const std::byte aByte) noexcept
+{
+    return std::byte(static_cast<uint8_t>(Drivers::BitOrder::ReverseBitsInBytes(std::to_integer<uint32_t>(aByte))));
+}
+
+// *****************************************************************************
+//                             GLOBAL VARIABLES
+// *****************************************************************************
+
+// Mode byte flags.
+static constexpr std::byte sDataUpdateModeFlag{0x1 << 7};
+static constexpr std::byte sAllClrModeFlag{0x1 << 5};
+
+// All clear writes white: set bits.
+static constexpr std::byte sClearedByte{0xff};
+
+// *****************************************************************************
+//                            EXPORTED FUNCTIONS
+// *****************************************************************************
+
+SharpDecoder::SharpDecoder(const int aWidth, const int aHeight) noexcept
+    : mWidth{aWidth}
+    , mHeight{aHeight}
+    , mBytesPerLine{aWidth / 8}
+    , mPanel(static_cast<std::size_t>(mBytesPerLine * aHeight), sClearedByte)
+{
+    // Ctor body.
+}
+
+
+void SharpDecoder::OnTransaction(
+    const std::span<const std::byte> aData,
+    const std::optional<std::byte> aAddr
+) noexcept
+{
+    // The driver sends the mode byte either as address, or as first data byte.
+    std::vector<std::byte> lTransaction{};
+    if (aAddr) {
+        lTransaction.push_back(*aAddr);
+    }
+    lTransaction.insert(lTransaction.end(), aData.begin(), aData.end());
+
+    ++mFrameStats.mTransactions;
+    mFrameStats.mBytes += lTransaction.size();
+    if (lTransaction.empty()) {
+        ++mFrameStats.mErrors;
+        return;
+    }
+
+    const auto lMode{lTransaction.front()};
+    const auto lPayload{std::span{lTransaction}.subspan(1)};
+    if ((lMode & sDataUpdateModeFlag) != std::byte{0}) {
+        DecodeDataUpdate(lPayload);
+    }
+    else if ((lMode & sAllClrModeFlag) != std::byte{0}) {
+        std::fill(mPanel.begin(), mPanel.end(), sClearedByte);
+        mFrameStats.mErrors += (lPayload.size() != 1);
+    }
+    else {
+        // Display mode: a single dummy byte.
+        mFrameStats.mErrors += (lPayload.size() != 1);
+    }
+}
+
+
+auto SharpDecoder::WritePBM(const std::filesystem::path& aPath) const noexcept -> bool
+{
+    std::ofstream lFile{aPath, std::ios::binary};
+    if (!lFile) {
+        return false;
+    }
+
+    lFile << "P4\n" << mWidth << ' ' << mHeight << '\n';
+    for (const auto lByte : mPanel) {
+        lFile.put(static_cast<char>(~lByte));
+    }
+
+    return static_cast<bool>(lFile);
+}
+
+// *****************************************************************************
+//                              LOCAL FUNCTIONS
+// *****************************************************************************
+
+void SharpDecoder::DecodeDataUpdate(const std::span<const std::byte> aPayload) noexcept
+{
+    // Line packets: gate line, data, dummy. The transaction ends with a dummy byte.
+    const auto lPacketSize{static_cast<std::size_t>(mBytesPerLine) + 2};
+    if ((aPayload.size() < lPacketSize + 1) || (((aPayload.size() - 1) % lPacketSize) != 0)) {
+        ++mFrameStats.mErrors;
+        return;
+    }
+
+    for (auto lPacket{aPayload.first(aPayload.size() - 1)};
+        !lPacket.empty();
+        lPacket = lPacket.subspan(lPacketSize)) {
+        const auto lGateLine{std::to_integer<int>(BitSwap(lPacket.front()))};
+        if ((lGateLine < 1) || (lGateLine > mHeight)) {
+            ++mFrameStats.mErrors;
+            continue;
+        }
+
+        const auto lData{lPacket.subspan(1, mBytesPerLine)};
+        std::copy(lData.begin(), lData.end(), mPanel.begin() + (lGateLine - 1) * mBytesPerLine);
+        ++mFrameStats.mLinesWritten;
+    }
+}
+
+// *****************************************************************************
+//                                END OF FILE
+// *****************************************************************************
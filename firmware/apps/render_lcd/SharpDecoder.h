@@ -0,0 +1,98 @@
+#ifndef APPS__SHARPDECODER_H_
+#define APPS__SHARPDECODER_H_
+// *****************************************************************************
+//
+// Project: PFPP.
+//
+// Module: LCD render backend.
+//
+// *****************************************************************************
+
+//! \file
+//! \brief Sharp memory LCD protocol decoder.
+//! \ingroup app
+
+// *****************************************************************************
+//
+//        Copyright (c) 2023, Martin Garon, All rights reserved.
+//
+// This source code is licensed under the GPL-3.0-style license found in the
+// LICENSE file in the root directory of this source tree.
+//
+// *****************************************************************************
+
+// *****************************************************************************
+//                              INCLUDE FILES
+// *****************************************************************************
+
+// Standard Libraries.
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <optional>
+#include <span>
+#include <vector>
+
+// *****************************************************************************
+//                       DEFINED CONSTANTS AND MACROS
+// *****************************************************************************
+
+// *****************************************************************************
+//                         TYPEDEFS AND STRUCTURES
+// *****************************************************************************
+
+//! \brief Rebuilds the panel memory from the SPI transactions sent to it.
+//! Each transaction is what is sent within a CS window.
+class SharpDecoder final
+{
+public:
+    //! \brief SPI usage since the last BeginFrame().
+    struct FrameStats
+    {
+        unsigned int mTransactions{};
+        unsigned int mBytes{};
+        unsigned int mLinesWritten{};
+        unsigned int mErrors{};
+    };
+
+    explicit SharpDecoder(int aWidth, int aHeight) noexcept;
+
+    //! \brief Decodes a transaction: mode byte, then its payload.
+    void OnTransaction(std::span<const std::byte> aData, std::optional<std::byte> aAddr) noexcept;
+
+    void BeginFrame() noexcept {mFrameStats = {};}
+    [[nodiscard]] auto GetFrameStats() const noexcept -> FrameStats {return mFrameStats;}
+
+    //! \brief The panel memory, in wire format: a cleared bit is a dark pixel.
+    [[nodiscard]] auto GetPanel() const noexcept -> std::span<const std::byte> {return mPanel;}
+
+    //! \brief Writes the panel as a binary PBM image, a set bit being a dark pixel.
+    [[nodiscard]] auto WritePBM(const std::filesystem::path& aPath) const noexcept -> bool;
+
+private:
+    void DecodeDataUpdate(std::span<const std::byte> aPayload) noexcept;
+
+    int mWidth;
+    int mHeight;
+    int mBytesPerLine;
+    std::vector<std::byte> mPanel;
+
+    FrameStats mFrameStats{};
+};
+
+// *****************************************************************************
+//                            EXPORTED VARIABLES
+// *****************************************************************************
+
+// *****************************************************************************
+//                                 EXTERNS
+// *****************************************************************************
+
+// *****************************************************************************
+//                            EXPORTED FUNCTIONS
+// *****************************************************************************
+
+// *****************************************************************************
+//                                END OF FILE
+// *****************************************************************************
+#endif // APPS__SHARPDECODER_H_
@@ -0,0 +1,334 @@
+// *****************************************************************************
+//
+// Project: PFPP.
+//
+// Module: RLE image encoder.
+//
+// *****************************************************************************
+
+//! \file
+//! \brief Host encoder of 1 BPP art into run-length encoded image assets.
+//! Reads a PBM image, plain (P1) or raw (P4), and writes a header defining
+//! the Drivers::RLEImage to draw with LS013B7::RLEImageDraw().
+//! The stream is decoded back and checked against the image before writing.
+//! \ingroup app
+
+// *****************************************************************************
+//
+//        Copyright (c) 2023, Martin Garon, All rights reserved.
+//
+// This source code is licensed under the GPL-3.0-style license found in the
+// LICENSE file in the root directory of this source tree.
+//
+// *****************************************************************************
+
+// *****************************************************************************
+//                              INCLUDE FILES
+// *****************************************************************************
+
+// Firmware Libraries.
+#include "drivers/inc/RLEImage.h"
+
+// Standard Libraries.
+#include <array>
+#include <cctype>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// *****************************************************************************
+//                      DEFINED CONSTANTS AND MACROS
+// *****************************************************************************
+
+// *****************************************************************************
+//                         TYPEDEFS AND STRUCTURES
+// *****************************************************************************
+
+//! \brief Image as one byte per pixel, non-zero for set (black) pixels.
+struct Bitmap
+{
+    int mWidth{};
+    int mHeight{};
+    std::vector<uint8_t> mPixels{};
+};
+
+// *****************************************************************************
+//                            FUNCTION PROTOTYPES
+// *****************************************************************************
+
+[[nodiscard]] static auto ReadPBM(const std::filesystem::path& aPath) noexcept -> std::optional<Bitmap>;
+[[nodiscard]] static auto Encode(const Bitmap& aBitmap) noexcept -> std::vector<uint8_t>;
+[[nodiscard]] static auto Decode(const Drivers::RLEImage& aImage) noexcept -> std::vector<uint8_t>;
+static void PutRun(std::vector<uint8_t>& aStream, int aRun) noexcept;
+static void WriteHeader(
+    std::FILE* aFile,
+    std::string_view aName,
+    const std::filesystem::path& aSource,
+    const Bitmap& aBitmap,
+    const std::vector<uint8_t>& aStream
+) noexcept;
+
+// *****************************************************************************
+//                             GLOBAL VARIABLES
+// *****************************************************************************
+
+// *****************************************************************************
+//                            EXPORTED FUNCTIONS
+// *****************************************************************************
+
+int main(int argc, char* argv[])
+{
+    // rle_encode <image.pbm> <name> [-i] [-o <header>]
+    if (argc < 3) {
+        std::fprintf(stderr, "Usage: %s <image.pbm> <name> [-i] [-o <header>]\n", argv[0]);
+        std::fprintf(stderr, "  -i: inverts the image, white pixels being set.\n");
+        return 1;
+    }
+
+    const std::filesystem::path lInputPath{argv[1]};
+    const std::string_view lName{argv[2]};
+    auto lIsInverted{false};
+    std::filesystem::path lOutputPath{};
+    for (auto lArgIx{3}; lArgIx < argc; ++lArgIx) {
+        const std::string_view lOption{argv[lArgIx]};
+        if (lOption == "-i") {
+            lIsInverted = true;
+        }
+        else if ((lOption == "-o") && (lArgIx + 1 < argc)) {
+            lOutputPath = argv[++lArgIx];
+        }
+    }
+
+    auto lBitmap{ReadPBM(lInputPath)};
+    if (!lBitmap) {
+        std::fprintf(stderr, "%s: not a PBM image.\n", argv[1]);
+        return 1;
+    }
+    if (lIsInverted) {
+        for (auto& lPixel : lBitmap->mPixels) {
+            lPixel = !lPixel;
+        }
+    }
+
+    const auto lStream{Encode(*lBitmap)};
+    const Drivers::RLEImage lImage{
+        static_cast<uint16_t>(lBitmap->mWidth),
+        static_cast<uint16_t>(lBitmap->mHeight),
+        lStream
+    };
+    if (Decode(lImage) != lBitmap->mPixels) {
+        std::fprintf(stderr, "%s: decoded image differs.\n", argv[1]);
+        return 1;
+    }
+
+    auto lFile{stdout};
+    if (!lOutputPath.empty()) {
+        lFile = std::fopen(lOutputPath.c_str(), "w");
+        if (lFile == nullptr) {
+            std::fprintf(stderr, "%s: can't open.\n", lOutputPath.c_str());
+            return 1;
+        }
+    }
+    WriteHeader(lFile, lName, lInputPath, *lBitmap, lStream);
+    if (lFile != stdout) {
+        std::fclose(lFile);
+    }
+
+    // Compared to a 1 BPP grlib image: 6 bytes of header, rows padded to bytes.
+    const auto lRawSize{6 + ((lBitmap->mWidth + 7) / 8) * lBitmap->mHeight};
+    std::fprintf(
+        stderr,
+        "%.*s: %dx%d, %zu bytes, %d as 1 BPP (%.1f%%).\n",
+        static_cast<int>(lName.size()), lName.data(),
+        lBitmap->mWidth, lBitmap->mHeight,
+        lStream.size(), lRawSize,
+        100.0 * static_cast<double>(lStream.size()) / lRawSize
+    );
+
+    return 0;
+}
+
+// *****************************************************************************
+//                              LOCAL FUNCTIONS
+// *****************************************************************************
+
+static auto ReadPBM(const std::filesystem::path& aPath) noexcept -> std::optional<Bitmap>
+{
+    std::ifstream lFile{aPath, std::ios::binary};
+    if (!lFile) {
+        return std::nullopt;
+    }
+    const std::vector<uint8_t> lContent{std::istreambuf_iterator<char>{lFile}, {}};
+
+    // Header fields are separated by whitespace, with comments up to the end of line.
+    std::size_t lIx{0};
+    const auto lSkipSpaces{
+        [&]() noexcept
+        {
+            while (lIx < lContent.size()) {
+                if (lContent[lIx] == '#') {
+                    while ((lIx < lContent.size()) && (lContent[lIx] != '\n')) {
+                        ++lIx;
+                    }
+                }
+                else if (std::isspace(lContent[lIx])) {
+                    ++lIx;
+                }
+                else {
+                    break;
+                }
+            }
+        }
+    };
+    const auto lReadNumber{
+        [&]() noexcept
+        {
+            lSkipSpaces();
+            auto lNumber{0};
+            while ((lIx < lContent.size()) && std::isdigit(lContent[lIx])) {
+                lNumber = lNumber * 10 + (lContent[lIx] - '0');
+                ++lIx;
+            }
+            return lNumber;
+        }
+    };
+
+    if ((lContent.size() < 2) || (lContent[0] != 'P') || ((lContent[1] != '1') && (lContent[1] != '4'))) {
+        return std::nullopt;
+    }
+    const auto lIsRaw{lContent[1] == '4'};
+    lIx = 2;
+
+    Bitmap lBitmap{};
+    lBitmap.mWidth = lReadNumber();
+    lBitmap.mHeight = lReadNumber();
+    if ((lBitmap.mWidth <= 0) || (lBitmap.mHeight <= 0)
+        || (lBitmap.mWidth > UINT16_MAX) || (lBitmap.mHeight > UINT16_MAX)) {
+        return std::nullopt;
+    }
+    lBitmap.mPixels.resize(static_cast<std::size_t>(lBitmap.mWidth) * lBitmap.mHeight);
+
+    if (lIsRaw) {
+        // A single whitespace, then rows packed MSB first, padded to bytes.
+        ++lIx;
+        const auto lBytesPerRow{static_cast<std::size_t>((lBitmap.mWidth + 7) / 8)};
+        if (lContent.size() < lIx + lBytesPerRow * lBitmap.mHeight) {
+            return std::nullopt;
+        }
+        for (auto lY{0}; lY < lBitmap.mHeight; ++lY) {
+            for (auto lX{0}; lX < lBitmap.mWidth; ++lX) {
+                const auto lByte{lContent[lIx + lY * lBytesPerRow + lX / 8]};
+                lBitmap.mPixels[lY * lBitmap.mWidth + lX] = (lByte >> (7 - (lX % 8))) & 0x1;
+            }
+        }
+        return lBitmap;
+    }
+
+    for (auto& lPixel : lBitmap.mPixels) {
+        lSkipSpaces();
+        if ((lIx >= lContent.size()) || ((lContent[lIx] != '0') && (lContent[lIx] != '1'))) {
+            return std::nullopt;
+        }
+        lPixel = lContent[lIx] - '0';
+        ++lIx;
+    }
+
+    return lBitmap;
+}
+
+
+static auto Encode(const Bitmap& aBitmap) noexcept -> std::vector<uint8_t>
+{
+    // Each row starts with a run of clear pixels, possibly empty.
+    std::vector<uint8_t> lStream{};
+    for (auto lY{0}; lY < aBitmap.mHeight; ++lY) {
+        const auto lRow{&aBitmap.mPixels[lY * aBitmap.mWidth]};
+        uint8_t lRunValue{0};
+        auto lRun{0};
+        for (auto lX{0}; lX < aBitmap.mWidth; ++lX) {
+            if (lRow[lX] != lRunValue) {
+                PutRun(lStream, lRun);
+                lRunValue = lRow[lX];
+                lRun = 0;
+            }
+            ++lRun;
+        }
+        PutRun(lStream, lRun);
+    }
+
+    return lStream;
+}
+
+
+static auto Decode(const Drivers::RLEImage& aImage) noexcept -> std::vector<uint8_t>
+{
+    std::vector<uint8_t> lPixels{};
+    auto lData{aImage.mData};
+    for (auto lY{0}; lY < aImage.mHeight; ++lY) {
+        auto lPixelCount{0};
+        for (uint8_t lValue{0}; (lPixelCount < aImage.mWidth) && !lData.empty(); lValue = !lValue) {
+            const auto lRun{Drivers::RLEImage::ReadRun(lData)};
+            lPixels.insert(lPixels.end(), lRun, lValue);
+            lPixelCount += lRun;
+        }
+    }
+
+    return lPixels;
+}
+
+
+static void PutRun(std::vector<uint8_t>& aStream, int aRun) noexcept
+{
+    // Runs too long for 2 bytes are split by empty runs of the other value.
+    while (aRun > Drivers::RLEImage::sMaxRunLength) {
+        PutRun(aStream, Drivers::RLEImage::sMaxRunLength);
+        PutRun(aStream, 0);
+        aRun -= Drivers::RLEImage::sMaxRunLength;
+    }
+
+    std::array<uint8_t, 2> lRun{};
+    const auto lSize{Drivers::RLEImage::WriteRun(lRun, aRun)};
+    aStream.insert(aStream.end(), lRun.begin(), lRun.begin() + lSize);
+}
+
+
+static void WriteHeader(
+    std::FILE* const aFile,
+    const std::string_view aName,
+    const std::filesystem::path& aSource,
+    const Bitmap& aBitmap,
+    const std::vector<uint8_t>& aStream
+) noexcept
+{
+    std::string lGuard{"ASSETS__"};
+    for (const auto lChar : aName) {
+        lGuard += static_cast<char>(std::toupper(static_cast<unsigned char>(lChar)));
+    }
+    lGuard += "_H_";
+    const auto lName{static_cast<int>(aName.size())};
+
+    std::fprintf(aFile, "#ifndef %s\n#define %s\n", lGuard.c_str(), lGuard.c_str());
+    std::fprintf(aFile, "// Generated by rle_encode from %s: do not edit.\n\n", aSource.filename().c_str());
+    std::fprintf(aFile, "#include \"drivers/inc/RLEImage.h\"\n\n#include <array>\n#include <cstdint>\n\n");
+    std::fprintf(aFile, "namespace Assets\n{\n\n");
+    std::fprintf(aFile, "inline constexpr std::array<uint8_t, %zu> s%.*sData{", aStream.size(), lName, aName.data());
+    for (std::size_t lIx{0}; lIx < aStream.size(); ++lIx) {
+        std::fprintf(aFile, "%s0x%02x%s", (lIx % 12) ? " " : "\n    ", aStream[lIx], (lIx + 1 < aStream.size()) ? "," : "");
+    }
+    std::fprintf(aFile, "\n};\n\n");
+    std::fprintf(
+        aFile,
+        "inline constexpr Drivers::RLEImage s%.*s{%d, %d, s%.*sData};\n\n",
+        lName, aName.data(), aBitmap.mWidth, aBitmap.mHeight, lName, aName.data()
+    );
+    std::fprintf(aFile, "} // namespace Assets\n\n#endif // %s\n", lGuard.c_str());
+}
+
+// *****************************************************************************
+//                                END OF FILE
+// *****************************************************************************
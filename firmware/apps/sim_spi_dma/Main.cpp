@@ -0,0 +1,876 @@
+// *****************************************************************************
+//
+// Project: PFPP.
+//
+// Module: SPI DMA simulation.
+//
+// *****************************************************************************
+
+//! \file
+//! \brief Host simulation of the SPI uDMA transfers, as the AOs request them.
+//! The AOs are stood in for by their event queues: the completion callbacks
+//! post to them, as the firmware ones do, and the CPU sleeps until an event comes.
+//! Checks the LCD flush moved by DMA sends what the sync flush does, with a single
+//! completion event per flush, and that a read stores the slave replies before
+//! its completion event. Also shows a read refused while a flush holds the bus,
+//! and a clear leaving the panel buffer alone until the flush in flight completes.
+//! Then the same, through the SPI bus AO and its transaction queue: the flush goes
+//! line by line, and a read requested meanwhile waits at most one line. A write the
+//! full queue drops is reported failed, and its lines go with the next maintenance tick. Transactions
+//! of equal priority are grouped by slave.
+//! \ingroup app
+
+// *****************************************************************************
+//
+//        Copyright (c) 2023, Martin Garon, All rights reserved.
+//
+// This source code is licensed under the GPL-3.0-style license found in the
+// LICENSE file in the root directory of this source tree.
+//
+// *****************************************************************************
+
+// *****************************************************************************
+//                              INCLUDE FILES
+// *****************************************************************************
+
+// This application.
+#include "SimTimeline.h"
+
+// Firmware Libraries.
+#include "corelink/inc/SPIDMAEngine.h"
+#include "corelink/inc/SPIMasterDev.h"
+#include "drivers/inc/LS013B7.h"
+#include "utils/spi/TransactionQueue.h"
+
+// Standard Libraries.
+#include <algorithm>
+#include <array>
+#include <cstdio>
+#include <deque>
+#include <optional>
+#include <vector>
+
+// *****************************************************************************
+//                      DEFINED CONSTANTS AND MACROS
+// *****************************************************************************
+
+// *****************************************************************************
+//                         TYPEDEFS AND STRUCTURES
+// *****************************************************************************
+
+enum class eSig
+{
+    FlushDone,
+    TimeRead,
+    LCDWrDone,
+    LCDWrFailed
+};
+
+using Transactions = std::vector<std::vector<uint8_t>>;
+
+// *****************************************************************************
+//                            FUNCTION PROTOTYPES
+// *****************************************************************************
+
+[[nodiscard]] static auto RunFlushes() noexcept -> bool;
+[[nodiscard]] static auto RunRead() noexcept -> bool;
+[[nodiscard]] static auto RunBusyBus() noexcept -> bool;
+[[nodiscard]] static auto RunTaskLimits() noexcept -> bool;
+[[nodiscard]] static auto RunRefusedWrs() noexcept -> bool;
+[[nodiscard]] static auto RunClearInFlight() noexcept -> bool;
+[[nodiscard]] static auto RunBusFlush() noexcept -> bool;
+[[nodiscard]] static auto RunDroppedWr() noexcept -> bool;
+[[nodiscard]] static auto RunBusGrouping() noexcept -> bool;
+static void DispatchBus() noexcept;
+static void CompleteBus(const Utils::SPI::Transaction& aTransaction, bool aIsSent) noexcept;
+[[nodiscard]] static auto SplitAsBus(const Transactions& aTransactions) noexcept -> Transactions;
+static void SyncWr(std::span<const std::byte> aData, std::optional<std::byte> aAddr) noexcept;
+[[nodiscard]] static auto StartTimeRead(std::span<std::byte> aTime) noexcept -> bool;
+[[nodiscard]] static auto SleepUntilEvent(const std::deque<eSig>& aQueue) noexcept -> bool;
+[[nodiscard]] static auto GetTransactions(const CoreLink::SPISlaveCfg& aSPICfg) noexcept -> Transactions;
+static void DrawScene(tDisplay& aDisplay, int32_t aSceneIx) noexcept;
+
+// *****************************************************************************
+//                             GLOBAL VARIABLES
+// *****************************************************************************
+
+// As the standalone board: SSI2 at 50 MHz, through its uDMA channels
+// UDMA_CH13_SSI2TX and UDMA_CH12_SSI2RX.
+static constexpr CoreLink::SPIMasterDev sSPIMasterDev{0x4000A000UL, 50000000UL};
+static CoreLink::SPIDMAEngine sSPIDMAEngine{sSPIMasterDev, {13, 12}};
+
+static constexpr auto sLCDHeight{128};
+static constexpr CoreLink::SPISlaveCfg sLCDSPISlaveCfg{.mBitRate{1000000}, .mCSn{{0, 1}}};
+static constexpr CoreLink::SPISlaveCfg sRTCCSPISlaveCfg{.mBitRate{4000000}, .mCSn{{0, 2}}};
+
+// The event queues of the GUI and RTCC AOs.
+static std::deque<eSig> sGUIQueue{};
+static std::deque<eSig> sRTCCQueue{};
+
+static Drivers::LS013B7DH03* sLCD{nullptr};
+static Drivers::LS027B7DH01* sWideLCD{nullptr};
+static Transactions sSyncTransactions{};
+
+// The event queue of the SPI bus AO: the transactions posted, or nullopt for a transfer done.
+// And its transactions, waiting for the bus.
+static std::deque<std::optional<Utils::SPI::Transaction>> sBusQueue{};
+static Utils::SPI::TransactionQueue sBusTransactions{};
+
+// The RTCC registers, read from the address sent first in a CS window.
+static constexpr std::array<uint8_t, 7> sRTCCRegs{0x56, 0x34, 0x12, 0x05, 0x17, 0x10, 0x26};
+static std::size_t sRTCCByteIx{0};
+static std::size_t sRTCCRegIx{0};
+
+// *****************************************************************************
+//                            EXPORTED FUNCTIONS
+// *****************************************************************************
+
+int main()
+{
+    // The SSI interrupt handler, as the firmware one.
+    SimTimeline::Reset([]() noexcept {sSPIDMAEngine.OnInterrupt();});
+    SimTimeline::SetSlave(
+        sRTCCSPISlaveCfg,
+        [](const uint8_t aByte) noexcept -> uint8_t
+        {
+            if (sRTCCByteIx++ == 0) {
+                sRTCCRegIx = aByte & 0x7f;
+                return 0;
+            }
+            return sRTCCRegs[sRTCCRegIx++ % sRTCCRegs.size()];
+        }
+    );
+    sSPIDMAEngine.Init();
+
+    auto lIsValid{RunFlushes()};
+    lIsValid &= RunRead();
+    lIsValid &= RunBusyBus();
+    lIsValid &= RunTaskLimits();
+    lIsValid &= RunRefusedWrs();
+    lIsValid &= RunClearInFlight();
+    lIsValid &= RunBusFlush();
+    lIsValid &= RunDroppedWr();
+    lIsValid &= RunBusGrouping();
+    std::printf("\nSimulation %s.\n", lIsValid ? "valid" : "INVALID");
+
+    return lIsValid ? 0 : 1;
+}
+
+// *****************************************************************************
+//                              LOCAL FUNCTIONS
+// *****************************************************************************
+
+static auto RunFlushes() noexcept -> bool
+{
+    Drivers::LS013B7DH03 lSyncLCD{SyncWr, []() noexcept {}, []() noexcept {}};
+
+    // As the firmware: each transaction completion starts the next one, from the interrupt.
+    static Drivers::LS013B7DH03 sDMALCD{
+        [](std::span<const std::byte>, std::optional<std::byte>) noexcept {},
+        Drivers::LS013B7DH03::AsyncSPI{
+            .mStartWr{
+                [](const std::span<const std::span<const std::byte>> aSegments) noexcept
+                {
+                    return sSPIDMAEngine.Start(sLCDSPISlaveCfg, aSegments, {}, []() noexcept {sLCD->OnSPIWrDone();});
+                }
+            }
+        },
+        []() noexcept {sGUIQueue.push_back(eSig::FlushDone);},
+        []() noexcept {},
+        []() noexcept {}
+    };
+    sLCD = &sDMALCD;
+
+    tDisplay& lSyncDisplay{lSyncLCD};
+    tDisplay& lDMADisplay{sDMALCD};
+    lSyncLCD.Init();
+    sDMALCD.Init();
+    sSyncTransactions.clear();
+
+    std::printf("%-20s %8s %8s %8s %10s\n", "DMA flush", "txns", "bytes", "ISRs", "flush [ms]");
+    static constexpr std::array sSceneNames{"menu", "menu, redrawn", "highlight moved", "full screen"};
+    for (auto lSceneIx{0}; lSceneIx < static_cast<int32_t>(sSceneNames.size()); ++lSceneIx) {
+        DrawScene(lSyncDisplay, lSceneIx);
+        lSyncDisplay.pfnFlush(lSyncDisplay.pvDisplayData);
+
+        // The GUI AO has nothing left to do: the CPU sleeps until the completion event.
+        DrawScene(lDMADisplay, lSceneIx);
+        const auto lStartTime{SimTimeline::GetNow()};
+        const auto lStartStats{SimTimeline::GetStats()};
+        lDMADisplay.pfnFlush(lDMADisplay.pvDisplayData);
+        const auto lIsEventBeforeSleep{!sGUIQueue.empty()};
+        const auto lIsEvent{SleepUntilEvent(sGUIQueue)};
+        const auto lStats{sDMALCD.GetFlushStats()};
+        const auto lISRCount{SimTimeline::GetStats().mInterrupts - lStartStats.mInterrupts};
+
+        // One completion event for a flush sending anything, none otherwise.
+        const auto lIsSent{lStats.mTransactions != 0};
+        if (lIsEventBeforeSleep || (lIsEvent != lIsSent) || (sGUIQueue.size() > 1) || sDMALCD.IsFlushBusy()) {
+            std::printf("%s: flush completion events wrong.\n", sSceneNames[lSceneIx]);
+            return false;
+        }
+        sGUIQueue.clear();
+
+        std::printf(
+            "%-20s %8u %8u %8u %10.3f\n",
+            sSceneNames[lSceneIx], lStats.mTransactions, lStats.mBytes, lISRCount,
+            static_cast<double>(SimTimeline::GetNow() - lStartTime) / 1e6
+        );
+    }
+
+    if (GetTransactions(sLCDSPISlaveCfg) != sSyncTransactions) {
+        std::printf("DMA flush transactions differ from the sync flush ones.\n");
+        return false;
+    }
+
+    return true;
+}
+
+
+static auto RunRead() noexcept -> bool
+{
+    // The RTCC AO reads the time, and goes on on the completion event.
+    std::array<std::byte, sRTCCRegs.size()> lTime{};
+    const auto lStartTime{SimTimeline::GetNow()};
+    if (!StartTimeRead(lTime) || !sRTCCQueue.empty()) {
+        std::printf("Time read not started.\n");
+        return false;
+    }
+
+    if (!SleepUntilEvent(sRTCCQueue) || (sRTCCQueue.size() != 1) || (sRTCCQueue.front() != eSig::TimeRead)) {
+        std::printf("Time read completion events wrong.\n");
+        return false;
+    }
+    sRTCCQueue.clear();
+
+    for (std::size_t lIx{0}; lIx < sRTCCRegs.size(); ++lIx) {
+        if (std::to_integer<uint8_t>(lTime[lIx]) != sRTCCRegs[lIx]) {
+            std::printf("Time read data wrong.\n");
+            return false;
+        }
+    }
+
+    const auto& lTransfer{SimTimeline::GetTransfers().back()};
+    if (lTransfer.mBytes != std::vector<uint8_t>{0x00, 0, 0, 0, 0, 0, 0, 0}) {
+        std::printf("Time read bytes sent wrong.\n");
+        return false;
+    }
+
+    std::printf("\n%-20s %8zu bytes in %.3f ms\n", "Time read", lTransfer.mBytes.size(),
+        static_cast<double>(SimTimeline::GetNow() - lStartTime) / 1e6);
+    return true;
+}
+
+
+static auto RunBusyBus() noexcept -> bool
+{
+    // A time read requested during a flush is refused: the RTCC AO has to
+    // try again later. Here on the flush completion, as the GUI AO gets it.
+    tDisplay& lDisplay{*sLCD};
+    DrawScene(lDisplay, 0);
+    lDisplay.pfnFlush(lDisplay.pvDisplayData);
+    std::array<std::byte, sRTCCRegs.size()> lTime{};
+    const auto lRequestTime{SimTimeline::GetNow()};
+    if (!sLCD->IsFlushBusy() || StartTimeRead(lTime)) {
+        std::printf("Time read not refused during a flush.\n");
+        return false;
+    }
+
+    if (!SleepUntilEvent(sGUIQueue) || !StartTimeRead(lTime) || !SleepUntilEvent(sRTCCQueue)) {
+        std::printf("Time read not done after the flush.\n");
+        return false;
+    }
+    sGUIQueue.clear();
+    sRTCCQueue.clear();
+
+    std::printf("%-20s %8s    after %.3f ms\n", "Time read in flush", "done",
+        static_cast<double>(SimTimeline::GetNow() - lRequestTime) / 1e6);
+    return true;
+}
+
+
+static auto RunTaskLimits() noexcept -> bool
+{
+    // Up to 8 tasks of up to 1024 bytes, in each direction.
+    static std::vector<std::byte> sData(CoreLink::SPIDMAEngine::sMaxTaskCount * CoreLink::SPIDMAEngine::sMaxTaskSize + 1);
+    const std::span<const std::byte> lData{sData};
+    const std::array lTooLarge{lData};
+    const std::array lLargest{lData.first(lData.size() - 1)};
+    std::array<std::span<const std::byte>, CoreLink::SPIDMAEngine::sMaxTaskCount + 1> lTooMany{};
+    lTooMany.fill(lData.first(1));
+
+    const auto lIsValid{
+        !sSPIDMAEngine.Start(sLCDSPISlaveCfg, lTooLarge, {}, nullptr)
+        && !sSPIDMAEngine.Start(sLCDSPISlaveCfg, lTooMany, {}, nullptr)
+        && !sSPIDMAEngine.Start(sLCDSPISlaveCfg, {}, {}, nullptr)
+        && sSPIDMAEngine.Start(sLCDSPISlaveCfg, lLargest, {}, nullptr)
+    };
+    while (SimTimeline::Sleep()) {
+        // Let it complete.
+    }
+    if (!lIsValid || sSPIDMAEngine.IsBusy()) {
+        std::printf("Transfer task limits wrong.\n");
+        return false;
+    }
+
+    return true;
+}
+
+
+static auto RunRefusedWrs() noexcept -> bool
+{
+    // A flush refused by the engine, busy with a time read: the flush is over at once,
+    // reported done, and its lines go with the next maintenance tick. Not with the flush
+    // the completion triggers, nothing being drawn since: the engine is not polled.
+    tDisplay& lDisplay{*sLCD};
+    std::array<std::byte, sRTCCRegs.size()> lTime{};
+    DrawScene(lDisplay, 3);
+    if (!StartTimeRead(lTime)) {
+        std::printf("Time read not started.\n");
+        return false;
+    }
+    lDisplay.pfnFlush(lDisplay.pvDisplayData);
+    const auto lRefusedStats{sLCD->GetFlushStats()};
+    if (sLCD->IsFlushBusy() || (sGUIQueue.size() != 1) || (lRefusedStats.mRefusedWrs != 1) || (lRefusedStats.mTransactions != 0)) {
+        std::printf("Refused flush left busy, or not reported done.\n");
+        return false;
+    }
+    sGUIQueue.clear();
+
+    lDisplay.pfnFlush(lDisplay.pvDisplayData);
+    if (sLCD->IsFlushBusy() || !sGUIQueue.empty()) {
+        std::printf("Refused flush retried at once.\n");
+        return false;
+    }
+
+    static_cast<void>(SleepUntilEvent(sRTCCQueue));
+    sRTCCQueue.clear();
+    sLCD->OnMaintenanceTick();
+    const auto lIsEvent{SleepUntilEvent(sGUIQueue)};
+    sGUIQueue.clear();
+    const auto lResentStats{sLCD->GetFlushStats()};
+    if (!lIsEvent || sLCD->IsFlushBusy() || (lResentStats.mLinesSent != lRefusedStats.mLinesChanged)) {
+        std::printf("Lines of a refused flush not sent by the next maintenance tick.\n");
+        return false;
+    }
+
+    // A refused clear: its command goes with the next flush, ahead of any line.
+    if (!StartTimeRead(lTime)) {
+        std::printf("Time read not started.\n");
+        return false;
+    }
+    sLCD->Clear();
+    if (sLCD->IsFlushBusy() || (sGUIQueue.size() != 1)) {
+        std::printf("Refused clear left busy, or not reported done.\n");
+        return false;
+    }
+    sGUIQueue.clear();
+    static_cast<void>(SleepUntilEvent(sRTCCQueue));
+    sRTCCQueue.clear();
+    const auto lFirstTransferIx{SimTimeline::GetTransfers().size()};
+    DrawScene(lDisplay, 0);
+    lDisplay.pfnFlush(lDisplay.pvDisplayData);
+    static_cast<void>(SleepUntilEvent(sGUIQueue));
+    sGUIQueue.clear();
+    const auto& lTransfers{SimTimeline::GetTransfers()};
+    if ((lTransfers.size() <= lFirstTransferIx) || ((lTransfers[lFirstTransferIx].mBytes.front() & 0xbf) != 0x20)) {
+        std::printf("Refused clear not sent ahead of the next flush.\n");
+        return false;
+    }
+
+    // A 400x240 full screen, 12 kB, takes more tasks than the engine has: refused every time.
+    // Runs cut to what the engine takes get all the lines sent.
+    static constexpr auto sMaxWrSize{(CoreLink::SPIDMAEngine::sMaxTaskCount - 1) * CoreLink::SPIDMAEngine::sMaxTaskSize};
+    static constexpr tRectangle sWideScreen{0, 0, 399, 239};
+    std::printf("\n%-20s %8s %8s %8s %8s\n", "400x240 full screen", "txns", "lines", "refused", "done");
+    for (const auto lMaxWrSize : {std::size_t{0}, sMaxWrSize}) {
+        Drivers::LS027B7DH01 lWideLCD{
+            [](std::span<const std::byte>, std::optional<std::byte>) noexcept {},
+            Drivers::LS027B7DH01::AsyncSPI{
+                .mStartWr{
+                    [](const std::span<const std::span<const std::byte>> aSegments) noexcept
+                    {
+                        return sSPIDMAEngine.Start(sLCDSPISlaveCfg, aSegments, {}, []() noexcept {sWideLCD->OnSPIWrDone();});
+                    }
+                },
+                .mMaxWrSize{lMaxWrSize}
+            },
+            []() noexcept {sGUIQueue.push_back(eSig::FlushDone);},
+            []() noexcept {},
+            []() noexcept {}
+        };
+        sWideLCD = &lWideLCD;
+        tDisplay& lWideDisplay{lWideLCD};
+        lWideDisplay.pfnRectFill(lWideDisplay.pvDisplayData, &sWideScreen, 1);
+        lWideDisplay.pfnFlush(lWideDisplay.pvDisplayData);
+        const auto lIsDone{SleepUntilEvent(sGUIQueue) && (sGUIQueue.size() == 1) && !lWideLCD.IsFlushBusy()};
+        sGUIQueue.clear();
+        const auto lStats{lWideLCD.GetFlushStats()};
+        std::printf(
+            "  %-18s %8u %8u %8u %8s\n",
+            (lMaxWrSize != 0) ? "runs cut" : "whole run",
+            lStats.mTransactions, lStats.mLinesSent, lStats.mRefusedWrs, lIsDone ? "yes" : "NO"
+        );
+
+        const auto lIsSent{(lStats.mLinesSent == 240) && (lStats.mRefusedWrs == 0)};
+        if (!lIsDone || (lIsSent != (lMaxWrSize != 0))) {
+            std::printf("400x240 flush not done, or lines sent wrong.\n");
+            return false;
+        }
+    }
+    sWideLCD = nullptr;
+
+    return true;
+}
+
+
+static auto RunClearInFlight() noexcept -> bool
+{
+    // A clear requested while a flush is in flight: the panel buffer it sends from
+    // is left as is until the clear command starts, after the flush.
+    tDisplay& lDisplay{*sLCD};
+    DrawScene(lDisplay, 3);
+    lDisplay.pfnFlush(lDisplay.pvDisplayData);
+    std::vector<std::vector<std::byte>> lPanelLines{};
+    for (auto lRowIx{0}; lRowIx < sLCDHeight; ++lRowIx) {
+        const auto lLine{sLCD->GetPanelLine(lRowIx)};
+        lPanelLines.emplace_back(lLine.begin(), lLine.end());
+    }
+
+    const auto lFirstTransferIx{SimTimeline::GetTransfers().size()};
+    sLCD->Clear();
+    auto lIsLeftAlone{sLCD->IsFlushBusy() && !sLCD->TakeLineChanged(0)};
+    for (auto lRowIx{0}; lRowIx < sLCDHeight; ++lRowIx) {
+        lIsLeftAlone &= std::ranges::equal(sLCD->GetPanelLine(lRowIx), lPanelLines[lRowIx]);
+    }
+    if (!lIsLeftAlone) {
+        std::printf("Clear changed the panel buffer of the flush in flight.\n");
+        return false;
+    }
+
+    const auto lIsEvent{SleepUntilEvent(sGUIQueue) && (sGUIQueue.size() == 1)};
+    sGUIQueue.clear();
+    const auto& lTransfers{SimTimeline::GetTransfers()};
+    auto lIsCleared{
+        lIsEvent && !sLCD->IsFlushBusy() && sLCD->TakeLineChanged(0)
+            && (lTransfers.size() > lFirstTransferIx) && ((lTransfers.back().mBytes.front() & 0xbf) == 0x20)
+    };
+    for (auto lRowIx{0}; lRowIx < sLCDHeight; ++lRowIx) {
+        lIsCleared &= std::ranges::all_of(
+            sLCD->GetPanelLine(lRowIx), [](const std::byte aByte) noexcept {return aByte == std::byte{0xff};}
+        );
+    }
+    if (!lIsCleared) {
+        std::printf("Clear not sent after the flush in flight, or panel buffer not cleared.\n");
+        return false;
+    }
+
+    return true;
+}
+
+
+static auto RunBusFlush() noexcept -> bool
+{
+    // As the firmware: the LCD writes are posted to the SPI bus AO, split line by line.
+    // Their completion comes back to the GUI AO, which starts the next one.
+    Drivers::LS013B7DH03 lSyncLCD{SyncWr, []() noexcept {}, []() noexcept {}};
+    static Drivers::LS013B7DH03 sBusLCD{
+        [](std::span<const std::byte>, std::optional<std::byte>) noexcept {},
+        Drivers::LS013B7DH03::AsyncSPI{
+            .mStartWr{
+                [](const std::span<const std::span<const std::byte>> aSegments) noexcept
+                {
+                    Utils::SPI::Transaction lTransaction{
+                        .mSPICfg{&sLCDSPISlaveCfg},
+                        .mSplitSize{Drivers::LS013B7DH03::sTxSplitSize},
+                        .mSplitTail{Drivers::LS013B7DH03::sTxSplitTail}
+                    };
+                    std::copy(aSegments.begin(), aSegments.end(), lTransaction.mTxSegments.begin());
+                    sBusQueue.push_back(lTransaction);
+                    return true;
+                }
+            }
+        },
+        []() noexcept {sGUIQueue.push_back(eSig::FlushDone);},
+        []() noexcept {},
+        []() noexcept {}
+    };
+
+    tDisplay& lSyncDisplay{lSyncLCD};
+    tDisplay& lBusDisplay{sBusLCD};
+    lSyncLCD.Init();
+    sBusLCD.Init();
+    sSyncTransactions.clear();
+    DrawScene(lSyncDisplay, 3);
+    lSyncDisplay.pfnFlush(lSyncDisplay.pvDisplayData);
+
+    // The time read is requested 5 ms in, right after a line started: the worst case.
+    static constexpr uint64_t sRequestDelay{5000000};
+    static constexpr std::array sAddr{std::byte{0x00}};
+    std::array<std::byte, sRTCCRegs.size()> lTime{};
+    std::optional<uint64_t> lRequestTime{};
+    std::optional<uint64_t> lReadDuration{};
+    std::optional<uint64_t> lFlushDuration{};
+
+    sBusTransactions = {};
+    const auto lFirstTransferIx{SimTimeline::GetTransfers().size()};
+    const auto lStartTime{SimTimeline::GetNow()};
+    const auto lStartStats{SimTimeline::GetStats()};
+    DrawScene(lBusDisplay, 3);
+    lBusDisplay.pfnFlush(lBusDisplay.pvDisplayData);
+    do {
+        // The AOs run until they have nothing left to do.
+        while (!sBusQueue.empty() || !sGUIQueue.empty() || !sRTCCQueue.empty()) {
+            DispatchBus();
+            for (; !sGUIQueue.empty(); sGUIQueue.pop_front()) {
+                if (sGUIQueue.front() == eSig::LCDWrDone) {
+                    sBusLCD.OnSPIWrDone();
+                }
+                else if (sGUIQueue.front() == eSig::LCDWrFailed) {
+                    sBusLCD.OnSPIWrFailed();
+                }
+                else {
+                    lFlushDuration = SimTimeline::GetNow() - lStartTime;
+                }
+            }
+            for (; !sRTCCQueue.empty(); sRTCCQueue.pop_front()) {
+                lReadDuration = SimTimeline::GetNow() - *lRequestTime;
+            }
+        }
+
+        if (!lRequestTime && ((SimTimeline::GetNow() - lStartTime) >= sRequestDelay)) {
+            sRTCCByteIx = 0;
+            sBusQueue.push_back(
+                Utils::SPI::Transaction{
+                    .mSPICfg{&sRTCCSPISlaveCfg},
+                    .mTxSegments{std::span<const std::byte>{sAddr}},
+                    .mRxData{lTime},
+                    .mPriority{1}
+                }
+            );
+            lRequestTime = SimTimeline::GetNow();
+            DispatchBus();
+        }
+    } while (SimTimeline::Sleep());
+
+    if (!lFlushDuration || !lReadDuration || sBusLCD.IsFlushBusy()) {
+        std::printf("Bus flush or time read not done.\n");
+        return false;
+    }
+
+    for (std::size_t lIx{0}; lIx < sRTCCRegs.size(); ++lIx) {
+        if (std::to_integer<uint8_t>(lTime[lIx]) != sRTCCRegs[lIx]) {
+            std::printf("Time read in bus flush data wrong.\n");
+            return false;
+        }
+    }
+
+    const auto lExpected{SplitAsBus(sSyncTransactions)};
+    Transactions lPieces{};
+    std::size_t lByteCount{0};
+    const auto& lTransfers{SimTimeline::GetTransfers()};
+    for (auto lIx{lFirstTransferIx}; lIx < lTransfers.size(); ++lIx) {
+        if (lTransfers[lIx].mSPICfg == &sLCDSPISlaveCfg) {
+            lPieces.push_back(lTransfers[lIx].mBytes);
+            lByteCount += lTransfers[lIx].mBytes.size();
+        }
+    }
+    if (lPieces != lExpected) {
+        std::printf("Bus flush pieces differ from the sync flush transactions.\n");
+        return false;
+    }
+
+    // At most a line in flight ahead of the read.
+    static constexpr auto sSplitSize{Drivers::LS013B7DH03::sTxSplitSize};
+    static constexpr auto sSplitTail{Drivers::LS013B7DH03::sTxSplitTail};
+    static constexpr auto sLineDuration{(1 + sSplitSize + sSplitTail) * 8 * 1000000000ULL / sLCDSPISlaveCfg.mBitRate};
+    static constexpr auto sReadDuration{(1 + sRTCCRegs.size()) * 8 * 1000000000ULL / sRTCCSPISlaveCfg.mBitRate};
+    const auto lStats{sBusTransactions.GetStats()};
+    if ((*lReadDuration > (sLineDuration + sReadDuration)) || (lStats.mPreemptions != 1) || (lStats.mSPICfgChanges != 3)) {
+        std::printf("Time read in bus flush not run ahead of the lines.\n");
+        return false;
+    }
+
+    std::printf("\n%-20s %8s %8s %8s %10s\n", "Bus flush", "pieces", "bytes", "ISRs", "flush [ms]");
+    std::printf(
+        "%-20s %8zu %8zu %8u %10.3f\n",
+        "full screen", lPieces.size(), lByteCount, SimTimeline::GetStats().mInterrupts - lStartStats.mInterrupts,
+        static_cast<double>(*lFlushDuration) / 1e6
+    );
+    std::printf("%-20s %8s    after %.3f ms\n", "Time read in flush", "done",
+        static_cast<double>(*lReadDuration) / 1e6);
+    return true;
+}
+
+
+static auto RunDroppedWr() noexcept -> bool
+{
+    // The bus queue is full of RTCC writes as the flush starts: its first write is dropped,
+    // reported failed, and the flush is over. The flush the GUI starts on its completion
+    // leaves the bus alone, nothing being drawn since. The next maintenance tick comes with
+    // the bus having moved on: the lines of the dropped write are sent then, with the others.
+    Drivers::LS013B7DH03 lSyncLCD{SyncWr, []() noexcept {}, []() noexcept {}};
+    static Drivers::LS013B7DH03 sBusLCD{
+        [](std::span<const std::byte>, std::optional<std::byte>) noexcept {},
+        Drivers::LS013B7DH03::AsyncSPI{
+            .mStartWr{
+                [](const std::span<const std::span<const std::byte>> aSegments) noexcept
+                {
+                    Utils::SPI::Transaction lTransaction{
+                        .mSPICfg{&sLCDSPISlaveCfg},
+                        .mSplitSize{Drivers::LS013B7DH03::sTxSplitSize},
+                        .mSplitTail{Drivers::LS013B7DH03::sTxSplitTail}
+                    };
+                    std::copy(aSegments.begin(), aSegments.end(), lTransaction.mTxSegments.begin());
+                    sBusQueue.push_back(lTransaction);
+                    return true;
+                }
+            }
+        },
+        []() noexcept {sGUIQueue.push_back(eSig::FlushDone);},
+        []() noexcept {},
+        []() noexcept {}
+    };
+
+    tDisplay& lSyncDisplay{lSyncLCD};
+    tDisplay& lBusDisplay{sBusLCD};
+    lSyncLCD.Init();
+    sBusLCD.Init();
+    sSyncTransactions.clear();
+    DrawScene(lSyncDisplay, 3);
+    lSyncDisplay.pfnFlush(lSyncDisplay.pvDisplayData);
+
+    static constexpr std::array sAddr{std::byte{0x00}};
+    sBusTransactions = {};
+    for (std::size_t lIx{0}; lIx < Utils::SPI::TransactionQueue::sCapacity; ++lIx) {
+        sBusQueue.push_back(Utils::SPI::Transaction{.mSPICfg{&sRTCCSPISlaveCfg}, .mTxSegments{std::span<const std::byte>{sAddr}}});
+    }
+
+    const auto lFirstTransferIx{SimTimeline::GetTransfers().size()};
+    unsigned int lFailedCount{0};
+    bool lIsRetriedAtOnce{false};
+    bool lIsTickDue{false};
+    DrawScene(lBusDisplay, 3);
+    lBusDisplay.pfnFlush(lBusDisplay.pvDisplayData);
+    do {
+        if (lIsTickDue) {
+            lIsTickDue = false;
+            sBusLCD.OnMaintenanceTick();
+        }
+
+        // A retry at once would bounce between the AOs for as long as the bus drops it.
+        while ((!sBusQueue.empty() || !sGUIQueue.empty()) && !lIsRetriedAtOnce) {
+            DispatchBus();
+            for (; !sGUIQueue.empty(); sGUIQueue.pop_front()) {
+                if (sGUIQueue.front() == eSig::LCDWrDone) {
+                    sBusLCD.OnSPIWrDone();
+                }
+                else if (sGUIQueue.front() == eSig::LCDWrFailed) {
+                    ++lFailedCount;
+                    lIsTickDue = true;
+                    sBusLCD.OnSPIWrFailed();
+                }
+                else {
+                    lBusDisplay.pfnFlush(lBusDisplay.pvDisplayData);
+                    lIsRetriedAtOnce |= !sBusQueue.empty();
+                }
+            }
+        }
+        sRTCCQueue.clear();
+    } while (SimTimeline::Sleep() || lIsTickDue);
+
+    Transactions lPieces{};
+    const auto& lTransfers{SimTimeline::GetTransfers()};
+    for (auto lIx{lFirstTransferIx}; lIx < lTransfers.size(); ++lIx) {
+        if (lTransfers[lIx].mSPICfg == &sLCDSPISlaveCfg) {
+            lPieces.push_back(lTransfers[lIx].mBytes);
+        }
+    }
+    if (lIsRetriedAtOnce) {
+        std::printf("Dropped write retried at once.\n");
+        return false;
+    }
+    if ((lFailedCount == 0) || sBusLCD.IsFlushBusy() || (lPieces != SplitAsBus(sSyncTransactions))) {
+        std::printf("Lines of a dropped write not sent by the next maintenance tick.\n");
+        return false;
+    }
+
+    std::printf("%-20s %8u    writes dropped, their lines sent by the next tick\n", "Queue full", lFailedCount);
+    return true;
+}
+
+
+static auto RunBusGrouping() noexcept -> bool
+{
+    // Queued behind a running one, with equal priority: those to the slave addressed
+    // last go first, sparing a bus reconfiguration each. Then the others, oldest first.
+    static constexpr std::array sData{std::byte{0xa5}};
+    static constexpr std::array sSPICfgs{
+        &sLCDSPISlaveCfg, &sRTCCSPISlaveCfg, &sLCDSPISlaveCfg, &sRTCCSPISlaveCfg, &sLCDSPISlaveCfg
+    };
+
+    sBusTransactions = {};
+    const auto lFirstTransferIx{SimTimeline::GetTransfers().size()};
+    for (const auto lSPICfg : sSPICfgs) {
+        sBusQueue.push_back(Utils::SPI::Transaction{.mSPICfg{lSPICfg}, .mTxSegments{std::span<const std::byte>{sData}}});
+    }
+    do {
+        DispatchBus();
+    } while (SimTimeline::Sleep());
+
+    std::vector<const CoreLink::SPISlaveCfg*> lOrder{};
+    const auto& lTransfers{SimTimeline::GetTransfers()};
+    for (auto lIx{lFirstTransferIx}; lIx < lTransfers.size(); ++lIx) {
+        lOrder.push_back(lTransfers[lIx].mSPICfg);
+    }
+
+    const std::vector lExpected{
+        &sLCDSPISlaveCfg, &sLCDSPISlaveCfg, &sLCDSPISlaveCfg, &sRTCCSPISlaveCfg, &sRTCCSPISlaveCfg
+    };
+    const auto lStats{sBusTransactions.GetStats()};
+    const auto lIsValid{
+        (lOrder == lExpected) && (lStats.mSPICfgChanges == 2)
+        && (sGUIQueue.size() == 3) && (sRTCCQueue.size() == 2)
+    };
+    sGUIQueue.clear();
+    sRTCCQueue.clear();
+    if (!lIsValid) {
+        std::printf("Bus transactions not grouped by slave.\n");
+        return false;
+    }
+
+    std::printf("%-20s %8u    bus configurations, for %zu transactions\n",
+        "Grouped by slave", lStats.mSPICfgChanges, sSPICfgs.size());
+    return true;
+}
+
+
+static void DispatchBus() noexcept
+{
+    // As the SPI bus AO: queues the transactions posted, reports those done,
+    // those dropped unsent as failed, and keeps the bus busy.
+    for (; !sBusQueue.empty(); sBusQueue.pop_front()) {
+        if (const auto& lEvt{sBusQueue.front()}) {
+            if (!sBusTransactions.Push(*lEvt)) {
+                CompleteBus(*lEvt, false);
+            }
+        }
+        else if (const auto lTransaction{sBusTransactions.OnPieceDone()}) {
+            CompleteBus(*lTransaction, true);
+        }
+
+        while (const auto lPiece{sBusTransactions.StartNext()}) {
+            const auto lIsStarted{
+                sSPIDMAEngine.Start(
+                    *lPiece->mSPICfg, lPiece->mTxSegments, lPiece->mRxData,
+                    []() noexcept {sBusQueue.push_back(std::nullopt);}
+                )
+            };
+            if (lIsStarted) {
+                break;
+            }
+            CompleteBus(*sBusTransactions.Drop(), false);
+        }
+    }
+}
+
+
+static void CompleteBus(const Utils::SPI::Transaction& aTransaction, const bool aIsSent) noexcept
+{
+    // The RTCC has no failure event: it gets its done event either way.
+    if (aTransaction.mSPICfg == &sLCDSPISlaveCfg) {
+        sGUIQueue.push_back(aIsSent ? eSig::LCDWrDone : eSig::LCDWrFailed);
+    }
+    else {
+        sRTCCQueue.push_back(eSig::TimeRead);
+    }
+}
+
+
+static auto SplitAsBus(const Transactions& aTransactions) noexcept -> Transactions
+{
+    // Each line goes behind its own mode byte, closed by the byte following it.
+    static constexpr auto sSplitSize{Drivers::LS013B7DH03::sTxSplitSize};
+    static constexpr auto sSplitTail{Drivers::LS013B7DH03::sTxSplitTail};
+    Transactions lPieces{};
+    for (const auto& lTransaction : aTransactions) {
+        for (std::size_t lIx{1}; (lIx + sSplitTail) < lTransaction.size(); lIx += sSplitSize) {
+            auto& lPiece{lPieces.emplace_back(1, lTransaction.front())};
+            const auto lEndIx{std::min(lIx + sSplitSize + sSplitTail, lTransaction.size())};
+            lPiece.insert(lPiece.end(), lTransaction.cbegin() + static_cast<std::ptrdiff_t>(lIx), lTransaction.cbegin() + static_cast<std::ptrdiff_t>(lEndIx));
+        }
+    }
+
+    return lPieces;
+}
+
+
+static void SyncWr(const std::span<const std::byte> aData, const std::optional<std::byte> aAddr) noexcept
+{
+    auto& lTransaction{sSyncTransactions.emplace_back()};
+    if (aAddr) {
+        lTransaction.push_back(std::to_integer<uint8_t>(*aAddr));
+    }
+    for (const auto lByte : aData) {
+        lTransaction.push_back(std::to_integer<uint8_t>(lByte));
+    }
+}
+
+
+static auto StartTimeRead(const std::span<std::byte> aTime) noexcept -> bool
+{
+    static constexpr std::array sAddr{std::byte{0x00}};
+    static constexpr std::array sSegments{std::span<const std::byte>{sAddr}};
+    sRTCCByteIx = 0;
+    return sSPIDMAEngine.Start(sRTCCSPISlaveCfg, sSegments, aTime, []() noexcept {sRTCCQueue.push_back(eSig::TimeRead);});
+}
+
+
+static auto SleepUntilEvent(const std::deque<eSig>& aQueue) noexcept -> bool
+{
+    while (aQueue.empty()) {
+        if (!SimTimeline::Sleep()) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+
+static auto GetTransactions(const CoreLink::SPISlaveCfg& aSPICfg) noexcept -> Transactions
+{
+    Transactions lTransactions{};
+    for (const auto& lTransfer : SimTimeline::GetTransfers()) {
+        if (lTransfer.mSPICfg == &aSPICfg) {
+            lTransactions.push_back(lTransfer.mBytes);
+        }
+    }
+
+    return lTransactions;
+}
+
+
+static void DrawScene(tDisplay& aDisplay, const int32_t aSceneIx) noexcept
+{
+    static constexpr tRectangle sFrame{5, 5, 122, 122};
+    static constexpr tRectangle sInner{6, 6, 121, 121};
+    static constexpr tRectangle sFullScreen{0, 0, 127, 127};
+    const tRectangle lHighlight{
+        10, static_cast<int16_t>(20 + 12 * (aSceneIx / 2)),
+        117, static_cast<int16_t>(30 + 12 * (aSceneIx / 2))
+    };
+
+    if (aSceneIx == 3) {
+        aDisplay.pfnRectFill(aDisplay.pvDisplayData, &sFullScreen, 1);
+        return;
+    }
+
+    aDisplay.pfnRectFill(aDisplay.pvDisplayData, &sFrame, 1);
+    aDisplay.pfnRectFill(aDisplay.pvDisplayData, &sInner, 0);
+    aDisplay.pfnRectFill(aDisplay.pvDisplayData, &lHighlight, 1);
+}
+
+// *****************************************************************************
+//                                END OF FILE
+// *****************************************************************************
@@ -0,0 +1,155 @@
+// *****************************************************************************
+//
+// Project: PFPP.
+//
+// Module: SPI DMA simulation.
+//
+// *****************************************************************************
+
+//! \file
+//! \brief Host stand-in of the SPI uDMA transfer engine, on the simulated timeline.
+//! Takes the same transfers as the uDMA one, tasks limit included, and completes
+//! them from the interrupt raised at their end. The received bytes are stored then.
+//! \ingroup app
+
+// *****************************************************************************
+//
+//        Copyright (c) 2023, Martin Garon, All rights reserved.
+//
+// This source code is licensed under the GPL-3.0-style license found in the
+// LICENSE file in the root directory of this source tree.
+//
+// *****************************************************************************
+
+// *****************************************************************************
+//                              INCLUDE FILES
+// *****************************************************************************
+
+// This application.
+#include "SimTimeline.h"
+
+// Firmware Libraries.
+#include "corelink/inc/SPIDMAEngine.h"
+
+// Standard Libraries.
+#include <algorithm>
+#include <vector>
+
+// *****************************************************************************
+//                      DEFINED CONSTANTS AND MACROS
+// *****************************************************************************
+
+// *****************************************************************************
+//                         TYPEDEFS AND STRUCTURES
+// *****************************************************************************
+
+// *****************************************************************************
+//                            FUNCTION PROTOTYPES
+// *****************************************************************************
+
+[[nodiscard]] static auto ToTaskCount(std::size_t aCount) noexcept -> std::size_t;
+
+// *****************************************************************************
+//                             GLOBAL VARIABLES
+// *****************************************************************************
+
+// The bytes to receive of the transfer in flight, and where they go.
+static std::vector<uint8_t> sRxBytes{};
+static std::span<std::byte> sRxData{};
+
+// *****************************************************************************
+//                            EXPORTED FUNCTIONS
+// *****************************************************************************
+
+namespace CoreLink
+{
+
+
+SPIDMAEngine::SPIDMAEngine(
+    const SPIMasterDev& aSPIMasterDev,
+    const Channels aChannels
+) noexcept
+    : mSPIMasterDev{aSPIMasterDev}
+    , mChannels{aChannels}
+{
+    // Ctor body left empty.
+}
+
+
+void SPIDMAEngine::Init() const noexcept
+{
+    // No channel to assign.
+}
+
+
+auto SPIDMAEngine::Start(
+    const SPISlaveCfg& aSPICfg,
+    const std::span<const std::span<const std::byte>> aTxSegments,
+    const std::span<std::byte> aRxData,
+    const SPIDone aDone
+) noexcept -> bool
+{
+    if (mIsBusy) {
+        return false;
+    }
+
+    // The segments, then 0s for as many bytes as to receive.
+    std::vector<uint8_t> lBytes{};
+    auto lTxTaskCount{ToTaskCount(aRxData.size())};
+    for (const auto lSegment : aTxSegments) {
+        for (const auto lByte : lSegment) {
+            lBytes.push_back(std::to_integer<uint8_t>(lByte));
+        }
+        lTxTaskCount += ToTaskCount(lSegment.size());
+    }
+    const auto lDiscardCount{lBytes.size()};
+    const auto lRxTaskCount{ToTaskCount(lDiscardCount) + ToTaskCount(aRxData.size())};
+    lBytes.resize(lBytes.size() + aRxData.size(), 0);
+    if (lBytes.empty() || (lTxTaskCount > sMaxTaskCount) || (lRxTaskCount > sMaxTaskCount)) {
+        return false;
+    }
+
+    mSPICfg = &aSPICfg;
+    mDone = aDone;
+    mIsBusy = true;
+
+    const auto lReplies{SimTimeline::StartTransfer(aSPICfg, std::move(lBytes))};
+    sRxBytes.assign(lReplies.cbegin() + static_cast<std::ptrdiff_t>(lDiscardCount), lReplies.cend());
+    sRxData = aRxData;
+    return true;
+}
+
+
+void SPIDMAEngine::OnInterrupt() noexcept
+{
+    if (!mIsBusy || SimTimeline::IsTransferInFlight()) {
+        return;
+    }
+
+    std::transform(
+        sRxBytes.cbegin(),
+        sRxBytes.cend(),
+        sRxData.begin(),
+        [](const uint8_t aByte) noexcept {return std::byte{aByte};}
+    );
+    mIsBusy = false;
+    if (mDone != nullptr) {
+        mDone();
+    }
+}
+
+
+} // namespace CoreLink
+
+// *****************************************************************************
+//                              LOCAL FUNCTIONS
+// *****************************************************************************
+
+static auto ToTaskCount(const std::size_t aCount) noexcept -> std::size_t
+{
+    return (aCount + CoreLink::SPIDMAEngine::sMaxTaskSize - 1) / CoreLink::SPIDMAEngine::sMaxTaskSize;
+}
+
+// *****************************************************************************
+//                                END OF FILE
+// *****************************************************************************
@@ -0,0 +1,162 @@
+// *****************************************************************************
+//
+// Project: PFPP.
+//
+// Module: SPI DMA simulation.
+//
+// *****************************************************************************
+
+//! \file
+//! \brief Simulated timeline of the SPI bus, and of the CPU waiting on it.
+//! \ingroup app
+
+// *****************************************************************************
+//
+//        Copyright (c) 2023, Martin Garon, All rights reserved.
+//
+// This source code is licensed under the GPL-3.0-style license found in the
+// LICENSE file in the root directory of this source tree.
+//
+// *****************************************************************************
+
+// *****************************************************************************
+//                              INCLUDE FILES
+// *****************************************************************************
+
+// This module.
+#include "SimTimeline.h"
+
+// Standard Libraries.
+#include <algorithm>
+#include <map>
+
+// *****************************************************************************
+//                      DEFINED CONSTANTS AND MACROS
+// *****************************************************************************
+
+// *****************************************************************************
+//                         TYPEDEFS AND STRUCTURES
+// *****************************************************************************
+
+// *****************************************************************************
+//                            FUNCTION PROTOTYPES
+// *****************************************************************************
+
+static void RunInterruptsUntil(uint64_t aTime) noexcept;
+
+// *****************************************************************************
+//                             GLOBAL VARIABLES
+// *****************************************************************************
+
+static SimTimeline::ISR sISR{nullptr};
+static SimTimeline::Stats sStats{};
+static std::map<const CoreLink::SPISlaveCfg*, SimTimeline::Slave> sSlaves{};
+static std::vector<SimTimeline::Transfer> sTransfers{};
+
+static uint64_t sNow{0};
+
+// *****************************************************************************
+//                            EXPORTED FUNCTIONS
+// *****************************************************************************
+
+namespace SimTimeline
+{
+
+
+void Reset(const ISR aISR) noexcept
+{
+    sISR = aISR;
+    sStats = {};
+    sSlaves.clear();
+    sTransfers.clear();
+    sNow = 0;
+}
+
+
+void SetSlave(const CoreLink::SPISlaveCfg& aSPICfg, Slave aSlave) noexcept
+{
+    sSlaves[&aSPICfg] = std::move(aSlave);
+}
+
+
+auto GetNow() noexcept -> uint64_t
+{
+    return sNow;
+}
+
+
+void Spend(const uint64_t aDuration) noexcept
+{
+    const auto lEndTime{sNow + aDuration};
+    RunInterruptsUntil(lEndTime);
+    sNow = lEndTime;
+    sStats.mCPUTime += aDuration;
+}
+
+
+auto Sleep() noexcept -> bool
+{
+    if (!IsTransferInFlight()) {
+        return false;
+    }
+
+    const auto lWakeTime{sTransfers.back().mEndTime};
+    sStats.mSleepTime += lWakeTime - sNow;
+    RunInterruptsUntil(lWakeTime);
+    return true;
+}
+
+
+auto StartTransfer(const CoreLink::SPISlaveCfg& aSPICfg, std::vector<uint8_t> aBytes) noexcept
+    -> std::vector<uint8_t>
+{
+    // Back to back bytes at the bit rate of the slave.
+    const auto lDuration{aBytes.size() * 8 * 1000000000ULL / aSPICfg.mBitRate};
+    std::vector<uint8_t> lReplies(aBytes.size(), 0);
+    if (const auto lSlave{sSlaves.find(&aSPICfg)}; lSlave != sSlaves.end()) {
+        std::transform(aBytes.cbegin(), aBytes.cend(), lReplies.begin(), lSlave->second);
+    }
+
+    sTransfers.push_back(Transfer{&aSPICfg, std::move(aBytes), sNow, sNow + lDuration});
+    return lReplies;
+}
+
+
+auto IsTransferInFlight() noexcept -> bool
+{
+    return !sTransfers.empty() && (sTransfers.back().mEndTime > sNow);
+}
+
+
+auto GetTransfers() noexcept -> const std::vector<Transfer>&
+{
+    return sTransfers;
+}
+
+
+auto GetStats() noexcept -> Stats
+{
+    return sStats;
+}
+
+
+} // namespace SimTimeline
+
+// *****************************************************************************
+//                              LOCAL FUNCTIONS
+// *****************************************************************************
+
+static void RunInterruptsUntil(const uint64_t aTime) noexcept
+{
+    // One transfer at a time: its end is the next interrupt.
+    // The ISR can start another one, ending later.
+    while (SimTimeline::IsTransferInFlight() && (sTransfers.back().mEndTime <= aTime)) {
+        sNow = sTransfers.back().mEndTime;
+        ++sStats.mInterrupts;
+        sISR();
+    }
+}
+
+// *****************************************************************************
+//                                END OF FILE
+// *****************************************************************************
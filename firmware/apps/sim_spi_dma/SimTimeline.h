@@ -0,0 +1,112 @@
+#ifndef APPS__SIMTIMELINE_H_
+#define APPS__SIMTIMELINE_H_
+// *****************************************************************************
+//
+// Project: PFPP.
+//
+// Module: SPI DMA simulation.
+//
+// *****************************************************************************
+
+//! \file
+//! \brief Simulated timeline of the SPI bus, and of the CPU waiting on it.
+//! \ingroup app
+
+// *****************************************************************************
+//
+//        Copyright (c) 2023, Martin Garon, All rights reserved.
+//
+// This source code is licensed under the GPL-3.0-style license found in the
+// LICENSE file in the root directory of this source tree.
+//
+// *****************************************************************************
+
+// *****************************************************************************
+//                              INCLUDE FILES
+// *****************************************************************************
+
+// Firmware Libraries.
+#include "corelink/inc/SPISlaveCfg.h"
+
+// Standard Libraries.
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+// *****************************************************************************
+//                       DEFINED CONSTANTS AND MACROS
+// *****************************************************************************
+
+// *****************************************************************************
+//                         TYPEDEFS AND STRUCTURES
+// *****************************************************************************
+
+//! \brief Time in ns, moved only by the CPU spending it or sleeping.
+//! A transfer started on the bus lasts its bit times, and raises the SSI
+//! interrupt as it ends: the ISR runs then, between the CPU work or to wake it up.
+namespace SimTimeline
+{
+
+
+using ISR = void (*)() noexcept;
+
+//! \brief A slave: its reply to each byte received, in a CS window.
+using Slave = std::function<uint8_t(uint8_t aByte)>;
+
+//! \brief A CS window on the bus.
+struct Transfer
+{
+    const CoreLink::SPISlaveCfg* mSPICfg{};
+    std::vector<uint8_t> mBytes{};
+    uint64_t mStartTime{};
+    uint64_t mEndTime{};
+};
+
+struct Stats
+{
+    uint64_t mCPUTime{};
+    uint64_t mSleepTime{};
+    unsigned int mInterrupts{};
+};
+
+//! \brief Starts over at time 0, with aISR as the SSI interrupt handler.
+void Reset(ISR aISR) noexcept;
+void SetSlave(const CoreLink::SPISlaveCfg& aSPICfg, Slave aSlave) noexcept;
+
+[[nodiscard]] auto GetNow() noexcept -> uint64_t;
+
+//! \brief CPU work: time goes by, the interrupts due meanwhile run.
+void Spend(uint64_t aDuration) noexcept;
+
+//! \brief Sleeps until the next interrupt and runs it.
+//! Returns false when none is coming: the CPU would sleep forever.
+[[nodiscard]] auto Sleep() noexcept -> bool;
+
+//! \brief For the stand-ins: puts the bytes on the bus from now on.
+//! Returns the slave replies, one per byte.
+[[nodiscard]] auto StartTransfer(const CoreLink::SPISlaveCfg& aSPICfg, std::vector<uint8_t> aBytes) noexcept
+    -> std::vector<uint8_t>;
+[[nodiscard]] auto IsTransferInFlight() noexcept -> bool;
+
+[[nodiscard]] auto GetTransfers() noexcept -> const std::vector<Transfer>&;
+[[nodiscard]] auto GetStats() noexcept -> Stats;
+
+
+} // namespace SimTimeline
+
+// *****************************************************************************
+//                            EXPORTED VARIABLES
+// *****************************************************************************
+
+// *****************************************************************************
+//                                 EXTERNS
+// *****************************************************************************
+
+// *****************************************************************************
+//                            EXPORTED FUNCTIONS
+// *****************************************************************************
+
+// *****************************************************************************
+//                                END OF FILE
+// *****************************************************************************
+#endif // APPS__SIMTIMELINE_H_
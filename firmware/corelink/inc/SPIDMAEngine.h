@@ -0,0 +1,145 @@
+#ifndef CORELINK__SPIDMAENGINE_H_
+#define CORELINK__SPIDMAENGINE_H_
+// *******************************************************************************
+//
+// Project: ARM Cortex-M.
+//
+// Module: CoreLink Peripherals.
+//
+// *******************************************************************************
+
+//! \file
+//! \brief CoreLink peripheral SPI uDMA transfer engine class declaration.
+//! \ingroup corelink_peripherals
+
+// ******************************************************************************
+//
+//        Copyright (c) 2015-2023, Martin Garon, All rights reserved.
+//
+// This source code is licensed under the GPL-3.0-style license found in the
+// LICENSE file in the root directory of this source tree.
+//
+// ******************************************************************************
+
+// ******************************************************************************
+//                              INCLUDE FILES
+// ******************************************************************************
+
+// CoreLink library.
+#include "corelink/inc/SPIMasterDev.h"
+#include "corelink/inc/SPISlaveCfg.h"
+#include "corelink/inc/Types.h"
+
+// Standard libraries.
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+
+// ******************************************************************************
+//                       DEFINED CONSTANTS AND MACROS
+// ******************************************************************************
+
+// ******************************************************************************
+//                         TYPEDEFS AND STRUCTURES
+// ******************************************************************************
+
+namespace CoreLink
+{
+
+
+//! \class SPIDMAEngine
+//! \brief SPI transfers moved by the uDMA, on the SSI of an SPIMasterDev.
+//! A transfer is one CS window: the TX segments back to back, then 0s for as
+//! many bytes as to receive. The TX channel feeds the TX FIFO through a
+//! scatter-gather task list, the RX channel drains the RX FIFO through its own:
+//! bytes received during the 0s are stored, the others discarded.
+//! The RX channel finishes last, once the last byte has shifted: its completion
+//! raises the SSI interrupt, from which OnInterrupt() releases CS and reports
+//! the completion to the requester of the transfer.
+//! The uDMA controller is to be enabled, with its control table set, beforehand.
+class SPIDMAEngine final
+{
+public:
+    //! \brief uDMA channel assignments of the SSI, as UDMA_CHn_SSImTX and UDMA_CHn_SSImRX.
+    struct Channels
+    {
+        uint32_t mTx{};
+        uint32_t mRx{};
+    };
+
+    static constexpr std::size_t sMaxTaskCount{8};
+    static constexpr std::size_t sMaxTaskSize{1024};
+
+    [[nodiscard]] explicit SPIDMAEngine(
+        const SPIMasterDev& aSPIMasterDev,
+        Channels aChannels
+    ) noexcept;
+
+    //! \brief Assigns the channels to the SSI.
+    void Init() const noexcept;
+
+    //! \brief Starts a transfer, aSPICfg and the data left alone until its completion.
+    //! aDone is called from the SSI interrupt once completed.
+    //! Returns false for an empty transfer, when one is in flight, or when it takes
+    //! more than sMaxTaskCount tasks of up to sMaxTaskSize bytes in either direction.
+    [[nodiscard]] auto Start(
+        const SPISlaveCfg& aSPICfg,
+        std::span<const std::span<const std::byte>> aTxSegments,
+        std::span<std::byte> aRxData,
+        SPIDone aDone
+    ) noexcept -> bool;
+
+    [[nodiscard]] auto IsBusy() const noexcept -> bool {return mIsBusy;}
+
+    //! \brief To call from the SSI interrupt: completes the transfer once all received.
+    void OnInterrupt() noexcept;
+
+private:
+    //! \brief A scatter-gather task, laid out as a uDMA channel control structure.
+    struct Task
+    {
+        const volatile void* mSrcEndAddr{};
+        volatile void* mDstEndAddr{};
+        uint32_t mControl{};
+        uint32_t mSpare{};
+    };
+
+    using Tasks = std::array<Task, sMaxTaskCount>;
+
+    const SPIMasterDev& mSPIMasterDev;
+    Channels mChannels;
+
+    // The transfer in flight.
+    std::atomic<bool> mIsBusy{false};
+    const SPISlaveCfg* mSPICfg{nullptr};
+    SPIDone mDone{nullptr};
+
+    // Source of the 0s sent while receiving, sink of the bytes received while sending.
+    std::byte mTxFill{};
+    std::byte mRxDiscard{};
+
+    alignas(16) Tasks mTxTasks{};
+    alignas(16) Tasks mRxTasks{};
+};
+
+
+} // namespace CoreLink
+
+// ******************************************************************************
+//                            EXPORTED VARIABLES
+// ******************************************************************************
+
+// ******************************************************************************
+//                                 EXTERNS
+// ******************************************************************************
+
+// ******************************************************************************
+//                            EXPORTED FUNCTIONS
+// ******************************************************************************
+
+// ******************************************************************************
+//                                END OF FILE
+// ******************************************************************************
+#endif // CORELINK__SPIDMAENGINE_H_
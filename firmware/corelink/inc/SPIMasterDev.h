@@ -59,7 +59,17 @@ public:
         :  PeripheralBase{aBaseAddr, aClkRate}
     {/* Ctor body. */}
 
+    //! \brief aSPICfg, with its SSI register images for this master clock rate:
+    //! switching to it is then plain register writes. For constexpr slave configs.
+    [[nodiscard]] constexpr auto MakeCfg(SPISlaveCfg aSPICfg) const noexcept -> SPISlaveCfg
+    {
+        aSPICfg.mSSIRegs = aSPICfg.ToSSIRegs(mClkRate);
+        return aSPICfg;
+    }
+
     // ISPIMasterDev interface.
+    // Bytes are sent back to back, the TX FIFO kept fed while the RX FIFO is drained.
+    // WrData() only feeds the TX FIFO: the RX FIFO overruns and is emptied at the end.
     void RdData(
         const SPISlaveCfg& aSPICfg,
         std::span<std::byte> aData,
@@ -79,10 +89,36 @@ public:
         std::byte aByte
     ) const noexcept -> std::byte;
 
+    // Interrupt driven write: BeginWr(), PutData() from the TX FIFO interrupt
+    // until all data is queued, then EnableTxEOT(true): the next TX interrupt
+    // comes once the last byte has shifted out, and EndWr() from it does not wait.
+    // The bus is held by this slave until EndWr().
+    void BeginWr(const SPISlaveCfg& aSPICfg) const noexcept;
+    [[nodiscard]] auto PutData(std::span<const std::byte> aData) const noexcept
+        -> std::size_t;
+    void EndWr(const SPISlaveCfg& aSPICfg) const noexcept;
+    void EnableTxInt(bool aIsEnabled) const noexcept;
+    void EnableTxEOT(bool aIsEnabled) const noexcept;
+
+    // uDMA driven transfer, see SPIDMAEngine: BeginDMA() hands the FIFOs to the uDMA
+    // once its channels are set, EndDMA() takes them back once all bytes are received.
+    // The bus is held by this slave until EndDMA().
+    void BeginDMA(const SPISlaveCfg& aSPICfg) const noexcept;
+    void EndDMA(const SPISlaveCfg& aSPICfg) const noexcept;
+    [[nodiscard]] auto GetDataRegAddr() const noexcept -> uint32_t;
+
 private:
     void SetCfg(const SPISlaveCfg& aSPICfg) const noexcept;
 
-    mutable SPISlaveCfg mCachedSPISlaveCfg;
+    //! \brief Waits for the TX FIFO to shift out, then empties the RX FIFO.
+    void FlushTx() const noexcept;
+
+    //! \brief Sends the address if any, then 0s for as many bytes as to receive.
+    //! Received bytes following the address are stored.
+    void Transfer(std::optional<std::byte> aAddr, std::span<std::byte> aRxData) const noexcept;
+
+    //! \brief The SSI register images last written.
+    mutable SSIRegs mCachedSSIRegs{};
 };
 
 
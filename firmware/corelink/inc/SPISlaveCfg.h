@@ -28,6 +28,9 @@
 // Corelink library.
 #include "corelink/inc/GPIO.h"
 
+// Standard libraries.
+#include <cstdint>
+
 // ******************************************************************************
 //                       DEFINED CONSTANTS AND MACROS
 // ******************************************************************************
@@ -56,6 +59,19 @@ struct CSnGPIO final
 };
 
 
+//! \brief The SSI CR0 and CPSR register images of a slave config.
+//! Switching to the slave writes them as is.
+struct SSIRegs final
+{
+    //! \brief Whether computed: the clock prescaler is at least 2.
+    [[nodiscard]] constexpr auto IsValid() const noexcept -> bool {return mCPSR != 0;}
+    [[nodiscard]] constexpr bool operator==(const SSIRegs& aRegs) const noexcept = default;
+
+    uint32_t mCR0{0};
+    uint32_t mCPSR{0};
+};
+
+
 struct SPISlaveCfg final
 {
     enum class tProtocol
@@ -68,6 +84,42 @@ struct SPISlaveCfg final
         NMW
     };
 
+    //! \brief The SSI register images of this config, for a master SSI clock of aClkRate.
+    //! Same dividers as SSIConfigSetExpClk(): the smallest even prescaler
+    //! leaving a serial clock rate divider of at most 256, the bit rate rounded down.
+    //! Not valid when the bit rate is out of reach: above half aClkRate,
+    //! or at most aClkRate / (254 * 257), past the 8-bit prescaler.
+    [[nodiscard]] constexpr auto ToSSIRegs(const uint32_t aClkRate) const noexcept -> SSIRegs
+    {
+        if ((mBitRate == 0) || ((aClkRate / mBitRate) < 2) || ((aClkRate / mBitRate) >= (254 * 257))) {
+            return SSIRegs{};
+        }
+
+        const uint32_t lMaxBitRate{aClkRate / mBitRate};
+        uint32_t lPreDiv{0};
+        uint32_t lSCR{0};
+        do {
+            lPreDiv += 2;
+            lSCR = (lMaxBitRate / lPreDiv) - 1;
+        } while (lSCR > 255);
+
+        // CR0: SCR [15:8], SPH [7], SPO [6], FRF [5:4], DSS [3:0].
+        uint32_t lFormat{0};
+        switch (mProtocol) {
+        case tProtocol::MOTO_0: lFormat = 0x00; break;
+        case tProtocol::MOTO_1: lFormat = 0x80; break;
+        case tProtocol::MOTO_2: lFormat = 0x40; break;
+        case tProtocol::MOTO_3: lFormat = 0xC0; break;
+        case tProtocol::TI:     lFormat = 0x10; break;
+        case tProtocol::NMW:    lFormat = 0x20; break;
+        }
+
+        return SSIRegs{
+            .mCR0{(lSCR << 8) | lFormat | ((mDataWidth - 1) & 0x0F)},
+            .mCPSR{lPreDiv}
+        };
+    }
+
     bool operator==(const SPISlaveCfg& aCfg) const noexcept
     {
         return ((this->mProtocol == aCfg.mProtocol)
@@ -87,6 +139,9 @@ struct SPISlaveCfg final
     unsigned int mDataWidth{sDfltDataWidth};
 
     CSnGPIO mCSn{};
+
+    //! \brief Precomputed by SPIMasterDev::MakeCfg(), else computed on each switch.
+    SSIRegs mSSIRegs{};
 };
 
 
@@ -47,6 +47,16 @@ using SPIWr = void (*)(std::span<const std::byte> aData, std::optional<std::byte
 using SPIAssert = void (*)() noexcept;
 using PushPullByte = std::byte (*)(std::byte aByte) noexcept;
 
+// Non-blocking transmit: queues what fits in the TX FIFO, returns the byte count taken.
+using SPIPut = std::size_t (*)(std::span<const std::byte> aData) noexcept;
+using SPITxIntEnable = void (*)(bool aIsEnabled) noexcept;
+
+// Asynchronous transmit of a transaction: the segments back to back, in one CS window.
+// The completion is reported apart, from the interrupt.
+// Returns false when the transaction can't be started: nothing is sent, nor reported, then.
+using SPIWrStart = bool (*)(std::span<const std::span<const std::byte>> aSegments) noexcept;
+using SPIDone = void (*)() noexcept;
+
 
 } // namespace CoreLink
 
@@ -0,0 +1,211 @@
+// *****************************************************************************
+//
+// Project: ARM Cortex-M.
+//
+// Module: CoreLink Peripherals.
+//
+// *****************************************************************************
+
+//! \file
+//! \brief CoreLink peripheral SPI uDMA transfer engine class definition.
+//! \ingroup corelink_peripherals
+
+// *****************************************************************************
+//
+//        Copyright (c) 2015-2023, Martin Garon, All rights reserved.
+//
+// This source code is licensed under the GPL-3.0-style license found in the
+// LICENSE file in the root directory of this source tree.
+//
+// *****************************************************************************
+
+// *****************************************************************************
+//                              INCLUDE FILES
+// *****************************************************************************
+
+// This module.
+#include "corelink/inc/SPIDMAEngine.h"
+
+// TI Library.
+#include <inc/hw_udma.h>
+#include <driverlib/rom.h>
+#include <driverlib/rom_map.h>
+#include <driverlib/udma.h>
+
+// Standard libraries.
+#include <algorithm>
+
+// *****************************************************************************
+//                      DEFINED CONSTANTS AND MACROS
+// *****************************************************************************
+
+// *****************************************************************************
+//                         TYPEDEFS AND STRUCTURES
+// *****************************************************************************
+
+// *****************************************************************************
+//                            FUNCTION PROTOTYPES
+// *****************************************************************************
+
+[[nodiscard]] static constexpr auto ToChannelNum(uint32_t aAssignment) noexcept -> uint32_t;
+
+// *****************************************************************************
+//                             GLOBAL VARIABLES
+// *****************************************************************************
+
+// *****************************************************************************
+//                            EXPORTED FUNCTIONS
+// *****************************************************************************
+
+namespace CoreLink
+{
+
+
+SPIDMAEngine::SPIDMAEngine(
+    const SPIMasterDev& aSPIMasterDev,
+    const Channels aChannels
+) noexcept
+    : mSPIMasterDev{aSPIMasterDev}
+    , mChannels{aChannels}
+{
+    // Ctor body.
+    static_assert(sizeof(Task) == sizeof(tDMAControlTable));
+}
+
+
+void SPIDMAEngine::Init() const noexcept
+{
+    // RX at high priority: it must keep up for the RX FIFO not to overrun.
+    for (const auto lAssignment : {mChannels.mTx, mChannels.mRx}) {
+        MAP_uDMAChannelAssign(lAssignment);
+        MAP_uDMAChannelAttributeDisable(
+            ToChannelNum(lAssignment),
+            UDMA_ATTR_ALTSELECT | UDMA_ATTR_USEBURST | UDMA_ATTR_HIGH_PRIORITY | UDMA_ATTR_REQMASK
+        );
+    }
+    MAP_uDMAChannelAttributeEnable(ToChannelNum(mChannels.mRx), UDMA_ATTR_HIGH_PRIORITY);
+}
+
+
+auto SPIDMAEngine::Start(
+    const SPISlaveCfg& aSPICfg,
+    const std::span<const std::span<const std::byte>> aTxSegments,
+    const std::span<std::byte> aRxData,
+    const SPIDone aDone
+) noexcept -> bool
+{
+    if (mIsBusy) {
+        return false;
+    }
+
+    // Each run of bytes takes as many tasks as needed, from or to the data register.
+    const auto lDataReg{reinterpret_cast<volatile void*>(mSPIMasterDev.GetDataRegAddr())};
+    std::size_t lTxTaskCount{0};
+    std::size_t lRxTaskCount{0};
+    const auto lAddTxTasks{
+        [&](const std::byte* const aSrc, const uint32_t aSrcInc, const std::size_t aCount) noexcept
+        {
+            for (std::size_t lIx{0}; lIx < aCount; lIx += sMaxTaskSize) {
+                if (lTxTaskCount >= sMaxTaskCount) {
+                    return false;
+                }
+                const auto lSize{static_cast<uint32_t>(std::min(aCount - lIx, sMaxTaskSize))};
+                const auto lSrc{(aSrcInc == UDMA_SRC_INC_NONE) ? aSrc : (aSrc + lIx)};
+                mTxTasks[lTxTaskCount++] = uDMATaskStructEntry(
+                    lSize, UDMA_SIZE_8,
+                    aSrcInc, lSrc,
+                    UDMA_DST_INC_NONE, lDataReg,
+                    UDMA_ARB_4, UDMA_MODE_PER_SCATTER_GATHER
+                );
+            }
+            return true;
+        }
+    };
+    const auto lAddRxTasks{
+        [&](std::byte* const aDst, const uint32_t aDstInc, const std::size_t aCount) noexcept
+        {
+            for (std::size_t lIx{0}; lIx < aCount; lIx += sMaxTaskSize) {
+                if (lRxTaskCount >= sMaxTaskCount) {
+                    return false;
+                }
+                const auto lSize{static_cast<uint32_t>(std::min(aCount - lIx, sMaxTaskSize))};
+                const auto lDst{(aDstInc == UDMA_DST_INC_NONE) ? aDst : (aDst + lIx)};
+                mRxTasks[lRxTaskCount++] = uDMATaskStructEntry(
+                    lSize, UDMA_SIZE_8,
+                    UDMA_SRC_INC_NONE, lDataReg,
+                    aDstInc, lDst,
+                    UDMA_ARB_4, UDMA_MODE_PER_SCATTER_GATHER
+                );
+            }
+            return true;
+        }
+    };
+
+    // -Send the segments, discarding the bytes received.
+    // -Send 0s as many as requested to read, storing the bytes received.
+    std::size_t lDiscardCount{0};
+    for (const auto lSegment : aTxSegments) {
+        if (!lAddTxTasks(lSegment.data(), UDMA_SRC_INC_8, lSegment.size())) {
+            return false;
+        }
+        lDiscardCount += lSegment.size();
+    }
+    if (!lAddTxTasks(&mTxFill, UDMA_SRC_INC_NONE, aRxData.size())
+        || !lAddRxTasks(&mRxDiscard, UDMA_DST_INC_NONE, lDiscardCount)
+        || !lAddRxTasks(aRxData.data(), UDMA_DST_INC_8, aRxData.size())
+        || (lTxTaskCount == 0)) {
+        return false;
+    }
+
+    // The last task of each list stops its channel.
+    for (const auto lTask : {&mTxTasks[lTxTaskCount - 1], &mRxTasks[lRxTaskCount - 1]}) {
+        lTask->mControl = (lTask->mControl & ~UDMA_CHCTL_XFERMODE_M) | UDMA_MODE_BASIC;
+    }
+
+    mSPICfg = &aSPICfg;
+    mDone = aDone;
+    mIsBusy = true;
+
+    // RX set first: it must be ready for the first byte in.
+    const auto lTxChannelNum{ToChannelNum(mChannels.mTx)};
+    const auto lRxChannelNum{ToChannelNum(mChannels.mRx)};
+    MAP_uDMAChannelScatterGatherSet(lRxChannelNum, lRxTaskCount, mRxTasks.data(), true);
+    MAP_uDMAChannelScatterGatherSet(lTxChannelNum, lTxTaskCount, mTxTasks.data(), true);
+    MAP_uDMAChannelEnable(lRxChannelNum);
+    MAP_uDMAChannelEnable(lTxChannelNum);
+    mSPIMasterDev.BeginDMA(aSPICfg);
+
+    return true;
+}
+
+
+void SPIDMAEngine::OnInterrupt() noexcept
+{
+    // The channel gets disabled once its last task is done.
+    if (!mIsBusy || MAP_uDMAChannelIsEnabled(ToChannelNum(mChannels.mRx))) {
+        return;
+    }
+
+    mSPIMasterDev.EndDMA(*mSPICfg);
+    mIsBusy = false;
+    if (mDone != nullptr) {
+        mDone();
+    }
+}
+
+
+} // namespace CoreLink
+
+// *****************************************************************************
+//                              LOCAL FUNCTIONS
+// *****************************************************************************
+
+static constexpr auto ToChannelNum(const uint32_t aAssignment) noexcept -> uint32_t
+{
+    // The channel number, without the peripheral encoding.
+    return aAssignment & 0xffUL;
+}
+
+// *****************************************************************************
+//                                END OF FILE
+// *****************************************************************************
@@ -27,6 +27,8 @@
 #include "corelink/inc/SPIMasterDev.h"
 
 // TI Library.
+#include <inc/hw_ssi.h>
+#include <inc/hw_types.h>
 #include <driverlib/rom.h>
 #include <driverlib/rom_map.h>
 #include <driverlib/ssi.h>
@@ -35,6 +37,17 @@
 //                      DEFINED CONSTANTS AND MACROS
 // *****************************************************************************
 
+// Entries of the SSI TX and RX FIFOs.
+static constexpr std::size_t sFIFODepth{8};
+
+// The CR0 fields as laid out by SPISlaveCfg::ToSSIRegs().
+static_assert(SSI_CR0_SCR_S == 8);
+static_assert(SSI_CR0_SPH == 0x80);
+static_assert(SSI_CR0_SPO == 0x40);
+static_assert(SSI_CR0_FRF_TI == 0x10);
+static_assert(SSI_CR0_FRF_NMW == 0x20);
+static_assert(SSI_CR0_DSS_M == 0x0F);
+
 // *****************************************************************************
 //                         TYPEDEFS AND STRUCTURES
 // *****************************************************************************
@@ -66,14 +79,7 @@ void SPIMasterDev::RdData(
 
     // -Send address if any.
     // -Push dummy data (0s) as many as requested to read.
-    if (aAddr)
-    {
-        [[maybe_unused]] const auto lByte{PushPullByte(aAddr.value())};
-    }
-
-    for (auto& lByte : aData) {
-        lByte = PushPullByte(std::byte{0});
-    }
+    Transfer(aAddr, aData);
 
     // Deassert the assigned CSn pin.
     aSPICfg.mCSn.DeassertCSn();
@@ -91,17 +97,16 @@ void SPIMasterDev::WrData(
     aSPICfg.mCSn.AssertCSn();
 
     // -Send address if any.
-    // -Push data as many as requested to write.
-    // -Read dummy data to empty receive register.
+    // -Push data as many as requested to write, waiting only on a full TX FIFO.
     // -Wait for all bytes to transmit.
-    if (aAddr)
-    {
-        [[maybe_unused]] const auto lByte{PushPullByte(aAddr.value())};
+    // -Discard the received bytes once, at the end.
+    if (aAddr) {
+        MAP_SSIDataPut(mBaseAddr, std::to_integer<uint32_t>(*aAddr));
     }
-
-    for (const auto aByte : aData) {
-        [[maybe_unused]] const auto lByte{PushPullByte(aByte)};
+    for (const auto lByte : aData) {
+        MAP_SSIDataPut(mBaseAddr, std::to_integer<uint32_t>(lByte));
     }
+    FlushTx();
 
     // Deassert the assigned CSn pin.
     aSPICfg.mCSn.DeassertCSn();
@@ -127,6 +132,88 @@ auto SPIMasterDev::PushPullByte(
     return PushPullByte(aByte);
 }
 
+
+void SPIMasterDev::BeginWr(const SPISlaveCfg& aSPICfg) const noexcept
+{
+    SetCfg(aSPICfg);
+    aSPICfg.mCSn.AssertCSn();
+}
+
+
+auto SPIMasterDev::PutData(const std::span<const std::byte> aData) const noexcept -> std::size_t
+{
+    // Queue as many bytes as the TX FIFO takes.
+    std::size_t lCount{0};
+    for (const auto lByte : aData) {
+        if (!MAP_SSIDataPutNonBlocking(mBaseAddr, std::to_integer<uint32_t>(lByte))) {
+            break;
+        }
+        ++lCount;
+    }
+
+    // The bytes received are discarded by EndWr().
+    return lCount;
+}
+
+
+void SPIMasterDev::EndWr(const SPISlaveCfg& aSPICfg) const noexcept
+{
+    // From the end of transmission interrupt, the SSI is idle: only the RX FIFO is emptied.
+    FlushTx();
+    aSPICfg.mCSn.DeassertCSn();
+}
+
+
+void SPIMasterDev::EnableTxInt(const bool aIsEnabled) const noexcept
+{
+    // Fires while the TX FIFO is half full or less.
+    if (aIsEnabled) {
+        MAP_SSIIntEnable(mBaseAddr, SSI_TXFF);
+    }
+    else {
+        MAP_SSIIntDisable(mBaseAddr, SSI_TXFF);
+    }
+}
+
+
+void SPIMasterDev::EnableTxEOT(const bool aIsEnabled) const noexcept
+{
+    // End of transmission mode of a master: the TX interrupt fires once the TX FIFO
+    // is empty and the last bit has shifted out, rather than at half full.
+    if (aIsEnabled) {
+        HWREG(mBaseAddr + SSI_O_CR1) |= SSI_CR1_EOT;
+    }
+    else {
+        HWREG(mBaseAddr + SSI_O_CR1) &= ~SSI_CR1_EOT;
+    }
+}
+
+
+void SPIMasterDev::BeginDMA(const SPISlaveCfg& aSPICfg) const noexcept
+{
+    // The TM4C129 gates the uDMA completion interrupt by these, the TM4C123 always raises it.
+    SetCfg(aSPICfg);
+    aSPICfg.mCSn.AssertCSn();
+    MAP_SSIIntEnable(mBaseAddr, SSI_DMARX);
+    MAP_SSIDMAEnable(mBaseAddr, SSI_DMA_TX | SSI_DMA_RX);
+}
+
+
+void SPIMasterDev::EndDMA(const SPISlaveCfg& aSPICfg) const noexcept
+{
+    // The last byte received, all bytes have shifted out and the RX FIFO is empty.
+    MAP_SSIDMADisable(mBaseAddr, SSI_DMA_TX | SSI_DMA_RX);
+    MAP_SSIIntDisable(mBaseAddr, SSI_DMARX);
+    MAP_SSIIntClear(mBaseAddr, SSI_DMARX);
+    aSPICfg.mCSn.DeassertCSn();
+}
+
+
+auto SPIMasterDev::GetDataRegAddr() const noexcept -> uint32_t
+{
+    return mBaseAddr + SSI_O_DR;
+}
+
 // *****************************************************************************
 //                              LOCAL FUNCTIONS
 // *****************************************************************************
@@ -134,21 +221,62 @@ auto SPIMasterDev::PushPullByte(
 void SPIMasterDev::SetCfg(const SPISlaveCfg& aSPICfg) const noexcept
 {
     // Test the specified config. Matches the last one used?
-    if (aSPICfg != mCachedSPISlaveCfg) {
-        MAP_SSIDisable(mBaseAddr);
-
-        const auto lNativeProtocol{static_cast<uint32_t>(aSPICfg.mProtocol)};
-        MAP_SSIConfigSetExpClk(
-            mBaseAddr,
-            mClkRate,
-            lNativeProtocol,
-            SSI_MODE_MASTER,
-            aSPICfg.mBitRate,
-            aSPICfg.mDataWidth
-        );
-
-        MAP_SSIEnable(mBaseAddr);
-        mCachedSPISlaveCfg = aSPICfg;
+    const auto lSSIRegs{aSPICfg.mSSIRegs.IsValid() ? aSPICfg.mSSIRegs : aSPICfg.ToSSIRegs(mClkRate)};
+    if (lSSIRegs != mCachedSSIRegs) {
+        // As SSIConfigSetExpClk() for a master, with its dividers computed ahead.
+        // The SSI is disabled while configured.
+        HWREG(mBaseAddr + SSI_O_CR1) = 0;
+        HWREG(mBaseAddr + SSI_O_CPSR) = lSSIRegs.mCPSR;
+        HWREG(mBaseAddr + SSI_O_CR0) = lSSIRegs.mCR0;
+        HWREG(mBaseAddr + SSI_O_CR1) = SSI_CR1_SSE;
+        mCachedSSIRegs = lSSIRegs;
+    }
+}
+
+
+void SPIMasterDev::FlushTx() const noexcept
+{
+    // Wait for the last bytes to shift out.
+    while (MAP_SSIBusy(mBaseAddr)) {
+        // Wait.
+    }
+
+    // Leave an empty RX FIFO to the next reader.
+    // Once full, it dropped the bytes received after: clear the overrun flag too.
+    uint32_t lRxData{0UL};
+    while (MAP_SSIDataGetNonBlocking(mBaseAddr, &lRxData)) {
+        // Discard.
+    }
+    MAP_SSIIntClear(mBaseAddr, SSI_RXOR);
+}
+
+
+void SPIMasterDev::Transfer(
+    const std::optional<std::byte> aAddr,
+    const std::span<std::byte> aRxData
+) const noexcept
+{
+    // Each byte sent clocks one in. Keeping up to a FIFO depth of bytes in flight
+    // lets the bus clock them back to back, while the RX FIFO can't overrun.
+    // Returns once the last byte is received: it has shifted out.
+    const std::size_t lAddrCount{aAddr ? 1U : 0U};
+    const auto lCount{lAddrCount + aRxData.size()};
+    std::size_t lTxIx{0};
+    std::size_t lRxIx{0};
+    while (lRxIx < lCount) {
+        for (; (lTxIx < lCount) && ((lTxIx - lRxIx) < sFIFODepth); ++lTxIx) {
+            const auto lByte{(lTxIx < lAddrCount) ? *aAddr : std::byte{0}};
+            if (!MAP_SSIDataPutNonBlocking(mBaseAddr, std::to_integer<uint32_t>(lByte))) {
+                break;
+            }
+        }
+
+        uint32_t lRxData{0UL};
+        for (; (lRxIx < lTxIx) && MAP_SSIDataGetNonBlocking(mBaseAddr, &lRxData); ++lRxIx) {
+            if (lRxIx >= lAddrCount) {
+                aRxData[lRxIx - lAddrCount] = static_cast<std::byte>(lRxData);
+            }
+        }
     }
 }
 
@@ -0,0 +1,130 @@
+#ifndef DRIVERS__BITORDER_H_
+#define DRIVERS__BITORDER_H_
+// *******************************************************************************
+//
+// Project: Drivers.
+//
+// Module: BitOrder.
+//
+// *******************************************************************************
+
+//! \file
+//! \brief Bit and byte order conversions of 32-bit words.
+//! \ingroup ext_peripherals
+
+// ******************************************************************************
+//
+//        Copyright (c) 2023, Martin Garon, All rights reserved.
+//
+// This source code is licensed under the GPL-3.0-style license found in the
+// LICENSE file in the root directory of this source tree.
+//
+// ******************************************************************************
+
+// ******************************************************************************
+//                              INCLUDE FILES
+// ******************************************************************************
+
+// Standard Libraries.
+#include <cstdint>
+#include <type_traits>
+
+// ******************************************************************************
+//                       DEFINED CONSTANTS AND MACROS
+// ******************************************************************************
+
+// Cortex-M3/M4 have RBIT and REV: other targets, and constant evaluation, take
+// the portable path.
+#if defined(__arm__) && defined(__ARM_ARCH) && (__ARM_ARCH >= 7) && !defined(__ARM_ARCH_6M__)
+#define DRIVERS_BITORDER_HAS_RBIT 1
+#else
+#define DRIVERS_BITORDER_HAS_RBIT 0
+#endif
+
+// ******************************************************************************
+//                         TYPEDEFS AND STRUCTURES
+// ******************************************************************************
+
+namespace Drivers::BitOrder
+{
+
+
+//! \brief Reverses the order of the bytes of a word, without REV.
+[[nodiscard]] constexpr auto ReverseBytesPortable(const uint32_t aWord) noexcept -> uint32_t
+{
+    return (aWord << 24)
+        | ((aWord & 0x0000ff00) << 8)
+        | ((aWord & 0x00ff0000) >> 8)
+        | (aWord >> 24);
+}
+
+
+//! \brief Reverses the order of the bits of a word, without RBIT.
+[[nodiscard]] constexpr auto ReverseBitsPortable(const uint32_t aWord) noexcept -> uint32_t
+{
+    // Swap halves, then bytes, nibbles, pairs and bits.
+    auto lWord{(aWord >> 16) | (aWord << 16)};
+    lWord = ((lWord & 0xff00ff00) >> 8) | ((lWord & 0x00ff00ff) << 8);
+    lWord = ((lWord & 0xf0f0f0f0) >> 4) | ((lWord & 0x0f0f0f0f) << 4);
+    lWord = ((lWord & 0xcccccccc) >> 2) | ((lWord & 0x33333333) << 2);
+    lWord = ((lWord & 0xaaaaaaaa) >> 1) | ((lWord & 0x55555555) << 1);
+    return lWord;
+}
+
+
+//! \brief Reverses the order of the bytes of a word (REV).
+[[nodiscard]] constexpr auto ReverseBytes(const uint32_t aWord) noexcept -> uint32_t
+{
+#if DRIVERS_BITORDER_HAS_RBIT
+    if (!std::is_constant_evaluated()) {
+        uint32_t lResult{};
+        __asm__("rev %0, %1" : "=r" (lResult) : "r" (aWord));
+        return lResult;
+    }
+#endif
+
+    return ReverseBytesPortable(aWord);
+}
+
+
+//! \brief Reverses the order of the bits of a word (RBIT).
+[[nodiscard]] constexpr auto ReverseBits(const uint32_t aWord) noexcept -> uint32_t
+{
+#if DRIVERS_BITORDER_HAS_RBIT
+    if (!std::is_constant_evaluated()) {
+        uint32_t lResult{};
+        __asm__("rbit %0, %1" : "=r" (lResult) : "r" (aWord));
+        return lResult;
+    }
+#endif
+
+    return ReverseBitsPortable(aWord);
+}
+
+
+//! \brief Reverses the order of the bits within each byte of a word,
+//! keeping the bytes in place: 4 bytes go LSB first in an RBIT/REV pair.
+[[nodiscard]] constexpr auto ReverseBitsInBytes(const uint32_t aWord) noexcept -> uint32_t
+{
+    return ReverseBytes(ReverseBits(aWord));
+}
+
+
+} // namespace Drivers::BitOrder
+
+// ******************************************************************************
+//                            EXPORTED VARIABLES
+// ******************************************************************************
+
+// ******************************************************************************
+//                                 EXTERNS
+// ******************************************************************************
+
+// ******************************************************************************
+//                            EXPORTED FUNCTIONS
+// ******************************************************************************
+
+// ******************************************************************************
+//                                END OF FILE
+// ******************************************************************************
+#endif // DRIVERS__BITORDER_H_
@@ -0,0 +1,154 @@
+#ifndef DRIVERS__GLYPHCACHE_H_
+#define DRIVERS__GLYPHCACHE_H_
+// *******************************************************************************
+//
+// Project: Drivers.
+//
+// Module: GlyphCache.
+//
+// *******************************************************************************
+
+//! \file
+//! \brief Pre-rasterised glyph cache, for grlib string rendering.
+//! \ingroup ext_peripherals
+
+// ******************************************************************************
+//
+//        Copyright (c) 2023, Martin Garon, All rights reserved.
+//
+// This source code is licensed under the GPL-3.0-style license found in the
+// LICENSE file in the root directory of this source tree.
+//
+// ******************************************************************************
+
+// ******************************************************************************
+//                              INCLUDE FILES
+// ******************************************************************************
+
+// Standard Libraries.
+#include <array>
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <string_view>
+
+// TivaWare Graphics Library.
+#include <grlib/grlib.h>
+
+// ******************************************************************************
+//                       DEFINED CONSTANTS AND MACROS
+// ******************************************************************************
+
+// ******************************************************************************
+//                         TYPEDEFS AND STRUCTURES
+// ******************************************************************************
+
+namespace Drivers
+{
+
+//! \brief Draws a row of 1 BPP pixels, held in words with the leftmost pixel as MSB.
+using BitRowDraw = void (*)(
+    void* aDisplayData,
+    int32_t aX,
+    int32_t aY,
+    int32_t aPixelCount,
+    std::span<const uint32_t> aBits,
+    uint32_t aColor,
+    std::optional<uint32_t> aBkColor
+) noexcept;
+
+
+//! \brief Glyphs rasterised once by grlib, then drawn a whole string row at a time.
+//! Glyphs are rasterised on first use, in a fixed arena of direct mapped slots.
+class GlyphCache final
+{
+public:
+    explicit GlyphCache(const tDisplay& aDisplay, BitRowDraw aBitRowDraw) noexcept;
+
+    //! \brief grlib string renderer, to set in tGrLibDefaults.
+    //! Strings drawn on the display of the last cache created go through its glyphs,
+    //! each row clipped to the context clip region.
+    //! Others, and the ones it can't draw (out of range characters, large glyphs,
+    //! long strings), go through GrDefaultStringRenderer().
+    static void StringRender(
+        const tContext* pContext,
+        const char* pcString,
+        int32_t i32Length,
+        int32_t i32X,
+        int32_t i32Y,
+        bool bOpaque
+    ) noexcept;
+
+    struct Stats
+    {
+        unsigned int mHits{};
+        unsigned int mMisses{};
+        unsigned int mFallbacks{};
+    };
+
+    [[nodiscard]] auto GetStats() const noexcept -> Stats {return mStats;}
+
+private:
+    // Printable ASCII characters.
+    static constexpr char sFirstChar{0x20};
+    static constexpr char sLastChar{0x7e};
+    static constexpr auto sCapacity{sLastChar - sFirstChar + 1};
+
+    static constexpr auto sMaxGlyphWidth{16};
+    static constexpr auto sMaxGlyphHeight{12};
+    static constexpr auto sMaxStringLength{40};
+    static constexpr auto sMaxStringWidth{256};
+
+    // Glyph rows are left aligned: MSB is the leftmost pixel.
+    using GlyphRow = uint16_t;
+    static_assert(sMaxGlyphWidth <= 16);
+
+    struct Glyph
+    {
+        const tFont* mFont{};
+        char mChar{};
+        uint8_t mWidth{};
+        uint8_t mHeight{};
+        std::array<GlyphRow, sMaxGlyphHeight> mRows{};
+    };
+
+    [[nodiscard]] auto Draw(
+        const tContext& aContext,
+        std::string_view aString,
+        int32_t aX,
+        int32_t aY,
+        bool aIsOpaque
+    ) noexcept -> bool;
+    static void ShiftLeft(std::span<uint32_t> aBits, int32_t aBitCount) noexcept;
+    [[nodiscard]] auto GetGlyph(const tFont* aFont, char aChar) noexcept -> const Glyph&;
+    static void Rasterise(Glyph& aGlyph) noexcept;
+
+    const tDisplay& mDisplay;
+    BitRowDraw mBitRowDraw;
+
+    std::array<Glyph, sCapacity> mGlyphs{};
+    Stats mStats{};
+
+    // grlib's string renderer has no user data: it goes through the last cache created.
+    static GlyphCache* sGlyphCache;
+};
+
+
+} // namespace Drivers
+
+// ******************************************************************************
+//                            EXPORTED VARIABLES
+// ******************************************************************************
+
+// ******************************************************************************
+//                                 EXTERNS
+// ******************************************************************************
+
+// ******************************************************************************
+//                            EXPORTED FUNCTIONS
+// ******************************************************************************
+
+// ******************************************************************************
+//                                END OF FILE
+// ******************************************************************************
+#endif // DRIVERS__GLYPHCACHE_H_
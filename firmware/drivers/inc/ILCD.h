@@ -25,6 +25,14 @@
 //                              INCLUDE FILES
 // ******************************************************************************
 
+// Standard Libraries.
+#include <cstddef>
+#include <cstdint>
+#include <span>
+
+// TivaWare Graphics Library.
+#include <grlib/grlib.h>
+
 // ******************************************************************************
 //                       DEFINED CONSTANTS AND MACROS
 // ******************************************************************************
@@ -47,6 +55,34 @@ public:
     virtual void DisplayOn() const = 0;
     virtual void DisplayOff() const = 0;
     virtual void Clear() = 0;
+
+    //! \brief Periodic upkeep of the panel, e.g. its COM inversion.
+    //! To call at a low, steady rate, whether or not anything gets drawn.
+    virtual void OnMaintenanceTick() = 0;
+
+    //! \brief Reports the completion of a write the LCD handed over to the bus owner.
+    virtual void OnSPIWrDone() = 0;
+
+    //! \brief Reports a write the bus owner dropped unsent: the LCD sends its content again,
+    //! at the latest on its next maintenance tick.
+    virtual void OnSPIWrFailed() = 0;
+
+    //! \brief Words of an overlay save buffer big enough for aRect, wherever it sits.
+    //! Each row saves the whole 32-bit words its pixels fall in.
+    [[nodiscard]] static constexpr auto GetOverlaySaveSize(const tRectangle& aRect) noexcept -> std::size_t
+    {
+        const auto lWidth{aRect.i16XMax - aRect.i16XMin + 1};
+        const auto lHeight{aRect.i16YMax - aRect.i16YMin + 1};
+        return static_cast<std::size_t>(((lWidth + 62) / 32) * lHeight);
+    }
+
+    //! \brief Saves the image under aRect in aSaveBuf, for a popup to be drawn over it.
+    //! aSaveBuf is the caller's, and must be kept until OverlayClose().
+    //! \return false when an overlay is open already, or aSaveBuf is too small.
+    [[nodiscard]] virtual auto OverlayOpen(const tRectangle& aRect, std::span<uint32_t> aSaveBuf) -> bool = 0;
+
+    //! \brief Restores the image saved under the overlay: only its lines are sent again.
+    virtual void OverlayClose() = 0;
 };
 
 
@@ -26,14 +26,17 @@
 // ******************************************************************************
 
 // Standard Libraries.
+#include <atomic>
 #include <cstddef>
 #include <cstdint>
+#include <optional>
 #include <span>
 
 // TivaWare Graphics Library.
 #include <grlib/grlib.h>
 
 #include "drivers/inc/ILCD.h"
+#include "drivers/inc/RLEImage.h"
 #include "corelink/inc/Types.h"
 
 // Standard library.
@@ -51,36 +54,207 @@ namespace Drivers
 {
 
 using GPIOOnOff = void (*)() noexcept;
+using FlushDone = void (*)() noexcept;
 
 
-//! \brief Non-Volatile Memory interface.
+//! \brief Sharp memory LCD driver, for an aWidth x aHeight panel.
+template<const int aWidth, const int aHeight>
 class LS013B7 final
     : public tDisplay
     , public ILCD
 {
 public:
+    //! \brief Interrupt driven SPI transmit, used by the asynchronous flush.
+    //! mBeginWr asserts CS. Once all is put, mTxEOTEnable(true) has the TX interrupt
+    //! fire when the last byte has shifted out: mEndWr then deasserts CS without waiting.
+    //! mStartWr, when set, is used instead of the others: it starts a whole transaction,
+    //! moved by DMA, whose completion is to be reported by OnSPIWrDone(),
+    //! or by OnSPIWrFailed() when the bus owner drops it unsent.
+    //! The bus can then be shared: Clear() queues its command rather than waiting for it.
+    //! A transaction mStartWr refuses, or one dropped, ends the flush, reported done: what it carried
+    //! is kept queued, and goes with the next flush of changed lines or maintenance tick.
+    //! It is not retried by a flush with nothing changed, so a bus refusing it is not polled.
+    //! mMaxWrSize, when not 0, is the most bytes mStartWr takes after the command byte:
+    //! longer runs of lines are sent as several transactions.
+    struct AsyncSPI
+    {
+        CoreLink::SPIAssert mBeginWr{};
+        CoreLink::SPIPut mPut{};
+        CoreLink::SPIAssert mEndWr{};
+        CoreLink::SPITxIntEnable mTxIntEnable{};
+        CoreLink::SPITxIntEnable mTxEOTEnable{};
+        CoreLink::SPIWrStart mStartWr{};
+        std::size_t mMaxWrSize{0};
+    };
+
+    explicit LS013B7(
+        CoreLink::SPIWr aSPIWr,
+        GPIOOnOff aGPIODisplayOn,
+        GPIOOnOff aGPIODisplayOff
+    ) noexcept;
+
+    //! \brief Asynchronous flush: lines are sent from the SPI TX interrupt.
+    //! aFlushDone is called from the interrupt once the transfer completes.
+    //! Drawing can go on meanwhile; lines drawn during the transfer are sent
+    //! by the next flush.
     explicit LS013B7(
-        CoreLink::SPIAssert aSPIAssert,
-        CoreLink::SPIAssert aSPIDeassert,
         CoreLink::SPIWr aSPIWr,
-        CoreLink::PushPullByte aPushPullByte,
+        AsyncSPI aAsyncSPI,
+        FlushDone aFlushDone,
         GPIOOnOff aGPIODisplayOn,
         GPIOOnOff aGPIODisplayOff
     ) noexcept;
 
+    //! \brief The size of a line packet, where a data update transaction can be split.
+    //! Each piece goes behind its own mode byte, closed by the byte following it.
+    static constexpr std::size_t sTxSplitSize{1 + aWidth / 8 + 1};
+    static constexpr std::size_t sTxSplitTail{1};
+
     // ILCD interface.
+    //! \brief Clears the panel synchronously: to call before the bus is shared.
     void Init() noexcept override;
     void DisplayOn() const noexcept override;
     void DisplayOff() const noexcept override;
     void Clear() noexcept override;
 
+    //! \brief Inverts the COM polarity, at least once every 2 ticks.
+    //! The inversion goes with the next data update when there is one:
+    //! a display mode packet is sent only when a whole tick period went
+    //! by without any. Meant to be called every 500 ms or so.
+    //! With the asynchronous flush, the packet completion is reported as a flush one.
+    void OnMaintenanceTick() noexcept override;
+
+    //! \brief SPI usage of the last Flush() call, plus the display mode packets sent since.
+    //! Transactions refused by mStartWr, or dropped by the bus owner, are counted apart, not as sent.
+    struct FlushStats
+    {
+        unsigned int mTransactions{};
+        unsigned int mBytes{};
+        unsigned int mLinesTouched{};
+        unsigned int mLinesChanged{};
+        unsigned int mLinesSent{};
+        unsigned int mRefusedWrs{};
+    };
+
+    [[nodiscard]] auto GetFlushStats() const noexcept -> FlushStats {return mFlushStats;}
+    [[nodiscard]] auto IsFlushBusy() const noexcept -> bool {return mIsTxBusy;}
+
+    //! \brief A line of the panel, as last flushed: what the panel shows.
+    //! Leftmost pixel as MSB, a cleared bit being a dark pixel.
+    [[nodiscard]] auto GetPanelLine(int32_t aRowIx) const noexcept -> std::span<const std::byte>;
+
+    //! \brief Whether the line was flushed with new content since the last call for it.
+    //! Lets a debug dump send only what changed. All lines are reported after a clear.
+    [[nodiscard]] auto TakeLineChanged(int32_t aRowIx) noexcept -> bool;
+
+    //! \brief To call from the SPI TX FIFO interrupt: refills the FIFO.
+    void OnSPITxReady() noexcept;
+
+    //! \brief To call once a transaction started by mStartWr completes: starts the next one.
+    void OnSPIWrDone() noexcept override;
+
+    //! \brief To call when a transaction started by mStartWr was dropped unsent:
+    //! ends the flush, its content queued again for the next flush of changed lines or maintenance tick.
+    void OnSPIWrFailed() noexcept override;
+
+    //! \brief Draws a row of 1 BPP pixels, held in words with the leftmost pixel as MSB.
+    //! Set bits are drawn in aColor, clear bits in aBkColor if any.
+    //! The row must be within the panel: it is not clipped.
+    void BitRowDraw(
+        int32_t aX,
+        int32_t aY,
+        int32_t aPixelCount,
+        std::span<const uint32_t> aBits,
+        uint32_t aColor,
+        std::optional<uint32_t> aBkColor
+    ) noexcept;
+
+    //! \brief Draws a run-length encoded image, each run filled as a span.
+    //! Set pixels are drawn in aColor, clear pixels in aBkColor if any.
+    //! The image is clipped to the panel.
+    void RLEImageDraw(
+        int32_t aX,
+        int32_t aY,
+        const RLEImage& aImage,
+        uint32_t aColor,
+        std::optional<uint32_t> aBkColor
+    ) noexcept;
+
+    //! \brief Saves the image under aRect in aSaveBuf, for a popup to be drawn over it.
+    //! A single overlay is open at once.
+    //! \return false when the area can't be saved: nothing is saved then.
+    [[nodiscard]] auto OverlayOpen(const tRectangle& aRect, std::span<uint32_t> aSaveBuf) noexcept -> bool override;
+
+    //! \brief Restores the pixels saved under the overlay, as they were at OverlayOpen().
+    //! Pixels out of the overlay area are left as drawn meanwhile.
+    //! Only the overlay lines are marked dirty.
+    void OverlayClose() noexcept override;
+
 private:
-    static constexpr auto sWidth{128};
-    static constexpr auto sHeight{128};
+    static constexpr auto sWidth{aWidth};
+    static constexpr auto sHeight{aHeight};
     static constexpr auto sPixelsPerByte{8};
+    static_assert(sWidth % sPixelsPerByte == 0);
+
+    // The gate line address is a single byte, numbered from 1.
+    static_assert((sHeight > 0) && (sHeight < 256));
     using Line = std::array<std::byte, sWidth / sPixelsPerByte>;
 
-    Line CreateRow(int32_t aX1, int32_t aX2, bool aIsActive) noexcept;
+    // Image lines are padded to whole words for the span kernels.
+    // Padding bytes are never drawn to, nor sent.
+    using Word = uint32_t;
+    static_assert(sizeof(Word) * 8 == 32, "ILCD sizes overlay save buffers in 32-bit words.");
+    static constexpr auto sPixelsPerWord{static_cast<int>(sizeof(Word)) * sPixelsPerByte};
+    static constexpr auto sWordsPerLine{(sWidth + sPixelsPerWord - 1) / sPixelsPerWord};
+    using ImgLine = std::array<std::byte, sWordsPerLine * sizeof(Word)>;
+
+    //! \brief A line, as sent in data update mode.
+    //! Data is kept in wire order: MSB is the leftmost pixel, and inverted.
+    //! The image buffer uses the same data format, plus padding.
+    struct LinePacket
+    {
+        std::byte mGateLine{};
+        Line mData{};
+        std::byte mDummy{};
+    };
+
+    // Data update packet sizes, in bytes.
+    // Each transaction is framed by the mode byte and a trailing dummy byte.
+    static constexpr auto sFrameSize{2};
+    static constexpr auto sLinePacketSize{static_cast<int>(sizeof(LinePacket))};
+    static_assert(sLinePacketSize == 1 + sizeof(Line) + 1);
+    static_assert(sLinePacketSize == sTxSplitSize);
+
+    [[nodiscard]] static constexpr auto PixelMask(const int32_t aColumnIx) noexcept -> std::byte
+    {
+        return std::byte{0x80} >> (aColumnIx % sPixelsPerByte);
+    }
+
+    // Span fill kernels.
+    // A span is processed as 32-bit words: a masked head word, solid middle words
+    // and a masked tail word. Masks are stored in memory order.
+    // The same span is applied to lines aY1 to aY2.
+    struct SpanMask
+    {
+        int32_t mHeadWordIx{};
+        int32_t mTailWordIx{};
+        Word mHeadMask{};
+        Word mTailMask{};
+    };
+
+    [[nodiscard]] static auto CreateSpanMask(int32_t aX1, int32_t aX2) noexcept -> SpanMask;
+    void FillSpan(int32_t aY1, int32_t aY2, const SpanMask& aSpanMask, bool aIsLit) noexcept;
+
+    // Line kernels of the span fills and bit rows.
+    static void FillLineSpan(std::byte* aData, const SpanMask& aSpanMask, bool aIsLit) noexcept;
+    static void MergeBitRow(
+        std::byte* aData,
+        int32_t aX,
+        int32_t aPixelCount,
+        std::span<const Word> aBits,
+        bool aIsLit,
+        std::optional<bool> aIsBkLit
+    ) noexcept;
 
     void PixelDraw(int32_t i32X, int32_t i32Y, uint32_t ui32Value) noexcept;
     void PixelDrawMultiple(
@@ -91,7 +265,16 @@ private:
         const uint8_t * const pui8Palette
     ) noexcept;
     void PixelDrawMultiple1BPP(
-        Line& aRow,
+        ImgLine& aRow,
+        const uint32_t aByteIndex,
+        uint32_t aBitIndex,
+        uint32_t aSourceBitIndex,
+        const int32_t aPixelCount,
+        const uint8_t *pui8Data,
+        const uint8_t *pui8Palette
+    ) noexcept;
+    void PixelDrawMultiple4BPP(
+        ImgLine& aRow,
         const uint32_t aByteIndex,
         uint32_t aBitIndex,
         uint32_t aSourceBitIndex,
@@ -100,7 +283,7 @@ private:
         const uint8_t *pui8Palette
     ) noexcept;
     void PixelDrawMultiple8BPP(
-        Line& aRow,
+        ImgLine& aRow,
         const uint32_t aByteIndex,
         uint32_t aBitIndex,
         uint32_t aSourceBitIndex,
@@ -109,30 +292,132 @@ private:
         const uint8_t *pui8Palette
     ) noexcept;
 
+    // 8 BPP palette resolved to monochrome: bit N is set when entry N is lit.
+    static constexpr auto sPalette8BPPSize{256};
+    using PaletteLitMap = std::array<uint32_t, sPalette8BPPSize / 32>;
+    auto GetPaletteLitMap(const uint8_t* aColorPalette) noexcept -> const PaletteLitMap&;
+
+    template<typename IsLitFct>
+    static void PackPixels(
+        ImgLine& aRow,
+        uint32_t aByteIndex,
+        uint32_t aBitIndex,
+        int32_t aPixelCount,
+        IsLitFct&& aIsLit
+    ) noexcept;
+
+    //! \brief One bit per line, scanned a word at a time.
+    class LineSet
+    {
+    public:
+        void Set(int32_t aRowIx) noexcept;
+        void Set(int32_t aFirstRowIx, int32_t aLastRowIx) noexcept;
+        void Reset(int32_t aFirstRowIx, int32_t aLastRowIx) noexcept;
+        void Clear() noexcept {mWords.fill(0);}
+
+        //! \brief The first line in the set from aRowIx, or sHeight if none.
+        [[nodiscard]] auto FindNext(int32_t aRowIx) const noexcept -> int32_t;
+
+    private:
+        static constexpr auto sLinesPerWord{32};
+        [[nodiscard]] static auto RangeMask(int32_t aWordIx, int32_t aFirstRowIx, int32_t aLastRowIx) noexcept
+            -> uint32_t;
+        std::array<uint32_t, (sHeight + sLinesPerWord - 1) / sLinesPerWord> mWords{};
+    };
+
     void LineDrawH(int32_t i32X1, int32_t i32X2, int32_t i32Y, uint32_t ui32Value) noexcept;
     void LineDrawV(int32_t i32X, int32_t i32Y1, int32_t i32Y2, uint32_t ui32Value) noexcept;
     void RectFill(const tRectangle *psRect, uint32_t ui32Value) noexcept;
     auto ColorTranslate(uint32_t ui32Value) noexcept -> uint32_t;
     void Flush() noexcept;
 
-    void SetDisplayMode() noexcept;
-    void SetAllClrMode() noexcept;
-    void SetDataUpdateMode(uint8_t aRow, std::span<const std::byte> aSpan) noexcept;
-    void SetDataUpdateModeMultiple(uint8_t aStartRowIndex, uint8_t aEndRowIndex) noexcept;
+    //! \brief Consecutive lines sent in a single transaction.
+    struct Run
+    {
+        int32_t mStartRowIx{};
+        int32_t mEndRowIx{};
+    };
+
+    [[nodiscard]] auto FindRun(int32_t aRowIx) noexcept -> std::optional<Run>;
+    [[nodiscard]] auto GetRunPackets(const Run& aRun) noexcept -> std::span<const std::byte>;
+    void StartTx() noexcept;
+    [[nodiscard]] auto NextTx() noexcept -> bool;
+    [[nodiscard]] auto StartNextTx() noexcept -> bool;
+    void RequeueTx() noexcept;
+    [[nodiscard]] auto IsTxPending() const noexcept -> bool;
+    void WaitTxDone() const noexcept;
+    void TakeVCOMInversion() noexcept;
+    void TakePanelClear() noexcept;
+
+    void SetAllClrMode(bool aIsQueued) noexcept;
 
-    CoreLink::SPIAssert mSPIAssert;
-    CoreLink::SPIAssert mSPIDeassert;
     CoreLink::SPIWr mSPIWr;
-    CoreLink::PushPullByte mSPIPushPullByte;
+    AsyncSPI mAsyncSPI;
+    FlushDone mFlushDone;
 
     GPIOOnOff mGPIODisplayOn;
     GPIOOnOff mGPIODisplayOff;
 
-    std::array<Line, sHeight> mImgBuf;
-    std::array<bool, sHeight> mIsLineDirty;
+    // The image drawn into, and the lines touched since the last flush.
+    alignas(Word) std::array<ImgLine, sHeight> mImgBuf;
+    LineSet mIsLineDirty;
+
+    // The panel content as last transmitted, stored as the packets sent:
+    // one per line, plus one whose gate line byte serves as the
+    // closing dummy byte of a run ending on the last line.
+    // It is also the transmit buffer: it is left alone while a transfer is in flight.
+    std::array<LinePacket, sHeight + 1> mPanelBuf;
+
+    // Changed lines copied to the panel buffer, not sent yet.
+    LineSet mIsLineQueued;
+
+    // Lines whose panel content changed since last taken by TakeLineChanged().
+    LineSet mIsLineChangedSinceTaken;
+
+    // Asynchronous transfer state: the transaction being sent, and the next line to look at.
+    std::atomic<bool> mIsTxBusy{false};
+    bool mIsTxCmdPending{false};
+    bool mIsTxDraining{false};
+    bool mIsDisplayModePending{false};
+    bool mIsAllClrModePending{false};
+    std::byte mTxCmd{};
+    std::span<const std::byte> mTxData{};
+    std::array<std::span<const std::byte>, 2> mTxSegments{};
+    std::optional<Run> mTxRun{};
+    int32_t mTxRowIx{};
+
+    // A refused or dropped transaction is queued again, to retry on the next maintenance tick
+    // unless a flush of changed lines sends it first.
+    bool mIsRetryDeferred{false};
+
+    // The panel buffer and the queued lines, to clear once the all-clear command starts.
+    bool mIsPanelClearDue{false};
+
+    // The COM polarity flag of the mode bytes, and whether an inversion is due.
+    std::byte mVCOM{};
+    bool mIsVCOMInversionDue{false};
+
+    FlushStats mFlushStats{};
+
+    // The open overlay, clipped to the panel, and the caller's buffer of the image it covers:
+    // the words it covers, row by row.
+    std::optional<tRectangle> mOverlayRect{};
+    std::span<Word> mOverlaySaved{};
+
+    // The last palette resolved, reused while the same one is passed: keyed on its address
+    // and entry count. Images sit in flash: a palette rewritten in place is not seen.
+    const uint8_t* mPaletteLitMapKey{nullptr};
+    uint32_t mPaletteLitMapSize{0};
+    PaletteLitMap mPaletteLitMap{};
 };
 
 
+// Sharp memory LCD panels.
+using LS013B7DH03 = LS013B7<128, 128>;
+using LS013B7DH05 = LS013B7<144, 168>;
+using LS027B7DH01 = LS013B7<400, 240>;
+
+
 } // namespace Drivers
 
 // ******************************************************************************
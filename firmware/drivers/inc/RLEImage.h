@@ -0,0 +1,119 @@
+#ifndef DRIVERS__RLEIMAGE_H_
+#define DRIVERS__RLEIMAGE_H_
+// *******************************************************************************
+//
+// Project: Drivers.
+//
+// Module: RLEImage.
+//
+// *******************************************************************************
+
+//! \file
+//! \brief Run-length encoded 1 BPP images.
+//! \ingroup ext_peripherals
+
+// ******************************************************************************
+//
+//        Copyright (c) 2023, Martin Garon, All rights reserved.
+//
+// This source code is licensed under the GPL-3.0-style license found in the
+// LICENSE file in the root directory of this source tree.
+//
+// ******************************************************************************
+
+// ******************************************************************************
+//                              INCLUDE FILES
+// ******************************************************************************
+
+// Standard Libraries.
+#include <cstddef>
+#include <cstdint>
+#include <span>
+
+// ******************************************************************************
+//                       DEFINED CONSTANTS AND MACROS
+// ******************************************************************************
+
+// ******************************************************************************
+//                         TYPEDEFS AND STRUCTURES
+// ******************************************************************************
+
+namespace Drivers
+{
+
+
+//! \brief A 1 BPP image, as runs of pixels.
+//! Each row is a sequence of runs alternating between clear and set pixels,
+//! starting with clear pixels: a row starting with set pixels has an empty
+//! first run. The runs of a row add up to its width.
+//! A run shorter than sLongRunFlag takes a byte. Longer runs take 2 bytes,
+//! big endian, with sLongRunFlag set in the first.
+//! Built by the rle_encode host tool, also used by the LCD shell dump.
+struct RLEImage
+{
+    static constexpr uint8_t sLongRunFlag{0x80};
+    static constexpr int32_t sMaxRunLength{0x7fff};
+
+    uint16_t mWidth{};
+    uint16_t mHeight{};
+    std::span<const uint8_t> mData{};
+
+    //! \brief Reads the next run length, moving past it.
+    [[nodiscard]] static constexpr auto ReadRun(std::span<const uint8_t>& aData) noexcept -> int32_t
+    {
+        if (aData.empty()) {
+            return 0;
+        }
+
+        int32_t lRun{aData[0]};
+        if (((aData[0] & sLongRunFlag) == 0) || (aData.size() < 2)) {
+            aData = aData.subspan(1);
+            return lRun & ~sLongRunFlag;
+        }
+
+        lRun = ((lRun & ~sLongRunFlag) << 8) | aData[1];
+        aData = aData.subspan(2);
+        return lRun;
+    }
+
+    //! \brief Writes a run length, up to sMaxRunLength, the way ReadRun() reads it.
+    //! \return The count of bytes written, 0 when aData is too short.
+    [[nodiscard]] static constexpr auto WriteRun(const std::span<uint8_t> aData, const int32_t aRun) noexcept
+        -> std::size_t
+    {
+        if (aRun < sLongRunFlag) {
+            if (aData.empty()) {
+                return 0;
+            }
+            aData[0] = static_cast<uint8_t>(aRun);
+            return 1;
+        }
+
+        if (aData.size() < 2) {
+            return 0;
+        }
+        aData[0] = static_cast<uint8_t>((aRun >> 8) | sLongRunFlag);
+        aData[1] = static_cast<uint8_t>(aRun & 0xff);
+        return 2;
+    }
+};
+
+
+} // namespace Drivers
+
+// ******************************************************************************
+//                            EXPORTED VARIABLES
+// ******************************************************************************
+
+// ******************************************************************************
+//                                 EXTERNS
+// ******************************************************************************
+
+// ******************************************************************************
+//                            EXPORTED FUNCTIONS
+// ******************************************************************************
+
+// ******************************************************************************
+//                                END OF FILE
+// ******************************************************************************
+#endif // DRIVERS__RLEIMAGE_H_
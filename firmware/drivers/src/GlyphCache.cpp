@@ -0,0 +1,310 @@
+// *****************************************************************************
+//
+// Project: Component drivers.
+//
+// Module: GlyphCache.
+//
+// *******************************************************************************
+
+//! \file
+//! \brief Pre-rasterised glyph cache, for grlib string rendering.
+//! \ingroup ext_peripherals
+
+// *****************************************************************************
+//
+//        Copyright (c) 2023, Martin Garon, All rights reserved.
+//
+// This source code is licensed under the GPL-3.0-style license found in the
+// LICENSE file in the root directory of this source tree.
+//
+// *****************************************************************************
+
+// *****************************************************************************
+//                              INCLUDE FILES
+// *****************************************************************************
+
+// This project.
+#include "drivers/inc/GlyphCache.h"
+
+// STL.
+#include <algorithm>
+#include <cstring>
+
+// *****************************************************************************
+//                      DEFINED CONSTANTS AND MACROS
+// *****************************************************************************
+
+// *****************************************************************************
+//                         TYPEDEFS AND STRUCTURES
+// *****************************************************************************
+
+// *****************************************************************************
+//                            FUNCTION PROTOTYPES
+// *****************************************************************************
+
+// *****************************************************************************
+//                             GLOBAL VARIABLES
+// *****************************************************************************
+
+// *****************************************************************************
+//                            EXPORTED FUNCTIONS
+// *****************************************************************************
+
+namespace Drivers
+{
+
+
+GlyphCache* GlyphCache::sGlyphCache{nullptr};
+
+
+GlyphCache::GlyphCache(const tDisplay& aDisplay, const BitRowDraw aBitRowDraw) noexcept
+    : mDisplay{aDisplay}
+    , mBitRowDraw{aBitRowDraw}
+{
+    // Ctor body.
+    sGlyphCache = this;
+}
+
+
+void GlyphCache::StringRender(
+    const tContext* const pContext,
+    const char* const pcString,
+    const int32_t i32Length,
+    const int32_t i32X,
+    const int32_t i32Y,
+    const bool bOpaque
+) noexcept
+{
+    // A negative length is a NUL terminated string. Either way, it stops at a NUL.
+    auto lString{
+        (i32Length < 0) ?
+            std::string_view{pcString} :
+            std::string_view{pcString, static_cast<std::size_t>(i32Length)}
+    };
+    lString = lString.substr(0, lString.find('\0'));
+    if ((sGlyphCache == nullptr) || !sGlyphCache->Draw(*pContext, lString, i32X, i32Y, bOpaque)) {
+        if (sGlyphCache != nullptr) {
+            ++sGlyphCache->mStats.mFallbacks;
+        }
+        GrDefaultStringRenderer(pContext, pcString, i32Length, i32X, i32Y, bOpaque);
+    }
+}
+
+// *****************************************************************************
+//                              LOCAL FUNCTIONS
+// *****************************************************************************
+
+auto GlyphCache::Draw(
+    const tContext& aContext,
+    const std::string_view aString,
+    const int32_t aX,
+    const int32_t aY,
+    const bool aIsOpaque
+) noexcept -> bool
+{
+    if ((aContext.psDisplay != &mDisplay) || (aString.size() > sMaxStringLength)) {
+        return false;
+    }
+
+    // Gather the glyphs first: nothing is drawn unless the whole string can be.
+    std::array<const Glyph*, sMaxStringLength> lGlyphs{};
+    auto lWidth{0};
+    auto lHeight{0};
+    for (auto lCharIx{0U}; lCharIx < aString.size(); ++lCharIx) {
+        const auto lChar{aString[lCharIx]};
+        if ((lChar < sFirstChar) || (lChar > sLastChar)) {
+            return false;
+        }
+
+        const auto& lGlyph{GetGlyph(aContext.psFont, lChar)};
+        if ((lGlyph.mWidth > sMaxGlyphWidth) || (lGlyph.mHeight > sMaxGlyphHeight)) {
+            return false;
+        }
+        lGlyphs[lCharIx] = &lGlyph;
+        lWidth += lGlyph.mWidth;
+        lHeight = lGlyph.mHeight;
+    }
+
+    if ((lWidth == 0) || (lHeight == 0)) {
+        return true;
+    }
+
+    if (lWidth > sMaxStringWidth) {
+        return false;
+    }
+
+    // Clip to the visible columns and rows: nothing visible is still drawn.
+    const auto& lClip{aContext.sClipRegion};
+    const auto lX1{std::max<int32_t>(aX, lClip.i16XMin)};
+    const auto lX2{std::min<int32_t>(aX + lWidth - 1, lClip.i16XMax)};
+    const auto lRowIx1{std::max<int32_t>(lClip.i16YMin - aY, 0)};
+    const auto lRowIx2{std::min<int32_t>(lClip.i16YMax - aY, lHeight - 1)};
+    if ((lX1 > lX2) || (lRowIx1 > lRowIx2)) {
+        return true;
+    }
+    const auto lClippedWidth{lX2 - lX1 + 1};
+
+    // Assemble each row of the string in words, then draw its visible part at once.
+    const auto lBkColor{aIsOpaque ? std::optional{aContext.ui32Background} : std::nullopt};
+    for (auto lRowIx{lRowIx1}; lRowIx <= lRowIx2; ++lRowIx) {
+        std::array<uint32_t, sMaxStringWidth / 32> lBits{};
+        auto lBitIx{0};
+        for (auto lCharIx{0U}; lCharIx < aString.size(); ++lCharIx) {
+            const auto& lGlyph{*lGlyphs[lCharIx]};
+            const auto lRow{static_cast<uint32_t>(lGlyph.mRows[lRowIx]) << 16};
+            const auto lWordIx{lBitIx / 32};
+            const auto lOffset{lBitIx % 32};
+            lBits[lWordIx] |= lRow >> lOffset;
+            if (lOffset + lGlyph.mWidth > 32) {
+                lBits[lWordIx + 1] |= lRow << (32 - lOffset);
+            }
+            lBitIx += lGlyph.mWidth;
+        }
+
+        if (lX1 != aX) {
+            ShiftLeft(lBits, lX1 - aX);
+        }
+
+        mBitRowDraw(
+            mDisplay.pvDisplayData,
+            lX1, aY + lRowIx, lClippedWidth,
+            std::span{lBits}.first((lClippedWidth + 31) / 32),
+            aContext.ui32Foreground,
+            lBkColor
+        );
+    }
+
+    return true;
+}
+
+
+void GlyphCache::ShiftLeft(const std::span<uint32_t> aBits, const int32_t aBitCount) noexcept
+{
+    // Drops the leftmost pixels of a row: the next words fill in from the right.
+    const auto lWordCount{static_cast<int32_t>(aBits.size())};
+    const auto lWordShift{aBitCount / 32};
+    const auto lBitShift{aBitCount % 32};
+    for (auto lWordIx{0}; lWordIx < lWordCount; ++lWordIx) {
+        const auto lSrcIx{lWordIx + lWordShift};
+        const auto lWord{(lSrcIx < lWordCount) ? aBits[lSrcIx] : 0U};
+        const auto lNextWord{((lSrcIx + 1) < lWordCount) ? aBits[lSrcIx + 1] : 0U};
+        aBits[lWordIx] = (lBitShift == 0) ?
+            lWord :
+            ((lWord << lBitShift) | (lNextWord >> (32 - lBitShift)));
+    }
+}
+
+
+auto GlyphCache::GetGlyph(const tFont* const aFont, const char aChar) noexcept -> const Glyph&
+{
+    // One slot per character: a glyph of another font replaces it.
+    auto& lGlyph{mGlyphs[aChar - sFirstChar]};
+    if ((lGlyph.mFont == aFont) && (lGlyph.mChar == aChar)) {
+        ++mStats.mHits;
+        return lGlyph;
+    }
+
+    ++mStats.mMisses;
+    lGlyph = Glyph{.mFont{aFont}, .mChar{aChar}};
+    Rasterise(lGlyph);
+    return lGlyph;
+}
+
+
+void GlyphCache::Rasterise(Glyph& aGlyph) noexcept
+{
+    // Let grlib render the glyph on a display recording it in the glyph rows:
+    // every font format grlib supports is handled the same.
+    static constexpr auto sSetPixel{
+        [](void* const pvDisplayData, const int32_t i32X, const int32_t i32Y, const uint32_t ui32Value) noexcept
+        {
+            auto& lRow{static_cast<Glyph*>(pvDisplayData)->mRows[i32Y]};
+            const auto lMask{static_cast<GlyphRow>(0x8000 >> i32X)};
+            lRow = ui32Value ? (lRow | lMask) : (lRow & ~lMask);
+        }
+    };
+
+    tDisplay lRecorder{
+        .i32Size{sizeof(tDisplay)}
+        , .pvDisplayData{static_cast<void*>(&aGlyph)}
+        , .ui16Width{sMaxGlyphWidth}
+        , .ui16Height{sMaxGlyphHeight}
+        , .pfnPixelDraw{sSetPixel}
+        , .pfnPixelDrawMultiple{
+            [](
+                void* const pvDisplayData,
+                const int32_t i32X,
+                const int32_t i32Y,
+                const int32_t i32X0,
+                const int32_t i32Count,
+                const int32_t i32BPP,
+                const uint8_t* const pui8Data,
+                const uint8_t* const pui8Palette
+            ) noexcept
+            {
+                // Glyphs are 1 BPP, with a palette of translated colors.
+                if (i32BPP != 1) {
+                    return;
+                }
+                std::array<uint32_t, 2> lPalette{};
+                std::memcpy(lPalette.data(), pui8Palette, sizeof(lPalette));
+                for (auto lIx{0}; lIx < i32Count; ++lIx) {
+                    const auto lSourceBitIx{i32X0 + lIx};
+                    const auto lColorIx{(pui8Data[lSourceBitIx / 8] >> (7 - (lSourceBitIx % 8))) & 0x1};
+                    sSetPixel(pvDisplayData, i32X + lIx, i32Y, lPalette[lColorIx]);
+                }
+            }
+        }
+        , .pfnLineDrawH{
+            [](void* const pvDisplayData, const int32_t i32X1, const int32_t i32X2, const int32_t i32Y, const uint32_t ui32Value) noexcept
+            {
+                for (auto lX{i32X1}; lX <= i32X2; ++lX) {
+                    sSetPixel(pvDisplayData, lX, i32Y, ui32Value);
+                }
+            }
+        }
+        , .pfnLineDrawV{
+            [](void* const pvDisplayData, const int32_t i32X, const int32_t i32Y1, const int32_t i32Y2, const uint32_t ui32Value) noexcept
+            {
+                for (auto lY{i32Y1}; lY <= i32Y2; ++lY) {
+                    sSetPixel(pvDisplayData, i32X, lY, ui32Value);
+                }
+            }
+        }
+        , .pfnRectFill{
+            [](void* const pvDisplayData, const tRectangle* const psRect, const uint32_t ui32Value) noexcept
+            {
+                for (auto lY{psRect->i16YMin}; lY <= psRect->i16YMax; ++lY) {
+                    for (auto lX{psRect->i16XMin}; lX <= psRect->i16XMax; ++lX) {
+                        sSetPixel(pvDisplayData, lX, lY, ui32Value);
+                    }
+                }
+            }
+        }
+        , .pfnColorTranslate{
+            [](void* const /*pvDisplayData*/, const uint32_t ui32Value) noexcept -> uint32_t
+            {
+                return (ui32Value != 0) ? 1 : 0;
+            }
+        }
+        , .pfnFlush{[](void* const /*pvDisplayData*/) noexcept {}}
+    };
+
+    tContext lContext{};
+    GrContextInit(&lContext, &lRecorder);
+    GrContextFontSet(&lContext, aGlyph.mFont);
+    GrContextForegroundSetTranslated(&lContext, 1);
+
+    aGlyph.mWidth = static_cast<uint8_t>(GrStringWidthGet(&lContext, &aGlyph.mChar, 1));
+    aGlyph.mHeight = static_cast<uint8_t>(GrFontHeightGet(aGlyph.mFont));
+    if ((aGlyph.mWidth <= sMaxGlyphWidth) && (aGlyph.mHeight <= sMaxGlyphHeight)) {
+        GrDefaultStringRenderer(&lContext, &aGlyph.mChar, 1, 0, 0, false);
+    }
+}
+
+
+} // namespace Drivers
+
+// *****************************************************************************
+//                                END OF FILE
+// *****************************************************************************
@@ -25,13 +25,14 @@
 
 // This project.
 #include "drivers/inc/LS013B7.h"
+#include "drivers/inc/BitOrder.h"
 
 // STL.
 #include <algorithm>
 #include <array>
+#include <bit>
 #include <cstddef>
-#include <functional>
-#include <numeric>
+#include <cstring>
 #include <ranges>
 
 // *****************************************************************************
@@ -46,25 +47,68 @@
 //                            FUNCTION PROTOTYPES
 // *****************************************************************************
 
-static constexpr std::array sSwappedNibbleLookup{
-    0x0, 0x8, 0x4, 0xc, 0x2, 0xa, 0x6, 0xe,
-    0x1, 0x9, 0x5, 0xd, 0x3, 0xb, 0x7, 0xf
-};
-
+// Gate line addresses are sent LSB first.
 static constexpr auto BitSwap(const uint8_t aByte) noexcept
 {
-    return std::byte(
-        static_cast<uint8_t>(
-            sSwappedNibbleLookup[aByte & 0b1111] << 4 |
-            sSwappedNibbleLookup[aByte >> 4]
-        )
-    );
+    return std::byte(static_cast<uint8_t>(Drivers::BitOrder::ReverseBitsInBytes(aByte)));
+}
+
+// Converts a word of pixels, leftmost pixel as MSB, to memory order.
+static constexpr auto ToMemoryOrder(const uint32_t aWord) noexcept
+{
+    if constexpr (std::endian::native == std::endian::little) {
+        return Drivers::BitOrder::ReverseBytes(aWord);
+    }
+    return aWord;
+}
+
+// Checks the word conversions against a bit swap by nibble lookup, for every
+// byte value in every byte of a word.
+static constexpr auto IsBitOrderValid() noexcept
+{
+    constexpr std::array lSwappedNibbleLookup{
+        0x0, 0x8, 0x4, 0xc, 0x2, 0xa, 0x6, 0xe,
+        0x1, 0x9, 0x5, 0xd, 0x3, 0xb, 0x7, 0xf
+    };
+
+    for (uint32_t lByte{0}; lByte < 256; ++lByte) {
+        const auto lSwapped{
+            static_cast<uint32_t>(lSwappedNibbleLookup[lByte & 0b1111] << 4 | lSwappedNibbleLookup[lByte >> 4])
+        };
+        for (auto lShift{0}; lShift < 32; lShift += 8) {
+            // Other bytes hold a pattern, so any crosstalk between bytes shows.
+            const auto lPattern{uint32_t{0x5a3cc3a5} & ~(uint32_t{0xff} << lShift)};
+            const auto lWord{lPattern | (lByte << lShift)};
+            if ((Drivers::BitOrder::ReverseBitsInBytes(lWord)
+                    != (Drivers::BitOrder::ReverseBitsInBytes(lPattern) | (lSwapped << lShift)))
+                || (Drivers::BitOrder::ReverseBits(lWord) != (Drivers::BitOrder::ReverseBits(lPattern) | (lSwapped << (24 - lShift))))
+                || (Drivers::BitOrder::ReverseBytes(lWord) != (Drivers::BitOrder::ReverseBytes(lPattern) | (lByte << (24 - lShift))))) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+static_assert(IsBitOrderValid());
+
+// Reads a 24-bit RGB palette entry.
+static constexpr auto GetPaletteEntry(const uint8_t* const aPalette, const uint32_t aColorIx) noexcept
+{
+    const auto lEntry{aPalette + aColorIx * 3};
+    return static_cast<uint32_t>(lEntry[0] | (lEntry[1] << 8) | (lEntry[2] << 16));
+}
+
+// The entry count of a 4 or 8 BPP palette. grlib passes it where it sits in the image,
+// behind the byte holding the index of its last entry.
+static constexpr auto GetPaletteSize(const uint8_t* const aPalette) noexcept
+{
+    return static_cast<uint32_t>(aPalette[-1]) + 1;
 }
 
 template<const int aSize>
 static constexpr auto FillGateLineLookup() noexcept
 {
-    const auto lGateLine{std::ranges::iota_view(1, aSize)};
+    const auto lGateLine{std::ranges::iota_view(1, aSize + 1)};
     std::array<std::byte, aSize> lGateLineLookup{};
     std::transform(
         lGateLine.begin(),
@@ -82,33 +126,29 @@ static constexpr auto FillGateLineLookup() noexcept
 //                             GLOBAL VARIABLES
 // *****************************************************************************
 
-static constexpr auto sGateLineLookup{FillGateLineLookup<128>()};
-
-static constexpr auto sSize{256};
-static constexpr auto sBitSwapLookup{
-    []() noexcept
-    {
-        const auto lBitSwap{std::ranges::iota_view(0, 255)};
-        std::array<std::byte, sSize> lBitSwapLookup{};
-        std::transform(
-            lBitSwap.begin(),
-            lBitSwap.end(),
-            lBitSwapLookup.begin(),
-            [](const auto lByte) noexcept
-            {
-                return ~BitSwap(lByte);
-            }
-        );
+template<const int aHeight>
+static constexpr auto sGateLineLookup{FillGateLineLookup<aHeight>()};
 
-        return lBitSwapLookup;
-    } ()
-};
+// Data bytes are kept inverted: a cleared pixel is a set bit.
+static constexpr std::byte sClearedByte{0xff};
 
 // 6-5-1 ) Data update mode (1 line).
 // 6-5-2 ) Data Update Mode (Multiple Lines)
 // Updates data of only one specified line. (M0=”H”, M2＝”L”)
 static constexpr std::byte sDataUpdateModeCmd{0x1 << 7};
 
+// 6-5-3 Display Mode
+// Maintains memory internal data (maintains current display). (M0=”L”, M2＝”L”)
+static constexpr std::array sDisplayModeCmd{std::byte{0x0}, std::byte{0x0}};
+
+// 6-5-4 All Clear Mode
+// Clears memory internal data and writes white on screen. (M0=”L”, M2＝”H”)
+static constexpr std::array sAllClrModeCmd{std::byte{0x1 << 5}, std::byte{}};
+
+// 6-5 ) M1: the COM polarity, taken by the panel from any mode byte.
+// Inverting it now and then keeps a DC bias off the liquid crystal.
+static constexpr std::byte sVCOMFlag{0x1 << 6};
+
 // *****************************************************************************
 //                            EXPORTED FUNCTIONS
 // *****************************************************************************
@@ -117,11 +157,23 @@ namespace Drivers
 {
 
 
-LS013B7::LS013B7(
-    const CoreLink::SPIAssert aSPIAssert,
-    const CoreLink::SPIAssert aSPIDeassert,
+template<const int aWidth, const int aHeight>
+LS013B7<aWidth, aHeight>::LS013B7(
+    const CoreLink::SPIWr aSPIWr,
+    GPIOOnOff aGPIODisplayOn,
+    GPIOOnOff aGPIODisplayOff
+) noexcept
+    : LS013B7{aSPIWr, AsyncSPI{}, nullptr, aGPIODisplayOn, aGPIODisplayOff}
+{
+    // Ctor body left empty.
+}
+
+
+template<const int aWidth, const int aHeight>
+LS013B7<aWidth, aHeight>::LS013B7(
     const CoreLink::SPIWr aSPIWr,
-    const CoreLink::PushPullByte aSPIPushPullByte,
+    const AsyncSPI aAsyncSPI,
+    const FlushDone aFlushDone,
     GPIOOnOff aGPIODisplayOn,
     GPIOOnOff aGPIODisplayOff
 ) noexcept
@@ -199,88 +251,492 @@ LS013B7::LS013B7(
             }
         }
     }
-    , mSPIAssert{aSPIAssert}
-    , mSPIDeassert{aSPIDeassert}
     , mSPIWr{aSPIWr}
-    , mSPIPushPullByte{aSPIPushPullByte}
+    , mAsyncSPI{aAsyncSPI}
+    , mFlushDone{aFlushDone}
     , mGPIODisplayOn{aGPIODisplayOn}
     , mGPIODisplayOff{aGPIODisplayOff}
-    , mImgBuf{std::byte{0}}
-    , mIsLineDirty{false}
+    , mImgBuf{}
+    , mIsLineDirty{}
+    , mPanelBuf{}
+    , mIsLineQueued{}
+    , mIsLineChangedSinceTaken{}
 {
     // Ctor body.
+    // Start from a cleared panel, and set the constant part of each line packet once.
+    for (auto lRowIx{0}; lRowIx < sHeight; ++lRowIx) {
+        mImgBuf[lRowIx].fill(sClearedByte);
+        mPanelBuf[lRowIx].mGateLine = sGateLineLookup<sHeight>[lRowIx];
+        mPanelBuf[lRowIx].mData.fill(sClearedByte);
+    }
 }
 
 
-void LS013B7::Init() noexcept
+template<const int aWidth, const int aHeight>
+void LS013B7<aWidth, aHeight>::Init() noexcept
 {
-    SetAllClrMode();
+    SetAllClrMode(false);
 }
 
 
-void LS013B7::DisplayOn() const noexcept
+template<const int aWidth, const int aHeight>
+void LS013B7<aWidth, aHeight>::DisplayOn() const noexcept
 {
     mGPIODisplayOn();
 }
 
 
-void LS013B7::DisplayOff() const noexcept
+template<const int aWidth, const int aHeight>
+void LS013B7<aWidth, aHeight>::DisplayOff() const noexcept
 {
     mGPIODisplayOff();
 }
 
 
-void LS013B7::Clear() noexcept
+template<const int aWidth, const int aHeight>
+void LS013B7<aWidth, aHeight>::Clear() noexcept
+{
+    // A shared bus cannot be waited for.
+    SetAllClrMode(mAsyncSPI.mStartWr != nullptr);
+}
+
+
+template<const int aWidth, const int aHeight>
+void LS013B7<aWidth, aHeight>::OnMaintenanceTick() noexcept
+{
+    // A data update sent since the last tick carried the inversion.
+    // Otherwise send it on its own, unless a transfer is in flight: it waits for the next tick then.
+    // What a refused or dropped transaction left queued is retried from here, once per tick.
+    if ((mIsVCOMInversionDue || IsTxPending()) && !mIsTxBusy) {
+        mIsRetryDeferred = false;
+        if (mIsVCOMInversionDue) {
+            mIsDisplayModePending = true;
+        }
+        TakeVCOMInversion();
+        mTxRowIx = 0;
+        StartTx();
+    }
+
+    mIsVCOMInversionDue = true;
+}
+
+
+template<const int aWidth, const int aHeight>
+auto LS013B7<aWidth, aHeight>::GetPanelLine(const int32_t aRowIx) const noexcept -> std::span<const std::byte>
+{
+    // Only read by the ISR: valid while a transfer is in flight.
+    return mPanelBuf[aRowIx].mData;
+}
+
+
+template<const int aWidth, const int aHeight>
+auto LS013B7<aWidth, aHeight>::TakeLineChanged(const int32_t aRowIx) noexcept -> bool
+{
+    // Changed lines are taken once a pending all-clear has cleared the panel buffer.
+    if (mIsPanelClearDue || (mIsLineChangedSinceTaken.FindNext(aRowIx) != aRowIx)) {
+        return false;
+    }
+
+    mIsLineChangedSinceTaken.Reset(aRowIx, aRowIx);
+    return true;
+}
+
+
+template<const int aWidth, const int aHeight>
+void LS013B7<aWidth, aHeight>::OnSPITxReady() noexcept
+{
+    // Keep the TX FIFO fed until the current transaction is queued, then wait for
+    // the end of transmission interrupt: the transaction is closed from it, and the
+    // next one opened. Returns whenever the FIFO is full, or the last bytes shift out.
+    while (mIsTxBusy) {
+        if (mIsTxDraining) {
+            mIsTxDraining = false;
+            mAsyncSPI.mTxEOTEnable(false);
+            mAsyncSPI.mEndWr();
+            if (!StartNextTx()) {
+                mAsyncSPI.mTxIntEnable(false);
+                mIsTxBusy = false;
+                if (mFlushDone != nullptr) {
+                    mFlushDone();
+                }
+            }
+            continue;
+        }
+
+        if (mIsTxCmdPending) {
+            if (mAsyncSPI.mPut(std::span{&mTxCmd, 1}) == 0) {
+                return;
+            }
+            mIsTxCmdPending = false;
+        }
+
+        mTxData = mTxData.subspan(mAsyncSPI.mPut(mTxData));
+        if (!mTxData.empty()) {
+            return;
+        }
+
+        mIsTxDraining = true;
+        mAsyncSPI.mTxEOTEnable(true);
+        return;
+    }
+}
+
+
+template<const int aWidth, const int aHeight>
+void LS013B7<aWidth, aHeight>::OnSPIWrDone() noexcept
+{
+    if (!StartNextTx()) {
+        mIsTxBusy = false;
+        if (mFlushDone != nullptr) {
+            mFlushDone();
+        }
+    }
+}
+
+
+template<const int aWidth, const int aHeight>
+void LS013B7<aWidth, aHeight>::OnSPIWrFailed() noexcept
+{
+    // As for a transaction mStartWr refuses: sent by the next flush of changed lines,
+    // or the next maintenance tick.
+    RequeueTx();
+    mIsTxBusy = false;
+    if (mFlushDone != nullptr) {
+        mFlushDone();
+    }
+}
+
+
+template<const int aWidth, const int aHeight>
+void LS013B7<aWidth, aHeight>::BitRowDraw(
+    const int32_t aX,
+    const int32_t aY,
+    const int32_t aPixelCount,
+    const std::span<const uint32_t> aBits,
+    const uint32_t aColor,
+    const std::optional<uint32_t> aBkColor
+) noexcept
+{
+    const auto lIsBkLit{aBkColor ? std::optional{*aBkColor != 0} : std::nullopt};
+    MergeBitRow(mImgBuf[aY].data(), aX, aPixelCount, aBits, aColor != 0, lIsBkLit);
+    mIsLineDirty.Set(aY);
+}
+
+
+template<const int aWidth, const int aHeight>
+void LS013B7<aWidth, aHeight>::RLEImageDraw(
+    const int32_t aX,
+    const int32_t aY,
+    const RLEImage& aImage,
+    const uint32_t aColor,
+    const std::optional<uint32_t> aBkColor
+) noexcept
+{
+    const auto lX1{std::max<int32_t>(aX, 0)};
+    const auto lX2{std::min<int32_t>(aX + aImage.mWidth - 1, sWidth - 1)};
+    if (lX1 > lX2) {
+        return;
+    }
+
+    // Runs of set pixels are OR'ed as span masks into a row of words, in memory order.
+    // The row is then merged in the image line at once, like BitRowDraw().
+    // Rows and runs out of the panel are decoded, but not drawn.
+    const auto lCoveredMask{CreateSpanMask(lX1, lX2)};
+    const auto lIsBkLit{aBkColor.value_or(0) != 0};
+    auto lData{aImage.mData};
+    for (auto lRowIx{0}; lRowIx < aImage.mHeight; ++lRowIx) {
+        std::array<Word, sWordsPerLine> lSetWords{};
+        auto lX{aX};
+        auto lIsSet{false};
+        for (auto lPixelCount{0}; lPixelCount < aImage.mWidth; lIsSet = !lIsSet) {
+            const auto lRun{std::min<int32_t>(RLEImage::ReadRun(lData), aImage.mWidth - lPixelCount)};
+            if ((lRun == 0) && lData.empty()) {
+                return;
+            }
+
+            const auto lRunX1{std::max<int32_t>(lX, lX1)};
+            const auto lRunX2{std::min<int32_t>(lX + lRun - 1, lX2)};
+            if (lIsSet && (lRunX1 <= lRunX2)) {
+                const auto lSpanMask{CreateSpanMask(lRunX1, lRunX2)};
+                if (lSpanMask.mHeadWordIx == lSpanMask.mTailWordIx) {
+                    lSetWords[lSpanMask.mHeadWordIx] |= lSpanMask.mHeadMask & lSpanMask.mTailMask;
+                }
+                else {
+                    lSetWords[lSpanMask.mHeadWordIx] |= lSpanMask.mHeadMask;
+                    for (auto lWordIx{lSpanMask.mHeadWordIx + 1}; lWordIx < lSpanMask.mTailWordIx; ++lWordIx) {
+                        lSetWords[lWordIx] = ~Word{0};
+                    }
+                    lSetWords[lSpanMask.mTailWordIx] |= lSpanMask.mTailMask;
+                }
+            }
+
+            lX += lRun;
+            lPixelCount += lRun;
+        }
+
+        const auto lY{aY + lRowIx};
+        if ((lY < 0) || (lY >= sHeight)) {
+            continue;
+        }
+
+        const auto lLineData{mImgBuf[lY].data()};
+        for (auto lWordIx{lCoveredMask.mHeadWordIx}; lWordIx <= lCoveredMask.mTailWordIx; ++lWordIx) {
+            auto lCovered{~Word{0}};
+            if (lWordIx == lCoveredMask.mHeadWordIx) {
+                lCovered &= lCoveredMask.mHeadMask;
+            }
+            if (lWordIx == lCoveredMask.mTailWordIx) {
+                lCovered &= lCoveredMask.mTailMask;
+            }
+
+            const auto lFg{lSetWords[lWordIx]};
+            const auto lBk{aBkColor ? (lCovered & ~lFg) : Word{0}};
+            const Word lClr{(aColor ? lFg : Word{0}) | (lIsBkLit ? lBk : Word{0})};
+            const Word lSet{(aColor ? Word{0} : lFg) | (lIsBkLit ? Word{0} : lBk)};
+
+            Word lWord{};
+            std::memcpy(&lWord, lLineData + lWordIx * sizeof(Word), sizeof(Word));
+            lWord = (lWord & ~lClr) | lSet;
+            std::memcpy(lLineData + lWordIx * sizeof(Word), &lWord, sizeof(Word));
+        }
+
+        mIsLineDirty.Set(lY);
+    }
+}
+
+
+template<const int aWidth, const int aHeight>
+auto LS013B7<aWidth, aHeight>::OverlayOpen(const tRectangle& aRect, const std::span<uint32_t> aSaveBuf) noexcept
+    -> bool
+{
+    const tRectangle lRect{
+        std::max<int16_t>(aRect.i16XMin, 0),
+        std::max<int16_t>(aRect.i16YMin, 0),
+        std::min<int16_t>(aRect.i16XMax, sWidth - 1),
+        std::min<int16_t>(aRect.i16YMax, sHeight - 1)
+    };
+    if (mOverlayRect || (lRect.i16XMin > lRect.i16XMax) || (lRect.i16YMin > lRect.i16YMax)) {
+        return false;
+    }
+
+    // Whole words are saved: the span masks select the covered pixels on restore.
+    const auto lSpanMask{CreateSpanMask(lRect.i16XMin, lRect.i16XMax)};
+    const auto lWordCount{static_cast<std::size_t>(lSpanMask.mTailWordIx - lSpanMask.mHeadWordIx + 1)};
+    if (lWordCount * (lRect.i16YMax - lRect.i16YMin + 1) > aSaveBuf.size()) {
+        return false;
+    }
+
+    mOverlaySaved = aSaveBuf;
+    auto lSaved{mOverlaySaved.data()};
+    for (auto lRowIx{lRect.i16YMin}; lRowIx <= lRect.i16YMax; ++lRowIx) {
+        std::memcpy(lSaved, mImgBuf[lRowIx].data() + lSpanMask.mHeadWordIx * sizeof(Word), lWordCount * sizeof(Word));
+        lSaved += lWordCount;
+    }
+
+    mOverlayRect = lRect;
+    return true;
+}
+
+
+template<const int aWidth, const int aHeight>
+void LS013B7<aWidth, aHeight>::OverlayClose() noexcept
 {
-    SetAllClrMode();
+    if (!mOverlayRect) {
+        return;
+    }
+
+    const auto& lRect{*mOverlayRect};
+    const auto lSpanMask{CreateSpanMask(lRect.i16XMin, lRect.i16XMax)};
+    auto lSaved{mOverlaySaved.data()};
+    for (auto lRowIx{lRect.i16YMin}; lRowIx <= lRect.i16YMax; ++lRowIx) {
+        const auto lData{mImgBuf[lRowIx].data()};
+        for (auto lWordIx{lSpanMask.mHeadWordIx}; lWordIx <= lSpanMask.mTailWordIx; ++lWordIx) {
+            auto lCovered{~Word{0}};
+            if (lWordIx == lSpanMask.mHeadWordIx) {
+                lCovered &= lSpanMask.mHeadMask;
+            }
+            if (lWordIx == lSpanMask.mTailWordIx) {
+                lCovered &= lSpanMask.mTailMask;
+            }
+
+            Word lWord{};
+            std::memcpy(&lWord, lData + lWordIx * sizeof(Word), sizeof(Word));
+            lWord = (lWord & ~lCovered) | (*lSaved & lCovered);
+            std::memcpy(lData + lWordIx * sizeof(Word), &lWord, sizeof(Word));
+            ++lSaved;
+        }
+    }
+
+    // The flush diff sends only the lines the popup had actually changed.
+    mIsLineDirty.Set(lRect.i16YMin, lRect.i16YMax);
+    mOverlayRect.reset();
+    mOverlaySaved = {};
 }
 
+
 // *****************************************************************************
 //                              LOCAL FUNCTIONS
 // *****************************************************************************
 
-LS013B7::Line LS013B7::CreateRow(const int32_t aX1, const int32_t aX2, const bool aIsActive) noexcept
+template<const int aWidth, const int aHeight>
+auto LS013B7<aWidth, aHeight>::CreateSpanMask(const int32_t aX1, const int32_t aX2) noexcept -> SpanMask
+{
+    static constexpr Word sAllOnes{~Word{0}};
+    return SpanMask{
+        .mHeadWordIx{aX1 / sPixelsPerWord},
+        .mTailWordIx{aX2 / sPixelsPerWord},
+        .mHeadMask{ToMemoryOrder(sAllOnes >> (aX1 % sPixelsPerWord))},
+        .mTailMask{ToMemoryOrder(sAllOnes << (sPixelsPerWord - 1 - (aX2 % sPixelsPerWord)))}
+    };
+}
+
+
+template<const int aWidth, const int aHeight>
+void LS013B7<aWidth, aHeight>::FillSpan(
+    const int32_t aY1,
+    const int32_t aY2,
+    const SpanMask& aSpanMask,
+    const bool aIsLit
+) noexcept
 {
-    Line lRow{std::byte{0}};
-    auto lBitIndex{aX1 % sPixelsPerByte};
+    for (auto lRowIx{aY1}; lRowIx <= aY2; ++lRowIx) {
+        FillLineSpan(mImgBuf[lRowIx].data(), aSpanMask, aIsLit);
+    }
 
-    for (auto lX{aX1}; lX <= aX2; ++lX) {
-        auto lByteIndex{lX / sPixelsPerByte};
-        lRow[lByteIndex] |= (std::byte{0x1} << lBitIndex);
-        ++lBitIndex;
-        if (lBitIndex >= sPixelsPerByte) {
-            lBitIndex = 0;
+    mIsLineDirty.Set(aY1, aY2);
+}
+
+
+template<const int aWidth, const int aHeight>
+void LS013B7<aWidth, aHeight>::FillLineSpan(
+    std::byte* const aData,
+    const SpanMask& aSpanMask,
+    const bool aIsLit
+) noexcept
+{
+    // Lit pixels are cleared bits: resolve the color into clear and set masks.
+    const auto lHeadMask{
+        (aSpanMask.mHeadWordIx == aSpanMask.mTailWordIx) ?
+            aSpanMask.mHeadMask & aSpanMask.mTailMask :
+            aSpanMask.mHeadMask
+    };
+    const auto lTailMask{aSpanMask.mTailMask};
+    const Word lHeadClr{aIsLit ? lHeadMask : Word{0}};
+    const Word lHeadSet{aIsLit ? Word{0} : lHeadMask};
+    const Word lTailClr{aIsLit ? lTailMask : Word{0}};
+    const Word lTailSet{aIsLit ? Word{0} : lTailMask};
+    const Word lSolidWord{aIsLit ? Word{0} : ~Word{0}};
+
+    // Access words through memcpy: it compiles to plain word accesses.
+    Word lWord{};
+    std::memcpy(&lWord, aData + aSpanMask.mHeadWordIx * sizeof(Word), sizeof(Word));
+    lWord = (lWord & ~lHeadClr) | lHeadSet;
+    std::memcpy(aData + aSpanMask.mHeadWordIx * sizeof(Word), &lWord, sizeof(Word));
+
+    if (aSpanMask.mHeadWordIx != aSpanMask.mTailWordIx) {
+        for (auto lWordIx{aSpanMask.mHeadWordIx + 1}; lWordIx < aSpanMask.mTailWordIx; ++lWordIx) {
+            std::memcpy(aData + lWordIx * sizeof(Word), &lSolidWord, sizeof(Word));
         }
+
+        std::memcpy(&lWord, aData + aSpanMask.mTailWordIx * sizeof(Word), sizeof(Word));
+        lWord = (lWord & ~lTailClr) | lTailSet;
+        std::memcpy(aData + aSpanMask.mTailWordIx * sizeof(Word), &lWord, sizeof(Word));
     }
+}
+
+
+template<const int aWidth, const int aHeight>
+void LS013B7<aWidth, aHeight>::MergeBitRow(
+    std::byte* const aData,
+    const int32_t aX,
+    const int32_t aPixelCount,
+    const std::span<const Word> aBits,
+    const bool aIsLit,
+    const std::optional<bool> aIsBkLit
+) noexcept
+{
+    // Realign the source on the image words: a window over 2 source words per image word.
+    // Lit pixels are cleared bits.
+    const auto lSpanMask{CreateSpanMask(aX, aX + aPixelCount - 1)};
+    const auto lShift{aX % sPixelsPerWord};
+    const auto lIsBkLit{aIsBkLit.value_or(false)};
+    Word lPrevious{0};
+    for (auto lWordIx{lSpanMask.mHeadWordIx}; lWordIx <= lSpanMask.mTailWordIx; ++lWordIx) {
+        const auto lSourceIx{static_cast<std::size_t>(lWordIx - lSpanMask.mHeadWordIx)};
+        const Word lSource{(lSourceIx < aBits.size()) ? aBits[lSourceIx] : Word{0}};
+        const Word lBits{(lShift == 0) ? lSource : ((lSource >> lShift) | (lPrevious << (sPixelsPerWord - lShift)))};
+        lPrevious = lSource;
+
+        auto lCovered{~Word{0}};
+        if (lWordIx == lSpanMask.mHeadWordIx) {
+            lCovered &= lSpanMask.mHeadMask;
+        }
+        if (lWordIx == lSpanMask.mTailWordIx) {
+            lCovered &= lSpanMask.mTailMask;
+        }
+
+        const auto lFg{ToMemoryOrder(lBits) & lCovered};
+        const auto lBk{aIsBkLit ? (lCovered & ~lFg) : Word{0}};
+        const Word lClr{(aIsLit ? lFg : Word{0}) | (lIsBkLit ? lBk : Word{0})};
+        const Word lSet{(aIsLit ? Word{0} : lFg) | (lIsBkLit ? Word{0} : lBk)};
 
-    if (!aIsActive) {
-        std::transform(
-            lRow.cbegin(), lRow.cend(),
-            lRow.begin(),
-            std::bit_not<>{}
-        );
+        Word lWord{};
+        std::memcpy(&lWord, aData + lWordIx * sizeof(Word), sizeof(Word));
+        lWord = (lWord & ~lClr) | lSet;
+        std::memcpy(aData + lWordIx * sizeof(Word), &lWord, sizeof(Word));
     }
-    return lRow;
 }
 
 
-void LS013B7::PixelDraw(
+template<const int aWidth, const int aHeight>
+template<typename IsLitFct>
+void LS013B7<aWidth, aHeight>::PackPixels(
+    ImgLine& aRow,
+    const uint32_t aByteIndex,
+    const uint32_t aBitIndex,
+    const int32_t aPixelCount,
+    IsLitFct&& aIsLit
+) noexcept
+{
+    // Assemble up to 8 pixels in a register, then merge them in the image byte at once.
+    // Lit pixels are cleared bits.
+    auto lByteIndex{aByteIndex};
+    auto lMask{std::byte{0x80} >> aBitIndex};
+    auto lPixelCount{aPixelCount};
+    while (lPixelCount) {
+        std::byte lCovered{0};
+        std::byte lLit{0};
+        for (; (lMask != std::byte{0}) && lPixelCount; lMask >>= 1, --lPixelCount) {
+            lCovered |= lMask;
+            if (aIsLit()) {
+                lLit |= lMask;
+            }
+        }
+
+        aRow[lByteIndex] = (aRow[lByteIndex] & ~lCovered) | (lCovered & ~lLit);
+        ++lByteIndex;
+        lMask = std::byte{0x80};
+    }
+}
+
+
+template<const int aWidth, const int aHeight>
+void LS013B7<aWidth, aHeight>::PixelDraw(
     const int32_t aColumnIndex,
     const int32_t aRowIndex,
     const uint32_t aColor
 ) noexcept
 {
-    auto& lRow{mImgBuf[aRowIndex]};
-    const auto lByteIndex{aColumnIndex / sPixelsPerByte};
-    const auto lBitIndex{aColumnIndex % sPixelsPerByte};
-    const auto lColorByte{std::byte{static_cast<uint8_t>(aColor ? 0x1 : 0x0)} << lBitIndex};
-    lRow[lByteIndex] = (lRow[lByteIndex] & ~std::byte{static_cast<uint8_t>(0x1 << lBitIndex)}) | lColorByte;
+    auto& lByte{mImgBuf[aRowIndex][aColumnIndex / sPixelsPerByte]};
+    const auto lMask{PixelMask(aColumnIndex)};
+    lByte = aColor ? (lByte & ~lMask) : (lByte | lMask);
 
-    mIsLineDirty[aRowIndex] = true;
+    mIsLineDirty.Set(aRowIndex);
 }
 
 
-void LS013B7::PixelDrawMultiple(
+template<const int aWidth, const int aHeight>
+void LS013B7<aWidth, aHeight>::PixelDrawMultiple(
     const int32_t aColumnIx,
     const int32_t aRowIx,
     const int32_t aX0,
@@ -290,6 +746,11 @@ void LS013B7::PixelDrawMultiple(
     const uint8_t* const aColorPalette
 ) noexcept
 {
+    // Nothing to draw: the span kernels assume at least one pixel.
+    if (aPixelCount <= 0) {
+        return;
+    }
+
     auto& lRow{mImgBuf[aRowIx]};
     const auto lByteIndex{aColumnIx / sPixelsPerByte};
     const auto lBitIndex{aColumnIx % sPixelsPerByte};
@@ -298,12 +759,15 @@ void LS013B7::PixelDrawMultiple(
     {
         case 1:
             PixelDrawMultiple1BPP(lRow, lByteIndex, lBitIndex, aX0, aPixelCount, aSourceData, aColorPalette);
-            mIsLineDirty[aRowIx] = true;
+            mIsLineDirty.Set(aRowIx);
+            break;
+        case 4:
+            PixelDrawMultiple4BPP(lRow, lByteIndex, lBitIndex, aX0, aPixelCount, aSourceData, aColorPalette);
+            mIsLineDirty.Set(aRowIx);
             break;
-        case 4: break;
         case 8:
             PixelDrawMultiple8BPP(lRow, lByteIndex, lBitIndex, aX0, aPixelCount, aSourceData, aColorPalette);
-            mIsLineDirty[aRowIx] = true;
+            mIsLineDirty.Set(aRowIx);
             break;
         default: // Invalid number of pixels per byte.
             break;
@@ -311,8 +775,9 @@ void LS013B7::PixelDrawMultiple(
 }
 
 
-void LS013B7::PixelDrawMultiple1BPP(
-    Line& aRow,
+template<const int aWidth, const int aHeight>
+void LS013B7<aWidth, aHeight>::PixelDrawMultiple1BPP(
+    ImgLine& aRow,
     const uint32_t aByteIndex,
     const uint32_t aBitIndex,
     const uint32_t aSourceBitIndex,
@@ -321,42 +786,81 @@ void LS013B7::PixelDrawMultiple1BPP(
     const uint8_t* const aColorPalette
 ) noexcept
 {
-    auto lImgByteIndex{aByteIndex};
-    auto lImgBitIndex{static_cast<uint8_t>(7 - (aBitIndex & 0x7))};
-    auto lSourceBitIndex{static_cast<uint8_t>(aSourceBitIndex)};
-    auto lPixelCount{aPixelCount};
-    auto lSourceData{aSourceData};
-    while (lPixelCount) {
-        const std::byte lSourcePixelByte{*lSourceData};
-        ++lSourceData;
-
-        std::byte lImgByte{aRow[lImgByteIndex]};
-        for (; (lSourceBitIndex < 8) && lPixelCount; ++lSourceBitIndex, --lPixelCount) {
-            const auto lColorIndex{std::to_integer<bool>((lSourcePixelByte >> (7 - lSourceBitIndex)) & std::byte{1})};
-
-            lImgByte =
-                lColorIndex ?
-                    aColorPalette ?
-                        lImgByte | std::byte{static_cast<unsigned char>(1 << (7 - lImgBitIndex))} :
-                        lImgByte &~ std::byte{static_cast<unsigned char>(1 << (7 - lImgBitIndex))}
-                    :
-                    lImgByte;
-            aRow[lImgByteIndex] = lImgByte;
-
-            if (lImgBitIndex-- == 0) {
-                lImgBitIndex = 7;
-                ++lImgByteIndex;
-                lImgByte = aRow[lImgByteIndex];
-            }
+    // The palette holds the translated colors of source bits 0 and 1: black and white without one.
+    // Resolve it once into masks applied to whole bytes: lit pixels are cleared bits.
+    std::array<uint32_t, 2> lPalette{0, 1};
+    if (aColorPalette != nullptr) {
+        std::memcpy(lPalette.data(), aColorPalette, sizeof(lPalette));
+    }
+    const auto lIsLit0{lPalette[0] != 0};
+    const auto lIsLit1{lPalette[1] != 0};
+    const std::byte lAndMask{static_cast<uint8_t>((lIsLit0 != lIsLit1) ? 0xff : 0x00)};
+    const std::byte lXorMask{static_cast<uint8_t>(lIsLit0 ? 0x00 : 0xff)};
+
+    // Image bytes covered, with the masks of the partial head and tail bytes.
+    const auto lLastIx{(aBitIndex + aPixelCount - 1) / sPixelsPerByte};
+    const auto lHeadMask{std::byte{0xff} >> aBitIndex};
+    const auto lTailMask{std::byte{0xff} << (sPixelsPerByte - 1 - (aBitIndex + aPixelCount - 1) % sPixelsPerByte)};
+    const auto lMerge{
+        [&aRow, lAndMask, lXorMask](const uint32_t aImgByteIx, const std::byte aSource, const std::byte aMask) noexcept
+        {
+            const auto lWire{(aSource & lAndMask) ^ lXorMask};
+            aRow[aImgByteIx] = (aRow[aImgByteIx] & ~aMask) | (lWire & aMask);
+        }
+    };
+
+    // Source bit aligned on the first image byte: the source byte index and bit shift.
+    // The first image byte may start before the source data.
+    const auto lOffset{static_cast<int32_t>(aSourceBitIndex) - static_cast<int32_t>(aBitIndex)};
+    const auto lShift{lOffset & 0x7};
+    const auto lSourceIx{(lOffset - lShift) / 8};
+
+    if (lShift == 0) {
+        // Byte-aligned: source bytes map 1:1 to image bytes.
+        const auto lSource{reinterpret_cast<const std::byte*>(aSourceData) + lSourceIx};
+        if (lLastIx == 0) {
+            lMerge(aByteIndex, lSource[0], lHeadMask & lTailMask);
+            return;
+        }
+
+        lMerge(aByteIndex, lSource[0], lHeadMask);
+        for (auto lIx{1U}; lIx < lLastIx; ++lIx) {
+            aRow[aByteIndex + lIx] = (lSource[lIx] & lAndMask) ^ lXorMask;
+        }
+        lMerge(aByteIndex + lLastIx, lSource[lLastIx], lTailMask);
+        return;
+    }
+
+    // Shift and merge: a window over 2 source bytes realigns each image byte.
+    // Bytes outside of the source data read as 0: they only land in masked bits.
+    const auto lLastSourceIx{(static_cast<int32_t>(aSourceBitIndex) + aPixelCount - 1) / 8};
+    const auto lGetSourceByte{
+        [aSourceData, lLastSourceIx](const int32_t aSourceIx) noexcept -> uint32_t
+        {
+            return ((aSourceIx >= 0) && (aSourceIx <= lLastSourceIx)) ? aSourceData[aSourceIx] : 0;
         }
+    };
+
+    uint32_t lWindow{lGetSourceByte(lSourceIx)};
+    for (auto lIx{0U}; lIx <= lLastIx; ++lIx) {
+        lWindow = (lWindow << 8) | lGetSourceByte(lSourceIx + lIx + 1);
+        const std::byte lSource{static_cast<uint8_t>(lWindow >> (8 - lShift))};
 
-        lSourceBitIndex = 0;
+        auto lMask{std::byte{0xff}};
+        if (lIx == 0) {
+            lMask &= lHeadMask;
+        }
+        if (lIx == lLastIx) {
+            lMask &= lTailMask;
+        }
+        lMerge(aByteIndex + lIx, lSource, lMask);
     }
 }
 
 
-void LS013B7::PixelDrawMultiple8BPP(
-    Line& aRow,
+template<const int aWidth, const int aHeight>
+void LS013B7<aWidth, aHeight>::PixelDrawMultiple4BPP(
+    ImgLine& aRow,
     const uint32_t aByteIndex,
     const uint32_t aBitIndex,
     const uint32_t aSourceBitIndex,
@@ -365,61 +869,99 @@ void LS013B7::PixelDrawMultiple8BPP(
     const uint8_t* aColorPalette
 ) noexcept
 {
-    auto lByteIndex{aByteIndex};
-    auto lBitIndex{static_cast<uint8_t>(aBitIndex)};
-    [[maybe_unused]] auto lSourceBitIndex{static_cast<uint8_t>(aSourceBitIndex)};
-    auto lPixelCount{aPixelCount};
-    auto lSourceData{aSourceData};
+    // Resolve the palette to monochrome once: bit N is set when entry N is lit.
+    // Only the entries it holds are read: indices past them are drawn unlit.
+    static constexpr auto sMaxColorCount{16U};
+    const auto lColorCount{std::min(GetPaletteSize(aColorPalette), sMaxColorCount)};
+    uint_fast16_t lLitMask{0};
+    for (auto lColorIx{0U}; lColorIx < lColorCount; ++lColorIx) {
+        if (ColorTranslate(GetPaletteEntry(aColorPalette, lColorIx))) {
+            lLitMask |= 1 << lColorIx;
+        }
+    }
 
-    while (lPixelCount) {
+    // Two pixels per source byte, upper nibble first.
+    // An odd source offset starts on the lower nibble.
+    auto lSourceData{aSourceData};
+    auto lIsLowNibble{(aSourceBitIndex & 0x1) != 0};
+    PackPixels(
+        aRow, aByteIndex, aBitIndex, aPixelCount,
+        [&lSourceData, &lIsLowNibble, lLitMask]() noexcept
+        {
+            const auto lColorIx{lIsLowNibble ? (*lSourceData & 0xf) : (*lSourceData >> 4)};
+            if (lIsLowNibble) {
+                ++lSourceData;
+            }
+            lIsLowNibble = !lIsLowNibble;
 
-        // Get the next byte of pixel data and extract the corresponding entry from the palette.
-        const auto lColorByte{std::byte{static_cast<uint8_t>(1 << lBitIndex)}};
-        const auto lColorIndex{*lSourceData * 3};
-        const auto lColorValue{*(reinterpret_cast<const uint32_t*>(aColorPalette + lColorIndex)) & 0x00FFFFFF};
+            return ((lLitMask >> lColorIx) & 0x1) != 0;
+        }
+    );
+}
 
-        aRow[lByteIndex] = (aRow[lByteIndex] & ~lColorByte)
-            | std::byte{static_cast<uint8_t>(ColorTranslate(lColorValue) << lBitIndex)};
 
-        if (--lBitIndex == 0) {
-            lBitIndex = 7;
+template<const int aWidth, const int aHeight>
+void LS013B7<aWidth, aHeight>::PixelDrawMultiple8BPP(
+    ImgLine& aRow,
+    const uint32_t aByteIndex,
+    const uint32_t aBitIndex,
+    [[maybe_unused]] const uint32_t aSourceBitIndex,
+    const int32_t aPixelCount,
+    const uint8_t* aSourceData,
+    const uint8_t* aColorPalette
+) noexcept
+{
+    // One byte per source pixel: test its bit in the resolved palette.
+    // Indices past the palette are drawn unlit.
+    const auto& lLitMap{GetPaletteLitMap(aColorPalette)};
+    auto lSourceData{aSourceData};
+    PackPixels(
+        aRow, aByteIndex, aBitIndex, aPixelCount,
+        [&lSourceData, &lLitMap]() noexcept
+        {
+            const auto lColorIx{*lSourceData};
             ++lSourceData;
+
+            return ((lLitMap[lColorIx / 32] >> (lColorIx % 32)) & 0x1) != 0;
         }
+    );
+}
 
-        --lPixelCount;
+
+template<const int aWidth, const int aHeight>
+auto LS013B7<aWidth, aHeight>::GetPaletteLitMap(const uint8_t* const aColorPalette) noexcept -> const PaletteLitMap&
+{
+    // Only the entries the palette holds are read.
+    const auto lColorCount{GetPaletteSize(aColorPalette)};
+    if ((aColorPalette != mPaletteLitMapKey) || (lColorCount != mPaletteLitMapSize)) {
+        mPaletteLitMap.fill(0);
+        for (auto lColorIx{0U}; lColorIx < lColorCount; ++lColorIx) {
+            if (ColorTranslate(GetPaletteEntry(aColorPalette, lColorIx))) {
+                mPaletteLitMap[lColorIx / 32] |= uint32_t{1} << (lColorIx % 32);
+            }
+        }
+        mPaletteLitMapKey = aColorPalette;
+        mPaletteLitMapSize = lColorCount;
     }
+
+    return mPaletteLitMap;
 }
 
 
-void LS013B7::LineDrawH(
+template<const int aWidth, const int aHeight>
+void LS013B7<aWidth, aHeight>::LineDrawH(
     const int32_t aX1,
     const int32_t aX2,
     const int32_t aRowIx,
     const uint32_t aColor
 ) noexcept
 {
-    auto& lRow{mImgBuf[aRowIx]};
-    if (aColor) {
-        const auto lNewRow{CreateRow(aX1, aX2, true)};
-        std::transform(
-            lNewRow.cbegin(), lNewRow.cend(),
-            lRow.cbegin(), lRow.begin(),
-            std::bit_or<>{}
-        );
-    }
-    else {
-        const auto lNewRow{CreateRow(aX1, aX2, false)};
-        std::transform(
-            lNewRow.cbegin(), lNewRow.cend(),
-            lRow.cbegin(), lRow.begin(),
-            std::bit_and<>{}
-        );
-    }
-    mIsLineDirty[aRowIx] = true;
+    FillSpan(aRowIx, aRowIx, CreateSpanMask(aX1, aX2), aColor);
 }
 
 
-void LS013B7::LineDrawV(
+template<const int aWidth, const int aHeight>
+void LS013B7<aWidth, aHeight>::LineDrawV(
     const int32_t aColumnIx,
     const int32_t aY1,
     const int32_t aY2,
@@ -427,43 +969,25 @@ void LS013B7::LineDrawV(
 ) noexcept
 {
     const auto lByteIx{aColumnIx / sPixelsPerByte};
-    const auto lBitIx{aColumnIx % sPixelsPerByte};
+    const auto lMask{PixelMask(aColumnIx)};
     for (auto lRowIx{aY1}; lRowIx <= aY2; ++lRowIx) {
-        auto& lRow{mImgBuf[lRowIx]};
-        lRow[lByteIx] |= (aColor ? std::byte{0x1} : std::byte{0x0}) << lBitIx;
-        mIsLineDirty[lRowIx] = true;
+        auto& lByte{mImgBuf[lRowIx][lByteIx]};
+        lByte = aColor ? (lByte & ~lMask) : (lByte | lMask);
     }
+    mIsLineDirty.Set(aY1, aY2);
 }
 
 
-void LS013B7::RectFill(const tRectangle* const aRectangle, const uint32_t aColor) noexcept
+template<const int aWidth, const int aHeight>
+void LS013B7<aWidth, aHeight>::RectFill(const tRectangle* const aRectangle, const uint32_t aColor) noexcept
 {
-    // Fill all the horizontal lines.
-    // Send all lines to display.
-    if (aColor) {
-        const auto lNewRow{CreateRow(aRectangle->i16XMin, aRectangle->i16XMax, true)};
-        for (auto lRowIx{aRectangle->i16YMin}; lRowIx <= aRectangle->i16YMax; ++lRowIx) {
-            auto& lRow{mImgBuf[lRowIx]};
-            std::transform(
-                lNewRow.cbegin(), lNewRow.cend(),
-                lRow.cbegin(), lRow.begin(),
-                std::bit_or<>{}
-            );
-            mIsLineDirty[lRowIx] = true;
-        }
-    }
-    else {
-        const auto lNewRow{CreateRow(aRectangle->i16XMin, aRectangle->i16XMax, false)};
-        for (auto lRowIx{aRectangle->i16YMin}; lRowIx <= aRectangle->i16YMax; ++lRowIx) {
-            auto& lRow{mImgBuf[lRowIx]};
-            std::transform(
-                lNewRow.cbegin(), lNewRow.cend(),
-                lRow.cbegin(), lRow.begin(),
-                std::bit_and<>{}
-            );
-            mIsLineDirty[lRowIx] = true;
-        }
-    }
+    // Fill all the horizontal lines with the same span.
+    FillSpan(
+        aRectangle->i16YMin,
+        aRectangle->i16YMax,
+        CreateSpanMask(aRectangle->i16XMin, aRectangle->i16XMax),
+        aColor
+    );
 }
 
 
@@ -482,7 +1006,8 @@ void LS013B7::RectFill(const tRectangle* const aRectangle, const uint32_t aColor
 // \return Returns the display-driver specific color.
 //
 //*****************************************************************************
-auto LS013B7::ColorTranslate(const uint32_t ui32Value) noexcept -> uint32_t
+template<const int aWidth, const int aHeight>
+auto LS013B7<aWidth, aHeight>::ColorTranslate(const uint32_t ui32Value) noexcept -> uint32_t
 {
     return (
         ((((ui32Value & 0x00ff0000) >> 16) * 19661) +
@@ -493,84 +1018,361 @@ auto LS013B7::ColorTranslate(const uint32_t ui32Value) noexcept -> uint32_t
 }
 
 
-void LS013B7::Flush() noexcept
+template<const int aWidth, const int aHeight>
+void LS013B7<aWidth, aHeight>::Flush() noexcept
 {
-    auto lRowIx{0};
-    for (auto& lIsDirty : mIsLineDirty) {
-        if (lIsDirty) {
-            SetDataUpdateMode(lRowIx, mImgBuf[lRowIx]);
-            lIsDirty = false;
+    // The panel buffer is being sent: touched lines stay dirty for the next flush.
+    if (mIsTxBusy) {
+        return;
+    }
+
+    // A pending all-clear command goes first: the lines changed since are compared to a cleared panel.
+    TakePanelClear();
+
+    // Drop touched lines whose content is what the panel already shows.
+    // Changed lines are copied in the panel buffer, to be sent from there.
+    mFlushStats = {};
+    for (auto lRowIx{mIsLineDirty.FindNext(0)}; lRowIx < sHeight; lRowIx = mIsLineDirty.FindNext(lRowIx + 1)) {
+        ++mFlushStats.mLinesTouched;
+        const auto& lImgLine{mImgBuf[lRowIx]};
+        auto& lPanelLine{mPanelBuf[lRowIx].mData};
+        if (std::memcmp(lImgLine.data(), lPanelLine.data(), lPanelLine.size()) != 0) {
+            ++mFlushStats.mLinesChanged;
+            std::memcpy(lPanelLine.data(), lImgLine.data(), lPanelLine.size());
+            mIsLineQueued.Set(lRowIx);
+            mIsLineChangedSinceTaken.Set(lRowIx);
         }
-        ++lRowIx;
     }
-    SetDisplayMode();
+    mIsLineDirty.Clear();
+
+    // Nothing changed: the bus is left alone, and there is no completion to report.
+    // The panel keeps its content on its own, bar the COM inversion of OnMaintenanceTick().
+    // What a refused or dropped transaction left queued waits for that tick too: retried from
+    // the flush its completion triggers, it would go back to the bus at once, as long as refused.
+    if ((mFlushStats.mLinesChanged == 0) && (mIsRetryDeferred || !IsTxPending())) {
+        return;
+    }
+
+    mIsRetryDeferred = false;
+    TakeVCOMInversion();
+    mTxRowIx = 0;
+    StartTx();
 }
 
 
-void LS013B7::SetDisplayMode() noexcept
+template<const int aWidth, const int aHeight>
+auto LS013B7<aWidth, aHeight>::FindRun(const int32_t aRowIx) noexcept -> std::optional<Run>
 {
-    // 6-5-3 Display Mode
-    // Maintains memory internal data (maintains current display). (M0=”L”, M2＝”L”)
-    static constexpr std::array sDisplayModeCmd{std::byte{0x0}, std::byte{0x0}};
+    // Group adjacent queued lines in runs sent within a single CS window.
+    // Clean gaps are never resent: closing and reopening the CS window costs about
+    // 2 byte-times at the panel bit rate (tsSCS + thSCS + twSCSL, ~10us) plus the frame bytes,
+    // which a single line packet outweighs at every supported width.
+    const auto lStartRowIx{mIsLineQueued.FindNext(aRowIx)};
+    if (lStartRowIx >= sHeight) {
+        return std::nullopt;
+    }
+
+    // Each line packet and the closing byte have to fit in what mStartWr takes.
+    const auto lMaxLineCount{
+        (mAsyncSPI.mMaxWrSize != 0)
+            ? std::max(static_cast<int32_t>((mAsyncSPI.mMaxWrSize - 1) / sLinePacketSize), int32_t{1})
+            : sHeight
+    };
+    auto lEndRowIx{lStartRowIx};
+    while ((lEndRowIx + 1 < sHeight) && (lEndRowIx + 1 - lStartRowIx < lMaxLineCount)
+        && (mIsLineQueued.FindNext(lEndRowIx + 1) == lEndRowIx + 1)) {
+        ++lEndRowIx;
+    }
 
-    mSPIWr(std::span{sDisplayModeCmd}, std::nullopt);
+    mIsLineQueued.Reset(lStartRowIx, lEndRowIx);
+    return Run{lStartRowIx, lEndRowIx};
 }
 
 
-void LS013B7::SetAllClrMode() noexcept
+template<const int aWidth, const int aHeight>
+auto LS013B7<aWidth, aHeight>::GetRunPackets(const Run& aRun) noexcept -> std::span<const std::byte>
 {
-    // 6-5-4 All Clear Mode
-    // Clears memory internal data and writes white on screen. (M0=”L”, M2＝”H”)
-    static constexpr std::array sClrCmd{std::byte{0x1 << 5}, std::byte{}};
+    // cmd, gateline, data,
+    // dummy (1), gateline, data
+    // ...
+    // dummy (1), gateline, data, dummy(2).
+    // The line packets are stored back to back in transmit order:
+    // the run is sent as is, closed by the byte following it.
+    const auto lLineCount{aRun.mEndRowIx - aRun.mStartRowIx + 1};
+    ++mFlushStats.mTransactions;
+    mFlushStats.mBytes += sFrameSize + lLineCount * sLinePacketSize;
+    mFlushStats.mLinesSent += lLineCount;
+
+    return std::as_bytes(std::span{mPanelBuf}.subspan(aRun.mStartRowIx, lLineCount + 1))
+        .first(lLineCount * sLinePacketSize + 1);
+}
 
-    mSPIWr(std::span{sClrCmd}, std::nullopt);
-    DisplayOn();
-    std::fill(mImgBuf.begin(), mImgBuf.end(), Line{});
+
+template<const int aWidth, const int aHeight>
+void LS013B7<aWidth, aHeight>::StartTx() noexcept
+{
+    // All paths send the same transactions, from the same state.
+    if ((mAsyncSPI.mPut == nullptr) && (mAsyncSPI.mStartWr == nullptr)) {
+        while (NextTx()) {
+            mSPIWr(mTxData, mTxCmd);
+        }
+        return;
+    }
+
+    // The DMA completion can come before the start returns.
+    // A refused start leaves nothing in flight: the flush is done, as far as it went.
+    if (mAsyncSPI.mStartWr != nullptr) {
+        mIsTxBusy = true;
+        if (!StartNextTx()) {
+            mIsTxBusy = false;
+            if (mFlushDone != nullptr) {
+                mFlushDone();
+            }
+        }
+        return;
+    }
+
+    // The TX interrupt fires as soon as it is enabled, the FIFO being empty.
+    static_cast<void>(StartNextTx());
+    mIsTxBusy = true;
+    mAsyncSPI.mTxIntEnable(true);
 }
 
 
-void LS013B7::SetDataUpdateMode(const uint8_t aRow, std::span<const std::byte> aSpan) noexcept
+template<const int aWidth, const int aHeight>
+auto LS013B7<aWidth, aHeight>::NextTx() noexcept -> bool
 {
-    // cmd, gateline, data, dummy bytes(2).
-    mSPIAssert();
+    // The clear command ahead of the lines drawn after it,
+    // then the queued runs from mTxRowIx, then the display mode command if pending.
+    mTxRun.reset();
+    if (mIsAllClrModePending) {
+        mIsAllClrModePending = false;
+        TakePanelClear();
+        mTxCmd = sAllClrModeCmd[0] | mVCOM;
+        mTxData = std::span{sAllClrModeCmd}.subspan(1);
+        ++mFlushStats.mTransactions;
+        mFlushStats.mBytes += sAllClrModeCmd.size();
+        return true;
+    }
 
-    mSPIPushPullByte(sDataUpdateModeCmd);
-    mSPIPushPullByte(sGateLineLookup[aRow]);
-    for (const auto lByte : aSpan) {
-        mSPIPushPullByte(sBitSwapLookup[std::to_integer<uint8_t>(lByte)]);
+    if (const auto lRun{FindRun(mTxRowIx)}) {
+        mTxRun = lRun;
+        mTxRowIx = lRun->mEndRowIx + 1;
+        mTxCmd = sDataUpdateModeCmd | mVCOM;
+        mTxData = GetRunPackets(*lRun);
+        return true;
     }
 
-    mSPIPushPullByte(std::byte{0xa5});
-    mSPIPushPullByte(std::byte{0});
+    if (mIsDisplayModePending) {
+        mIsDisplayModePending = false;
+        mTxCmd = sDisplayModeCmd[0] | mVCOM;
+        mTxData = std::span{sDisplayModeCmd}.subspan(1);
+        ++mFlushStats.mTransactions;
+        mFlushStats.mBytes += sDisplayModeCmd.size();
+        return true;
+    }
 
-    mSPIDeassert();
+    return false;
 }
 
 
-void LS013B7::SetDataUpdateModeMultiple(const uint8_t aStartRowIndex, const uint8_t aEndRowIndex) noexcept
+template<const int aWidth, const int aHeight>
+auto LS013B7<aWidth, aHeight>::StartNextTx() noexcept -> bool
 {
-    // cmd, gateline, data,
-    // dummy (1), gateline, data
-    // ...
-    // dummy (1), gateline, data, dummy(2).
-    mSPIAssert();
+    if (!NextTx()) {
+        return false;
+    }
 
-    mSPIPushPullByte(sDataUpdateModeCmd);
-    for (auto i{aStartRowIndex}; i <= aEndRowIndex; ++i) {
-        mSPIPushPullByte(sGateLineLookup[i]);
-        for (const auto lByte : mImgBuf[i]) {
-            mSPIPushPullByte(sBitSwapLookup[std::to_integer<uint8_t>(lByte)]);
+    // The command byte is sent ahead of the line packets.
+    if (mAsyncSPI.mStartWr != nullptr) {
+        mTxSegments = {std::span{&mTxCmd, 1}, mTxData};
+        if (!mAsyncSPI.mStartWr(mTxSegments)) {
+            RequeueTx();
+            return false;
         }
+        return true;
+    }
+
+    mIsTxCmdPending = true;
+    mAsyncSPI.mBeginWr();
+    return true;
+}
+
+
+template<const int aWidth, const int aHeight>
+void LS013B7<aWidth, aHeight>::RequeueTx() noexcept
+{
+    // The transaction was not sent: what it carries goes with the next one started.
+    // Its lines are still in the panel buffer, as the panel is to show them.
+    mIsRetryDeferred = true;
+    ++mFlushStats.mRefusedWrs;
+    --mFlushStats.mTransactions;
+    if (mTxRun) {
+        const auto lLineCount{mTxRun->mEndRowIx - mTxRun->mStartRowIx + 1};
+        mFlushStats.mBytes -= sFrameSize + lLineCount * sLinePacketSize;
+        mFlushStats.mLinesSent -= lLineCount;
+        mIsLineQueued.Set(mTxRun->mStartRowIx, mTxRun->mEndRowIx);
+        mTxRun.reset();
+    }
+    else if (mTxData.data() == std::next(sAllClrModeCmd.data())) {
+        mFlushStats.mBytes -= sAllClrModeCmd.size();
+        mIsAllClrModePending = true;
+    }
+    else {
+        mFlushStats.mBytes -= sDisplayModeCmd.size();
+        mIsDisplayModePending = true;
+    }
+}
+
+
+template<const int aWidth, const int aHeight>
+auto LS013B7<aWidth, aHeight>::IsTxPending() const noexcept -> bool
+{
+    return mIsAllClrModePending || mIsDisplayModePending || (mIsLineQueued.FindNext(0) < sHeight);
+}
+
+
+template<const int aWidth, const int aHeight>
+void LS013B7<aWidth, aHeight>::WaitTxDone() const noexcept
+{
+    while (mIsTxBusy) {
+        // Wait for the TX interrupt to complete the transfer.
+    }
+}
+
 
-        mSPIPushPullByte(std::byte{0x5a});
+template<const int aWidth, const int aHeight>
+void LS013B7<aWidth, aHeight>::TakeVCOMInversion() noexcept
+{
+    // Inverted by the transaction about to start, at most once per maintenance tick.
+    if (mIsVCOMInversionDue) {
+        mIsVCOMInversionDue = false;
+        mVCOM ^= sVCOMFlag;
     }
+}
 
-    mSPIPushPullByte(std::byte{0x00});
 
-    mSPIDeassert();
+template<const int aWidth, const int aHeight>
+void LS013B7<aWidth, aHeight>::TakePanelClear() noexcept
+{
+    // Cleared as the all-clear command starts, or ahead of the next flush if it is still pending:
+    // until then, a transaction in flight may be sending the queued lines from the panel buffer.
+    if (mIsPanelClearDue) {
+        mIsPanelClearDue = false;
+        for (auto lRowIx{0}; lRowIx < sHeight; ++lRowIx) {
+            mPanelBuf[lRowIx].mData.fill(sClearedByte);
+        }
+        mIsLineQueued.Clear();
+    }
 }
 
 
+template<const int aWidth, const int aHeight>
+void LS013B7<aWidth, aHeight>::SetAllClrMode(const bool aIsQueued) noexcept
+{
+    // Both the bus and the panel buffer are in use until the transfer completes.
+    mIsPanelClearDue = true;
+    if (!aIsQueued) {
+        WaitTxDone();
+        TakeVCOMInversion();
+        mSPIWr(std::span{sAllClrModeCmd}.subspan(1), sAllClrModeCmd[0] | mVCOM);
+        TakePanelClear();
+    }
+    DisplayOn();
+    for (auto lRowIx{0}; lRowIx < sHeight; ++lRowIx) {
+        mImgBuf[lRowIx].fill(sClearedByte);
+    }
+    mIsLineChangedSinceTaken.Set(0, sHeight - 1);
+
+    // Restoring what was under an overlay would bring back the cleared image.
+    mOverlayRect.reset();
+    mOverlaySaved = {};
+
+    // Queued: the command goes next, the transaction in flight if any completing first.
+    // Whatever lines it still sends from the panel buffer get cleared by it.
+    if (aIsQueued) {
+        mIsAllClrModePending = true;
+        if (!mIsTxBusy) {
+            TakeVCOMInversion();
+            mTxRowIx = 0;
+            StartTx();
+        }
+    }
+}
+
+
+template<const int aWidth, const int aHeight>
+void LS013B7<aWidth, aHeight>::LineSet::Set(const int32_t aRowIx) noexcept
+{
+    mWords[aRowIx / sLinesPerWord] |= uint32_t{1} << (aRowIx % sLinesPerWord);
+}
+
+
+template<const int aWidth, const int aHeight>
+void LS013B7<aWidth, aHeight>::LineSet::Set(const int32_t aFirstRowIx, const int32_t aLastRowIx) noexcept
+{
+    for (auto lWordIx{aFirstRowIx / sLinesPerWord}; lWordIx <= aLastRowIx / sLinesPerWord; ++lWordIx) {
+        mWords[lWordIx] |= RangeMask(lWordIx, aFirstRowIx, aLastRowIx);
+    }
+}
+
+
+template<const int aWidth, const int aHeight>
+void LS013B7<aWidth, aHeight>::LineSet::Reset(const int32_t aFirstRowIx, const int32_t aLastRowIx) noexcept
+{
+    for (auto lWordIx{aFirstRowIx / sLinesPerWord}; lWordIx <= aLastRowIx / sLinesPerWord; ++lWordIx) {
+        mWords[lWordIx] &= ~RangeMask(lWordIx, aFirstRowIx, aLastRowIx);
+    }
+}
+
+
+template<const int aWidth, const int aHeight>
+auto LS013B7<aWidth, aHeight>::LineSet::FindNext(const int32_t aRowIx) const noexcept -> int32_t
+{
+    if (aRowIx >= sHeight) {
+        return sHeight;
+    }
+
+    auto lWordIx{aRowIx / sLinesPerWord};
+    auto lWord{mWords[lWordIx] & (~uint32_t{0} << (aRowIx % sLinesPerWord))};
+    while (lWord == 0) {
+        ++lWordIx;
+        if (lWordIx == static_cast<int32_t>(mWords.size())) {
+            return sHeight;
+        }
+        lWord = mWords[lWordIx];
+    }
+
+    return lWordIx * sLinesPerWord + std::countr_zero(lWord);
+}
+
+
+template<const int aWidth, const int aHeight>
+auto LS013B7<aWidth, aHeight>::LineSet::RangeMask(
+    const int32_t aWordIx,
+    const int32_t aFirstRowIx,
+    const int32_t aLastRowIx
+) noexcept -> uint32_t
+{
+    // The bits of lines aFirstRowIx to aLastRowIx held by word aWordIx.
+    auto lMask{~uint32_t{0}};
+    if (aWordIx == aFirstRowIx / sLinesPerWord) {
+        lMask &= ~uint32_t{0} << (aFirstRowIx % sLinesPerWord);
+    }
+    if (aWordIx == aLastRowIx / sLinesPerWord) {
+        lMask &= ~uint32_t{0} >> (sLinesPerWord - 1 - (aLastRowIx % sLinesPerWord));
+    }
+
+    return lMask;
+}
+
+
+// Supported panels.
+template class LS013B7<128, 128>;
+template class LS013B7<144, 168>;
+template class LS013B7<400, 240>;
+
+
 } // namespace Drivers
 
 // *****************************************************************************
@@ -0,0 +1,298 @@
+// *******************************************************************************
+//
+// Project: Utils.
+//
+// Module: GUI.
+//
+// *******************************************************************************
+
+//! \file
+//! \brief Retained widgets, redrawn from damage rectangles.
+//! \ingroup utils
+
+// ******************************************************************************
+//
+//        Copyright (c) 2023, Martin Garon, All rights reserved.
+//
+// This source code is licensed under the GPL-3.0-style license found in the
+// LICENSE file in the root directory of this source tree.
+//
+// ******************************************************************************
+
+// *****************************************************************************
+//                              INCLUDE FILES
+// *****************************************************************************
+
+// This module.
+#include "utils/gui/Screen.h"
+
+// Standard libraries.
+#include <algorithm>
+
+// *****************************************************************************
+//                       DEFINED CONSTANTS AND MACROS
+// *****************************************************************************
+
+// *****************************************************************************
+//                         TYPEDEFS AND STRUCTURES
+// *****************************************************************************
+
+// *****************************************************************************
+//                            FUNCTION PROTOTYPES
+// *****************************************************************************
+
+[[nodiscard]] static auto IsOverlapping(const tRectangle& aRect1, const tRectangle& aRect2) noexcept -> bool;
+[[nodiscard]] static auto Union(const tRectangle& aRect1, const tRectangle& aRect2) noexcept -> tRectangle;
+[[nodiscard]] static auto Area(const tRectangle& aRect) noexcept -> int32_t;
+
+// *****************************************************************************
+//                             GLOBAL VARIABLES
+// *****************************************************************************
+
+namespace Utils::GUI
+{
+
+
+// Space between a list row outline and its text.
+static constexpr int16_t sTextMargin{2};
+
+// *****************************************************************************
+//                            EXPORTED FUNCTIONS
+// *****************************************************************************
+
+Screen::Screen(tContext& aContext) noexcept
+    : mContext{aContext}
+{
+    // Ctor body.
+}
+
+
+void Screen::Show(const std::span<Widget> aWidgets) noexcept
+{
+    mWidgets = aWidgets;
+    for (auto& lWidget : mWidgets) {
+        lWidget.mIsDirty = false;
+    }
+
+    // What was shown before is all gone: no point tracking finer.
+    mDamageCount = 0;
+    const auto& lDisplay{*mContext.psDisplay};
+    Invalidate(
+        tRectangle{
+            0, 0,
+            static_cast<int16_t>(lDisplay.ui16Width - 1),
+            static_cast<int16_t>(lDisplay.ui16Height - 1)
+        }
+    );
+}
+
+
+void Screen::Select(const std::size_t aWidgetIx, const bool aIsSelected) noexcept
+{
+    auto& lWidget{mWidgets[aWidgetIx]};
+    if (lWidget.mIsSelected != aIsSelected) {
+        lWidget.mIsSelected = aIsSelected;
+        lWidget.mIsDirty = true;
+    }
+}
+
+
+void Screen::SetText(const std::size_t aWidgetIx, const char* const aText) noexcept
+{
+    auto& lWidget{mWidgets[aWidgetIx]};
+    if (lWidget.mText != aText) {
+        lWidget.mText = aText;
+        lWidget.mIsDirty = true;
+    }
+}
+
+
+void Screen::Invalidate(const tRectangle& aRect) noexcept
+{
+    // Keep within the display.
+    const auto& lDisplay{*mContext.psDisplay};
+    tRectangle lRect{
+        std::max<int16_t>(aRect.i16XMin, 0),
+        std::max<int16_t>(aRect.i16YMin, 0),
+        std::min<int16_t>(aRect.i16XMax, static_cast<int16_t>(lDisplay.ui16Width - 1)),
+        std::min<int16_t>(aRect.i16YMax, static_cast<int16_t>(lDisplay.ui16Height - 1))
+    };
+    if ((lRect.i16XMin > lRect.i16XMax) || (lRect.i16YMin > lRect.i16YMax)) {
+        return;
+    }
+
+    // Overlapping damage is merged, so no area gets drawn twice.
+    // A merged rectangle can overlap others it didn't before: merge until none does.
+    for (;;) {
+        const auto lDamage{std::span{mDamage}.first(mDamageCount)};
+        const auto lOverlapping{
+            std::find_if(
+                lDamage.begin(), lDamage.end(),
+                [&lRect](const tRectangle& aDamage) noexcept {return IsOverlapping(aDamage, lRect);}
+            )
+        };
+        if (lOverlapping != lDamage.end()) {
+            lRect = Union(*lOverlapping, lRect);
+            RemoveDamage(*lOverlapping);
+            continue;
+        }
+
+        if (mDamageCount < mDamage.size()) {
+            mDamage[mDamageCount] = lRect;
+            ++mDamageCount;
+            return;
+        }
+
+        // Out of rectangles: merge with the one that grows the least.
+        const auto lGrowth{
+            [&lRect](const tRectangle& aDamage) noexcept {return Area(Union(aDamage, lRect)) - Area(aDamage);}
+        };
+        auto& lClosest{
+            *std::min_element(
+                mDamage.begin(), mDamage.end(),
+                [&lGrowth](const tRectangle& aDamage1, const tRectangle& aDamage2) noexcept
+                {
+                    return lGrowth(aDamage1) < lGrowth(aDamage2);
+                }
+            )
+        };
+        lRect = Union(lClosest, lRect);
+        RemoveDamage(lClosest);
+    }
+}
+
+
+auto Screen::IsDamaged() const noexcept -> bool
+{
+    return (mDamageCount != 0)
+        || std::any_of(
+            mWidgets.begin(), mWidgets.end(),
+            [](const Widget& aWidget) noexcept {return aWidget.mIsDirty;}
+        );
+}
+
+
+auto Screen::Render() noexcept -> unsigned int
+{
+    for (auto& lWidget : mWidgets) {
+        if (lWidget.mIsDirty) {
+            Invalidate(lWidget.mRect);
+            lWidget.mIsDirty = false;
+        }
+    }
+
+    // Each damaged area is cleared, then widgets it intersects drawn over, in order.
+    // Clipping to the area leaves the rest of the frame buffer, and its lines, untouched.
+    const auto lClipRegion{mContext.sClipRegion};
+    const auto lForeground{mContext.ui32Foreground};
+    auto lDrawCount{0U};
+    for (const auto& lDamage : std::span{mDamage}.first(mDamageCount)) {
+        GrContextClipRegionSet(&mContext, &lDamage);
+        GrContextForegroundSetTranslated(&mContext, mContext.ui32Background);
+        GrRectFill(&mContext, &lDamage);
+        GrContextForegroundSetTranslated(&mContext, lForeground);
+
+        for (const auto& lWidget : mWidgets) {
+            if (IsOverlapping(lWidget.mRect, lDamage)) {
+                DrawWidget(lWidget);
+                ++lDrawCount;
+            }
+        }
+    }
+
+    GrContextClipRegionSet(&mContext, &lClipRegion);
+    mDamageCount = 0;
+    return lDrawCount;
+}
+
+// *****************************************************************************
+//                              LOCAL FUNCTIONS
+// *****************************************************************************
+
+void Screen::RemoveDamage(tRectangle& aDamage) noexcept
+{
+    // Order doesn't matter: the last one takes its place.
+    aDamage = mDamage[mDamageCount - 1];
+    --mDamageCount;
+}
+
+
+void Screen::DrawWidget(const Widget& aWidget) noexcept
+{
+    const auto& lRect{aWidget.mRect};
+    const auto lForeground{mContext.ui32Foreground};
+    const auto lCenterX{(lRect.i16XMin + lRect.i16XMax) / 2};
+    const auto lCenterY{(lRect.i16YMin + lRect.i16YMax) / 2};
+
+    // Selected widgets are filled, their text drawn in the background color.
+    if (aWidget.mIsSelected) {
+        GrRectFill(&mContext, &lRect);
+        GrContextForegroundSetTranslated(&mContext, mContext.ui32Background);
+    }
+
+    switch (aWidget.mKind) {
+    case Widget::Kind::Frame:
+        // Title over the top outline, kept within the frame.
+        GrRectDraw(&mContext, &lRect);
+        GrStringDraw(
+            &mContext,
+            aWidget.mText, -1,
+            lCenterX - GrStringWidthGet(&mContext, aWidget.mText, -1) / 2,
+            lRect.i16YMin,
+            true
+        );
+        break;
+
+    case Widget::Kind::Label:
+        GrStringDraw(&mContext, aWidget.mText, -1, lRect.i16XMin, lRect.i16YMin, false);
+        break;
+
+    case Widget::Kind::Button:
+        GrRectDraw(&mContext, &lRect);
+        GrStringDrawCentered(&mContext, aWidget.mText, -1, lCenterX, lCenterY, false);
+        break;
+
+    case Widget::Kind::ListRow:
+        GrStringDraw(
+            &mContext,
+            aWidget.mText, -1,
+            lRect.i16XMin + sTextMargin,
+            lCenterY - static_cast<int32_t>(GrFontHeightGet(mContext.psFont) / 2),
+            false
+        );
+        break;
+    }
+
+    GrContextForegroundSetTranslated(&mContext, lForeground);
+}
+
+
+} // namespace Utils::GUI
+
+
+static auto IsOverlapping(const tRectangle& aRect1, const tRectangle& aRect2) noexcept -> bool
+{
+    return (aRect1.i16XMin <= aRect2.i16XMax) && (aRect2.i16XMin <= aRect1.i16XMax)
+        && (aRect1.i16YMin <= aRect2.i16YMax) && (aRect2.i16YMin <= aRect1.i16YMax);
+}
+
+
+static auto Union(const tRectangle& aRect1, const tRectangle& aRect2) noexcept -> tRectangle
+{
+    return tRectangle{
+        std::min(aRect1.i16XMin, aRect2.i16XMin),
+        std::min(aRect1.i16YMin, aRect2.i16YMin),
+        std::max(aRect1.i16XMax, aRect2.i16XMax),
+        std::max(aRect1.i16YMax, aRect2.i16YMax)
+    };
+}
+
+
+static auto Area(const tRectangle& aRect) noexcept -> int32_t
+{
+    return (aRect.i16XMax - aRect.i16XMin + 1) * (aRect.i16YMax - aRect.i16YMin + 1);
+}
+
+// *****************************************************************************
+//                                END OF FILE
+// *****************************************************************************
@@ -0,0 +1,125 @@
+#ifndef UTILS__GUI__SCREEN_H_
+#define UTILS__GUI__SCREEN_H_
+// *******************************************************************************
+//
+// Project: Utils.
+//
+// Module: GUI.
+//
+// *******************************************************************************
+
+//! \file
+//! \brief Retained widgets, redrawn from damage rectangles.
+//! \ingroup utils
+
+// ******************************************************************************
+//
+//        Copyright (c) 2023, Martin Garon, All rights reserved.
+//
+// This source code is licensed under the GPL-3.0-style license found in the
+// LICENSE file in the root directory of this source tree.
+//
+// ******************************************************************************
+
+// ******************************************************************************
+//                              INCLUDE FILES
+// ******************************************************************************
+
+// Standard libraries.
+#include <array>
+#include <cstddef>
+#include <span>
+
+// TivaWare Graphics Library.
+#include <grlib/grlib.h>
+
+// *****************************************************************************
+//                       DEFINED CONSTANTS AND MACROS
+// *****************************************************************************
+
+// *****************************************************************************
+//                         TYPEDEFS AND STRUCTURES
+// *****************************************************************************
+
+namespace Utils::GUI
+{
+
+
+//! \brief A widget of a screen: what it shows, and where.
+//! A widget draws within its rectangle only.
+struct Widget
+{
+    enum class Kind
+    {
+        Frame,      //!< Outline, with the text as opaque title.
+        Label,      //!< Text only.
+        Button,     //!< Outline and centered text, filled when selected.
+        ListRow     //!< Left aligned text, filled when selected.
+    };
+
+    Kind mKind{Kind::Label};
+    tRectangle mRect{};
+    const char* mText{""};
+    bool mIsSelected{false};
+
+    //! \brief Changed since the last render: its rectangle gets redrawn.
+    bool mIsDirty{true};
+};
+
+
+//! \brief Retained set of widgets, drawn in order.
+//! Changes only record damage rectangles. Render() then redraws, clipped to
+//! each damage rectangle, the widgets that intersect it.
+class Screen final
+{
+public:
+    explicit Screen(tContext& aContext) noexcept;
+
+    //! \brief Replaces the widgets shown. The whole display is damaged.
+    void Show(std::span<Widget> aWidgets) noexcept;
+
+    void Select(std::size_t aWidgetIx, bool aIsSelected) noexcept;
+    void SetText(std::size_t aWidgetIx, const char* aText) noexcept;
+
+    //! \brief Damages an area, e.g. one a widget no longer covers.
+    //! Damage rectangles never overlap: overlapping ones are merged.
+    void Invalidate(const tRectangle& aRect) noexcept;
+
+    [[nodiscard]] auto IsDamaged() const noexcept -> bool;
+
+    //! \brief Redraws the damaged areas.
+    //! \return The count of widgets drawn.
+    auto Render() noexcept -> unsigned int;
+
+private:
+    static constexpr std::size_t sMaxDamageCount{4};
+
+    void RemoveDamage(tRectangle& aDamage) noexcept;
+    void DrawWidget(const Widget& aWidget) noexcept;
+
+    tContext& mContext;
+    std::span<Widget> mWidgets{};
+
+    std::array<tRectangle, sMaxDamageCount> mDamage{};
+    std::size_t mDamageCount{0};
+};
+
+
+} // namespace Utils::GUI
+
+// *****************************************************************************
+//                            EXPORTED VARIABLES
+// *****************************************************************************
+
+// *****************************************************************************
+//                                 EXTERNS
+// *****************************************************************************
+
+// *****************************************************************************
+//                            EXPORTED FUNCTIONS
+// *****************************************************************************
+
+// *****************************************************************************
+//                                END OF FILE
+// *****************************************************************************
+#endif // UTILS__GUI__SCREEN_H_
@@ -0,0 +1,178 @@
+// *******************************************************************************
+//
+// Project: Utils.
+//
+// Module: GUI.
+//
+// *******************************************************************************
+
+//! \file
+//! \brief Clock and feeder status bar, redrawn by character cell.
+//! \ingroup utils
+
+// ******************************************************************************
+//
+//        Copyright (c) 2023, Martin Garon, All rights reserved.
+//
+// This source code is licensed under the GPL-3.0-style license found in the
+// LICENSE file in the root directory of this source tree.
+//
+// ******************************************************************************
+
+// *****************************************************************************
+//                              INCLUDE FILES
+// *****************************************************************************
+
+// This module.
+#include "utils/gui/StatusBar.h"
+
+// Standard libraries.
+#include <algorithm>
+
+// *****************************************************************************
+//                       DEFINED CONSTANTS AND MACROS
+// *****************************************************************************
+
+// *****************************************************************************
+//                         TYPEDEFS AND STRUCTURES
+// *****************************************************************************
+
+// *****************************************************************************
+//                            FUNCTION PROTOTYPES
+// *****************************************************************************
+
+static void PutTwoDigits(char* aCells, int64_t aValue) noexcept;
+
+// *****************************************************************************
+//                             GLOBAL VARIABLES
+// *****************************************************************************
+
+// *****************************************************************************
+//                            EXPORTED FUNCTIONS
+// *****************************************************************************
+
+namespace Utils::GUI
+{
+
+
+StatusBar::StatusBar(tContext& aContext, const int32_t aX, const int32_t aY) noexcept
+    : mContext{aContext}
+    , mX{aX}
+    , mY{aY}
+{
+    // Ctor body.
+}
+
+
+void StatusBar::Show() noexcept
+{
+    mRendered.fill('\0');
+    mIsShown = true;
+}
+
+
+void StatusBar::Hide() noexcept
+{
+    mIsShown = false;
+}
+
+
+void StatusBar::SetTime(const std::chrono::seconds aTime) noexcept
+{
+    mTime = aTime;
+}
+
+
+void StatusBar::SetNextFeedTime(const std::optional<std::chrono::minutes> aNextFeedTime) noexcept
+{
+    mNextFeedTime = aNextFeedTime;
+}
+
+
+void StatusBar::SetMotorOn(const bool aIsMotorOn) noexcept
+{
+    mIsMotorOn = aIsMotorOn;
+}
+
+
+auto StatusBar::IsDamaged() const noexcept -> bool
+{
+    return mIsShown && (Format() != mRendered);
+}
+
+
+auto StatusBar::Render() noexcept -> unsigned int
+{
+    if (!mIsShown) {
+        return 0;
+    }
+
+    // Each run of changed cells is drawn as one opaque string, over the previous characters.
+    const auto lCells{Format()};
+    const auto lCellWidth{GrStringWidthGet(&mContext, "0", 1)};
+    auto lDrawCount{0U};
+    for (auto lCellIx{0U}; lCellIx < lCells.size(); ) {
+        if (lCells[lCellIx] == mRendered[lCellIx]) {
+            ++lCellIx;
+            continue;
+        }
+
+        const auto lRunStart{lCellIx};
+        while ((lCellIx < lCells.size()) && (lCells[lCellIx] != mRendered[lCellIx])) {
+            ++lCellIx;
+        }
+        GrStringDraw(
+            &mContext,
+            &lCells[lRunStart], static_cast<int32_t>(lCellIx - lRunStart),
+            mX + static_cast<int32_t>(lRunStart) * lCellWidth,
+            mY,
+            true
+        );
+        lDrawCount += lCellIx - lRunStart;
+    }
+
+    mRendered = lCells;
+    return lDrawCount;
+}
+
+// *****************************************************************************
+//                              LOCAL FUNCTIONS
+// *****************************************************************************
+
+auto StatusBar::Format() const noexcept -> Cells
+{
+    Cells lCells{};
+    std::copy_n("00:00:00  --:-- OFF", lCells.size(), lCells.begin());
+
+    const auto lTimeOfDay{mTime % std::chrono::days{1}};
+    PutTwoDigits(&lCells[0], std::chrono::duration_cast<std::chrono::hours>(lTimeOfDay).count());
+    PutTwoDigits(&lCells[3], std::chrono::duration_cast<std::chrono::minutes>(lTimeOfDay % std::chrono::hours{1}).count());
+    PutTwoDigits(&lCells[6], (lTimeOfDay % std::chrono::minutes{1}).count());
+
+    if (mNextFeedTime) {
+        const auto lNextFeedTime{*mNextFeedTime % std::chrono::days{1}};
+        lCells[9] = '>';
+        PutTwoDigits(&lCells[10], std::chrono::duration_cast<std::chrono::hours>(lNextFeedTime).count());
+        PutTwoDigits(&lCells[13], (lNextFeedTime % std::chrono::hours{1}).count());
+    }
+
+    if (mIsMotorOn) {
+        std::copy_n("ON ", 3, &lCells[16]);
+    }
+
+    return lCells;
+}
+
+
+} // namespace Utils::GUI
+
+
+static void PutTwoDigits(char* const aCells, const int64_t aValue) noexcept
+{
+    aCells[0] = static_cast<char>('0' + (aValue / 10) % 10);
+    aCells[1] = static_cast<char>('0' + aValue % 10);
+}
+
+// *****************************************************************************
+//                                END OF FILE
+// *****************************************************************************
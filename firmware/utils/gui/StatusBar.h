@@ -0,0 +1,114 @@
+#ifndef UTILS__GUI__STATUSBAR_H_
+#define UTILS__GUI__STATUSBAR_H_
+// *******************************************************************************
+//
+// Project: Utils.
+//
+// Module: GUI.
+//
+// *******************************************************************************
+
+//! \file
+//! \brief Clock and feeder status bar, redrawn by character cell.
+//! \ingroup utils
+
+// ******************************************************************************
+//
+//        Copyright (c) 2023, Martin Garon, All rights reserved.
+//
+// This source code is licensed under the GPL-3.0-style license found in the
+// LICENSE file in the root directory of this source tree.
+//
+// ******************************************************************************
+
+// ******************************************************************************
+//                              INCLUDE FILES
+// ******************************************************************************
+
+// Standard libraries.
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <optional>
+
+// TivaWare Graphics Library.
+#include <grlib/grlib.h>
+
+// *****************************************************************************
+//                       DEFINED CONSTANTS AND MACROS
+// *****************************************************************************
+
+// *****************************************************************************
+//                         TYPEDEFS AND STRUCTURES
+// *****************************************************************************
+
+namespace Utils::GUI
+{
+
+
+//! \brief A line of fixed width cells: "hh:mm:ss >hh:mm OFF".
+//! The time of day, the next feed time and the motor state.
+//! The bar remembers the characters it rendered: Render() redraws only the
+//! cells that changed since, so the display only gets the lines of the bar
+//! marked dirty, and only when a digit changes.
+//! Drawn with the font of the context, which must be monospaced.
+class StatusBar final
+{
+public:
+    StatusBar(tContext& aContext, int32_t aX, int32_t aY) noexcept;
+
+    //! \brief Shows the bar: all its cells are drawn on the next render.
+    //! Also used when whatever was under the bar got redrawn.
+    void Show() noexcept;
+
+    //! \brief Stops rendering the bar. What it drew is left as is.
+    void Hide() noexcept;
+
+    void SetTime(std::chrono::seconds aTime) noexcept;
+    void SetNextFeedTime(std::optional<std::chrono::minutes> aNextFeedTime) noexcept;
+    void SetMotorOn(bool aIsMotorOn) noexcept;
+
+    [[nodiscard]] auto IsDamaged() const noexcept -> bool;
+
+    //! \brief Redraws the cells whose character changed.
+    //! \return The count of cells drawn.
+    auto Render() noexcept -> unsigned int;
+
+private:
+    static constexpr std::size_t sCellCount{19};
+    using Cells = std::array<char, sCellCount>;
+
+    [[nodiscard]] auto Format() const noexcept -> Cells;
+
+    tContext& mContext;
+    int32_t mX{};
+    int32_t mY{};
+
+    std::chrono::seconds mTime{};
+    std::optional<std::chrono::minutes> mNextFeedTime{};
+    bool mIsMotorOn{false};
+
+    // What the display shows. NUL cells are to be drawn.
+    Cells mRendered{};
+    bool mIsShown{false};
+};
+
+
+} // namespace Utils::GUI
+
+// *****************************************************************************
+//                            EXPORTED VARIABLES
+// *****************************************************************************
+
+// *****************************************************************************
+//                                 EXTERNS
+// *****************************************************************************
+
+// *****************************************************************************
+//                            EXPORTED FUNCTIONS
+// *****************************************************************************
+
+// *****************************************************************************
+//                                END OF FILE
+// *****************************************************************************
+#endif // UTILS__GUI__STATUSBAR_H_
@@ -0,0 +1,128 @@
+// *******************************************************************************
+//
+// Project: Utils.
+//
+// Module: Shell.
+//
+// *******************************************************************************
+
+//! \file
+//! \brief Shell command dumping the LCD panel content.
+//! \ingroup utils
+
+// ******************************************************************************
+//
+//        Copyright (c) 2023, Martin Garon, All rights reserved.
+//
+// This source code is licensed under the GPL-3.0-style license found in the
+// LICENSE file in the root directory of this source tree.
+//
+// ******************************************************************************
+
+// *****************************************************************************
+//                              INCLUDE FILES
+// *****************************************************************************
+
+// This module.
+#include "utils/shell/LCDDumpCmd.h"
+
+// Drivers.
+#include "drivers/inc/RLEImage.h"
+
+// *****************************************************************************
+//                       DEFINED CONSTANTS AND MACROS
+// *****************************************************************************
+
+// *****************************************************************************
+//                         TYPEDEFS AND STRUCTURES
+// *****************************************************************************
+
+// *****************************************************************************
+//                            FUNCTION PROTOTYPES
+// *****************************************************************************
+
+// *****************************************************************************
+//                             GLOBAL VARIABLES
+// *****************************************************************************
+
+static constexpr std::string_view sHexDigits{"0123456789abcdef"};
+
+// *****************************************************************************
+//                            EXPORTED FUNCTIONS
+// *****************************************************************************
+
+namespace Utils
+{
+
+
+LCDDump::LCDDump(Shell& aShell, const int32_t aWidth, const int32_t aHeight, const bool aIsDiff) noexcept
+    : mShell{aShell}
+    , mWidth{aWidth}
+{
+    // Ctor body.
+    mShell.Printf("lcd %d %d %s\n", static_cast<int>(aWidth), static_cast<int>(aHeight), aIsDiff ? "diff" : "full");
+}
+
+
+void LCDDump::PrintLine(const int32_t aRowIx, const std::span<const std::byte> aLine) noexcept
+{
+    mShell.Printf("%d ", static_cast<int>(aRowIx));
+
+    // Runs alternate between light and dark pixels, from a light one.
+    auto lIsRunDark{false};
+    auto lRun{0};
+    for (auto lX{0}; lX < mWidth; ++lX) {
+        const auto lIsDark{(aLine[lX / 8] & (std::byte{0x80} >> (lX % 8))) == std::byte{0}};
+        if (lIsDark != lIsRunDark) {
+            PutRun(lRun);
+            lIsRunDark = lIsDark;
+            lRun = 0;
+        }
+        ++lRun;
+    }
+    PutRun(lRun);
+
+    PrintText();
+    mShell.Printf("\n");
+    ++mLineCount;
+}
+
+
+void LCDDump::End() noexcept
+{
+    mShell.Printf("end %u %u\n", mLineCount, mByteCount);
+}
+
+// *****************************************************************************
+//                              LOCAL FUNCTIONS
+// *****************************************************************************
+
+void LCDDump::PutRun(const int32_t aRun) noexcept
+{
+    // Lines are far shorter than the longest run.
+    std::array<uint8_t, 2> lBytes{};
+    const auto lSize{Drivers::RLEImage::WriteRun(lBytes, aRun)};
+    for (std::size_t lIx{0}; lIx < lSize; ++lIx) {
+        if (mTextSize + 2 >= mText.size()) {
+            PrintText();
+        }
+        mText[mTextSize++] = sHexDigits[lBytes[lIx] >> 4];
+        mText[mTextSize++] = sHexDigits[lBytes[lIx] & 0xf];
+    }
+    mByteCount += static_cast<unsigned int>(lSize);
+}
+
+
+void LCDDump::PrintText() noexcept
+{
+    mText[mTextSize] = '\0';
+    mShell.Printf("%s", mText.data());
+    mTextSize = 0;
+}
+
+
+} // namespace Utils
+
+// *****************************************************************************
+//                                END OF FILE
+// *****************************************************************************
@@ -0,0 +1,144 @@
+#ifndef UTILS__LCDDUMPCMD_H_
+#define UTILS__LCDDUMPCMD_H_
+// *******************************************************************************
+//
+// Project: Utils.
+//
+// Module: Shell.
+//
+// *******************************************************************************
+
+//! \file
+//! \brief Shell command dumping the LCD panel content.
+//! \ingroup utils
+
+// ******************************************************************************
+//
+//        Copyright (c) 2023, Martin Garon, All rights reserved.
+//
+// This source code is licensed under the GPL-3.0-style license found in the
+// LICENSE file in the root directory of this source tree.
+//
+// ******************************************************************************
+
+// ******************************************************************************
+//                              INCLUDE FILES
+// ******************************************************************************
+
+// This module.
+#include "utils/shell/Shell.h"
+
+// Standard libraries.
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string_view>
+
+// *****************************************************************************
+//                       DEFINED CONSTANTS AND MACROS
+// *****************************************************************************
+
+// *****************************************************************************
+//                         TYPEDEFS AND STRUCTURES
+// *****************************************************************************
+
+namespace Utils
+{
+
+
+//! \brief Prints a dump of panel lines, run-length encoded as text:
+//!     lcd <width> <height> full|diff
+//!     <row> <runs>
+//!     ...
+//!     end <line count> <run byte count>
+//! Runs are the hex bytes of a Drivers::RLEImage row: they alternate between
+//! light and dark pixels, starting with light ones.
+//! The lcd_dump host tool rebuilds the images from a log of dumps.
+class LCDDump final
+{
+public:
+    //! \brief Prints the dump header.
+    LCDDump(Shell& aShell, int32_t aWidth, int32_t aHeight, bool aIsDiff) noexcept;
+
+    //! \brief Prints a line, leftmost pixel as MSB, a cleared bit being a dark pixel.
+    void PrintLine(int32_t aRowIx, std::span<const std::byte> aLine) noexcept;
+
+    //! \brief Prints the dump trailer.
+    void End() noexcept;
+
+private:
+    void PutRun(int32_t aRun) noexcept;
+    void PrintText() noexcept;
+
+    Shell& mShell;
+    int32_t mWidth{};
+
+    // Hex digits printed a chunk at a time, NUL terminated.
+    std::array<char, 64 + 1> mText{};
+    std::size_t mTextSize{0};
+
+    unsigned int mLineCount{0};
+    unsigned int mByteCount{0};
+};
+
+
+//! \brief Adds the "lcd [diff]" command, dumping the panel content of an
+//! LS013B7 driver as last flushed.
+//! "lcd diff" dumps only the lines changed since the previous dump, of either kind:
+//! cheap enough to watch redraws live.
+//! The dump reads the panel lines and their changed flags, written by Flush(),
+//! without any lock: the shell must dispatch the command from the context that
+//! flushes the LCD, i.e. from the GUI AO.
+template<typename LCD>
+void AddLCDDumpCmd(Shell& aShell, LCD& aLCD) noexcept
+{
+    static constexpr ShellCmd::tFunction sCmd{
+        [](
+            Shell* const aShell,
+            const std::string_view aName,
+            void* const aParam,
+            const int aArgc,
+            const char* const aArgv[]
+        ) noexcept
+        {
+            const auto lIsDiff{(aArgc == 1) && (std::string_view{aArgv[0]} == "diff")};
+            if ((aArgc > 0) && !lIsDiff) {
+                aShell->Printf("format: %.*s [diff]\n", static_cast<int>(aName.size()), aName.data());
+                return;
+            }
+
+            // A full dump takes the changed lines too: the next diff starts from it.
+            auto& lLCD{*static_cast<LCD*>(aParam)};
+            LCDDump lDump{*aShell, lLCD.ui16Width, lLCD.ui16Height, lIsDiff};
+            for (auto lRowIx{0}; lRowIx < lLCD.ui16Height; ++lRowIx) {
+                if (lLCD.TakeLineChanged(lRowIx) || !lIsDiff) {
+                    lDump.PrintLine(lRowIx, lLCD.GetPanelLine(lRowIx));
+                }
+            }
+            lDump.End();
+        }
+    };
+
+    aShell.AddShellCmd("lcd", sCmd, &aLCD);
+}
+
+
+} // namespace Utils
+
+// *****************************************************************************
+//                            EXPORTED VARIABLES
+// *****************************************************************************
+
+// *****************************************************************************
+//                                 EXTERNS
+// *****************************************************************************
+
+// *****************************************************************************
+//                            EXPORTED FUNCTIONS
+// *****************************************************************************
+
+// *****************************************************************************
+//                                END OF FILE
+// *****************************************************************************
+#endif // UTILS__LCDDUMPCMD_H_
@@ -0,0 +1,197 @@
+// *******************************************************************************
+//
+// Project: Utils.
+//
+// Module: SPI.
+//
+// *******************************************************************************
+
+//! \file
+//! \brief Prioritised queue of the transactions of a shared SPI bus.
+//! \ingroup utils
+
+// ******************************************************************************
+//
+//        Copyright (c) 2023, Martin Garon, All rights reserved.
+//
+// This source code is licensed under the GPL-3.0-style license found in the
+// LICENSE file in the root directory of this source tree.
+//
+// ******************************************************************************
+
+// *****************************************************************************
+//                              INCLUDE FILES
+// *****************************************************************************
+
+// This module.
+#include "utils/spi/TransactionQueue.h"
+
+// Standard libraries.
+#include <algorithm>
+
+// *****************************************************************************
+//                       DEFINED CONSTANTS AND MACROS
+// *****************************************************************************
+
+// *****************************************************************************
+//                         TYPEDEFS AND STRUCTURES
+// *****************************************************************************
+
+// *****************************************************************************
+//                            FUNCTION PROTOTYPES
+// *****************************************************************************
+
+// *****************************************************************************
+//                             GLOBAL VARIABLES
+// *****************************************************************************
+
+// *****************************************************************************
+//                            EXPORTED FUNCTIONS
+// *****************************************************************************
+
+namespace Utils::SPI
+{
+
+
+auto TransactionQueue::Push(const Transaction& aTransaction) noexcept -> bool
+{
+    if (mCount >= mEntries.size()) {
+        return false;
+    }
+
+    mEntries[mCount++] = Entry{aTransaction, mNextSeqNum++, 0};
+    mStats.mMaxCount = std::max(mStats.mMaxCount, mCount);
+    return true;
+}
+
+
+auto TransactionQueue::StartNext() noexcept -> std::optional<Piece>
+{
+    if (IsRunning() || IsEmpty()) {
+        return std::nullopt;
+    }
+
+    const auto lIx{FindNext()};
+    const auto& lEntry{mEntries[lIx]};
+    const auto& lTransaction{lEntry.mTransaction};
+
+    // Another transaction was cut short for this one.
+    const auto lEntries{std::span{mEntries}.first(mCount)};
+    if ((lEntry.mSentSize == 0)
+        && std::any_of(lEntries.begin(), lEntries.end(), [](const Entry& aEntry) noexcept {return aEntry.mSentSize != 0;})) {
+        ++mStats.mPreemptions;
+    }
+
+    if (lTransaction.mSPICfg != mLastSPICfg) {
+        mLastSPICfg = lTransaction.mSPICfg;
+        ++mStats.mSPICfgChanges;
+    }
+
+    // The piece of the last segment from what was sent, and its tail.
+    mPieceSegments = lTransaction.mTxSegments;
+    if (IsSplit(lTransaction)) {
+        auto& lLastSegment{mPieceSegments.back()};
+        lLastSegment = lLastSegment.subspan(lEntry.mSentSize);
+        lLastSegment = lLastSegment.first(std::min(lLastSegment.size(), lTransaction.mSplitSize + lTransaction.mSplitTail));
+    }
+
+    mRunningIx = lIx;
+    ++mStats.mPieces;
+    return Piece{lTransaction.mSPICfg, mPieceSegments, lTransaction.mRxData};
+}
+
+
+auto TransactionQueue::OnPieceDone() noexcept -> std::optional<Transaction>
+{
+    if (!IsRunning()) {
+        return std::nullopt;
+    }
+
+    const auto lIx{*mRunningIx};
+    mRunningIx.reset();
+
+    // Sent up to the tail, which starts the next piece.
+    auto& lEntry{mEntries[lIx]};
+    const auto& lTransaction{lEntry.mTransaction};
+    if (IsSplit(lTransaction)) {
+        lEntry.mSentSize += lTransaction.mSplitSize;
+        if ((lEntry.mSentSize + lTransaction.mSplitTail) < lTransaction.mTxSegments.back().size()) {
+            return std::nullopt;
+        }
+    }
+
+    ++mStats.mTransactions;
+    return Remove(lIx);
+}
+
+
+auto TransactionQueue::Drop() noexcept -> std::optional<Transaction>
+{
+    if (!IsRunning()) {
+        return std::nullopt;
+    }
+
+    const auto lIx{*mRunningIx};
+    mRunningIx.reset();
+    return Remove(lIx);
+}
+
+
+auto TransactionQueue::FindNext() const noexcept -> std::size_t
+{
+    std::size_t lNextIx{0};
+    for (std::size_t lIx{1}; lIx < mCount; ++lIx) {
+        if (IsAhead(mEntries[lIx], mEntries[lNextIx])) {
+            lNextIx = lIx;
+        }
+    }
+
+    return lNextIx;
+}
+
+
+auto TransactionQueue::IsAhead(const Entry& aEntry, const Entry& aOther) const noexcept -> bool
+{
+    if (aEntry.mTransaction.mPriority != aOther.mTransaction.mPriority) {
+        return aEntry.mTransaction.mPriority > aOther.mTransaction.mPriority;
+    }
+
+    const auto lIsStarted{aEntry.mSentSize != 0};
+    if (lIsStarted != (aOther.mSentSize != 0)) {
+        return lIsStarted;
+    }
+
+    const auto lIsSameSPICfg{aEntry.mTransaction.mSPICfg == mLastSPICfg};
+    if (lIsSameSPICfg != (aOther.mTransaction.mSPICfg == mLastSPICfg)) {
+        return lIsSameSPICfg;
+    }
+
+    // Oldest first, sequence numbers wrapping around.
+    return static_cast<int>(aEntry.mSeqNum - aOther.mSeqNum) < 0;
+}
+
+
+auto TransactionQueue::IsSplit(const Transaction& aTransaction) noexcept -> bool
+{
+    return (aTransaction.mSplitSize != 0) && aTransaction.mRxData.empty();
+}
+
+
+auto TransactionQueue::Remove(const std::size_t aIx) noexcept -> Transaction
+{
+    // Order is kept by the sequence numbers: the last entry fills the hole.
+    const auto lTransaction{mEntries[aIx].mTransaction};
+    mEntries[aIx] = mEntries[--mCount];
+    return lTransaction;
+}
+
+
+} // namespace Utils::SPI
+
+// *****************************************************************************
+//                              LOCAL FUNCTIONS
+// *****************************************************************************
+
+// *****************************************************************************
+//                                END OF FILE
+// *****************************************************************************
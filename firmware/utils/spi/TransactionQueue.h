@@ -0,0 +1,180 @@
+#ifndef UTILS__SPI__TRANSACTIONQUEUE_H_
+#define UTILS__SPI__TRANSACTIONQUEUE_H_
+// *******************************************************************************
+//
+// Project: Utils.
+//
+// Module: SPI.
+//
+// *******************************************************************************
+
+//! \file
+//! \brief Prioritised queue of the transactions of a shared SPI bus.
+//! \ingroup utils
+
+// ******************************************************************************
+//
+//        Copyright (c) 2023, Martin Garon, All rights reserved.
+//
+// This source code is licensed under the GPL-3.0-style license found in the
+// LICENSE file in the root directory of this source tree.
+//
+// ******************************************************************************
+
+// ******************************************************************************
+//                              INCLUDE FILES
+// ******************************************************************************
+
+// Standard libraries.
+#include <array>
+#include <cstddef>
+#include <optional>
+#include <span>
+
+// Firmware libraries.
+#include "corelink/inc/SPISlaveCfg.h"
+
+// *****************************************************************************
+//                       DEFINED CONSTANTS AND MACROS
+// *****************************************************************************
+
+// *****************************************************************************
+//                         TYPEDEFS AND STRUCTURES
+// *****************************************************************************
+
+// QP, only pointed to: the completion is posted by the bus owner.
+namespace QP
+{
+class QActive;
+class QEvt;
+} // namespace QP
+
+
+namespace Utils::SPI
+{
+
+
+//! \brief A transaction on the bus, and whom to tell once done.
+//! The data pointed to belongs to the requester until its completion event.
+struct Transaction
+{
+    static constexpr std::size_t sMaxSegmentCount{2};
+
+    const CoreLink::SPISlaveCfg* mSPICfg{nullptr};
+
+    //! \brief Sent in order, in a CS window. Empty segments are skipped.
+    std::array<std::span<const std::byte>, sMaxSegmentCount> mTxSegments{};
+
+    //! \brief Read after the segments sent.
+    std::span<std::byte> mRxData{};
+
+    //! \brief Higher runs first, e.g. an RTC read ahead of LCD lines.
+    unsigned int mPriority{0};
+
+    //! \brief When not 0, the last segment is sent in pieces of that many bytes,
+    //! each in its own CS window behind the other segments, and followed by
+    //! the mSplitTail bytes after it. A transaction waiting with a higher
+    //! priority runs between 2 pieces. Ignored for reads.
+    std::size_t mSplitSize{0};
+    std::size_t mSplitTail{0};
+
+    QP::QActive* mRequester{nullptr};
+    const QP::QEvt* mDoneEvt{nullptr};
+
+    //! \brief Posted instead of mDoneEvt when the transaction is dropped unsent:
+    //! queue full, or too large for the engine. mDoneEvt is posted when not set.
+    const QP::QEvt* mFailedEvt{nullptr};
+};
+
+
+//! \brief The transactions waiting for the bus, and the one running.
+//! The next to run is the one of highest priority. Between equals: the one
+//! already started, then one to the slave last addressed, sparing a bus
+//! reconfiguration, then the oldest.
+class TransactionQueue final
+{
+public:
+    static constexpr std::size_t sCapacity{8};
+
+    //! \brief The CS window to start on the bus.
+    struct Piece
+    {
+        const CoreLink::SPISlaveCfg* mSPICfg{nullptr};
+        std::span<const std::span<const std::byte>> mTxSegments{};
+        std::span<std::byte> mRxData{};
+    };
+
+    struct Stats
+    {
+        unsigned int mTransactions{};
+        unsigned int mPieces{};
+        unsigned int mSPICfgChanges{};
+        unsigned int mPreemptions{};
+        std::size_t mMaxCount{};
+    };
+
+    //! \brief Queues a transaction. Returns false when full.
+    [[nodiscard]] auto Push(const Transaction& aTransaction) noexcept -> bool;
+
+    //! \brief Whether a piece was started, and not reported done yet.
+    [[nodiscard]] auto IsRunning() const noexcept -> bool {return mRunningIx.has_value();}
+    [[nodiscard]] auto IsEmpty() const noexcept -> bool {return mCount == 0;}
+
+    //! \brief Picks the transaction to run, and returns its next piece.
+    //! The piece stays valid until reported done.
+    [[nodiscard]] auto StartNext() noexcept -> std::optional<Piece>;
+
+    //! \brief The piece started is done, or was not sent.
+    //! Returns its transaction when it has nothing left to send, out of the queue.
+    [[nodiscard]] auto OnPieceDone() noexcept -> std::optional<Transaction>;
+
+    //! \brief The transaction started is given up, whatever it has left to send.
+    [[nodiscard]] auto Drop() noexcept -> std::optional<Transaction>;
+
+    [[nodiscard]] auto GetStats() const noexcept -> Stats {return mStats;}
+
+private:
+    struct Entry
+    {
+        Transaction mTransaction{};
+        unsigned int mSeqNum{0};
+        std::size_t mSentSize{0};
+    };
+
+    [[nodiscard]] auto FindNext() const noexcept -> std::size_t;
+    [[nodiscard]] auto IsAhead(const Entry& aEntry, const Entry& aOther) const noexcept -> bool;
+    [[nodiscard]] static auto IsSplit(const Transaction& aTransaction) noexcept -> bool;
+    [[nodiscard]] auto Remove(std::size_t aIx) noexcept -> Transaction;
+
+    std::array<Entry, sCapacity> mEntries{};
+    std::size_t mCount{0};
+    unsigned int mNextSeqNum{0};
+
+    std::optional<std::size_t> mRunningIx{};
+    const CoreLink::SPISlaveCfg* mLastSPICfg{nullptr};
+
+    // The segments of the piece running, its last one cut.
+    std::array<std::span<const std::byte>, Transaction::sMaxSegmentCount> mPieceSegments{};
+
+    Stats mStats{};
+};
+
+
+} // namespace Utils::SPI
+
+// *****************************************************************************
+//                            EXPORTED VARIABLES
+// *****************************************************************************
+
+// *****************************************************************************
+//                                 EXTERNS
+// *****************************************************************************
+
+// *****************************************************************************
+//                            EXPORTED FUNCTIONS
+// *****************************************************************************
+
+// *****************************************************************************
+//                                END OF FILE
+// *****************************************************************************
+#endif // UTILS__SPI__TRANSACTIONQUEUE_H_
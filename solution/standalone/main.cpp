@@ -32,6 +32,7 @@
 #include <qpcpp.hpp>
 
 // Standard Libraries.
+#include <algorithm>
 #include <array>
 #include <chrono>
 #include <numeric>
@@ -39,10 +40,12 @@
 // Firmware Libraries.
 #include "inc/FeedCfg.h"
 #include "drivers/inc/DS3234.h"
+#include "drivers/inc/GlyphCache.h"
 #include "drivers/inc/LS013B7.h"
 #include "drivers/inc/TB6612.h"
 
 // CoreLink Library.
+#include "corelink/inc/SPIDMAEngine.h"
 #include "corelink/inc/SPIMasterDev.h"
 #include "corelink/inc/SSIGPIO.h"
 
@@ -51,7 +54,10 @@
 #include "qp_ao/codegen/PFPP_AOs.h"
 #include "qp_ao/codegen/PFPP_Events.h"
 #include "qp_ao/codegen/RTCC_AOs.h"
+#include "qp_ao/codegen/RTCC_Events.h"
 #include "qp_ao/codegen/Signals.h"
+#include "qp_ao/codegen/SPI_AOs.h"
+#include "qp_ao/codegen/SPI_Events.h"
 
 // From CMSIS-Pack.
 // the device specific header (TI)
@@ -63,6 +69,7 @@
 #include "driverlib/pin_map.h"
 #include "driverlib/rom.h"
 #include "driverlib/sysctl.h"
+#include "driverlib/udma.h"
 
 // *****************************************************************************
 //                      DEFINED CONSTANTS AND MACROS
@@ -72,6 +79,13 @@
 //                         TYPEDEFS AND STRUCTURES
 // *****************************************************************************
 
+// Priorities of the transactions on the SPI bus.
+enum class eSPIPrio : unsigned int
+{
+    LCD = 0,
+    RTCC = 1
+};
+
 // *****************************************************************************
 //                            FUNCTION PROTOTYPES
 // *****************************************************************************
@@ -82,6 +96,7 @@ static void InitOutputGPIO(const CoreLink::GPIO& aGPIO) noexcept;
 [[nodiscard]] static auto StartMgr() noexcept -> std::unique_ptr<PFPP::AO::Mgr>;
 [[nodiscard]] static auto StartGUI() noexcept -> std::unique_ptr<GUI::AO::Mgr>;
 [[nodiscard]] static auto StartRTCC() noexcept -> std::unique_ptr<RTCC::AO::Mgr>;
+[[nodiscard]] static auto StartSPIBus() noexcept -> std::unique_ptr<SPI::AO::Bus>;
 
 static void DebounceSwitches() noexcept;
 
@@ -98,7 +113,9 @@ static QP::QSTimeCtr QS_tickPeriod_{};
 
 // QSpy source IDs
 static constexpr QP::QSpyId sSysTick_Handler{0U};
+static constexpr QP::QSpyId sSSI2_IRQHandler{0U};
 static constexpr QP::QSpyId sOnFlush{0U};
+static constexpr QP::QSpyId sOnLCDWr{0U};
 
 #endif // Q_SPY
 
@@ -119,6 +136,12 @@ static constexpr CoreLink::SPIMasterDev sSPIMasterDev{
     50000000UL
 };
 
+// The SPI transactions are moved by the uDMA, their completion reported from the SSI2 interrupt.
+// The SPI bus AO runs them, for the AOs sharing the bus.
+static CoreLink::SPIDMAEngine sSPIDMAEngine{sSPIMasterDev, {UDMA_CH13_SSI2TX, UDMA_CH12_SSI2RX}};
+static QP::QActive* sSPIBusAO{nullptr};
+static QP::QActive* sGUIAO{nullptr};
+
 // *****************************************************************************
 //                            EXPORTED FUNCTIONS
 // *****************************************************************************
@@ -135,6 +158,22 @@ int main()
         sizeof(sSmallPoolSto[0])
     );
 
+    // Clock ticks carry the time and date: too large for the small pool.
+    static QF_MPOOL_EL(RTCC::Event::TimeAndDate) sMediumPoolSto[4]{};
+    QP::QF::poolInit(
+        sMediumPoolSto,
+        sizeof(sMediumPoolSto),
+        sizeof(sMediumPoolSto[0])
+    );
+
+    // SPI transactions, the largest events.
+    static QF_MPOOL_EL(SPI::Event::Transaction) sLargePoolSto[4]{};
+    QP::QF::poolInit(
+        sLargePoolSto,
+        sizeof(sLargePoolSto),
+        sizeof(sLargePoolSto[0])
+    );
+
     // Init publish-subscribe.
     static std::array<QP::QSubscrList, QTY_SIG> lSubsribeSto{};
     QP::QF::psInit(lSubsribeSto.data(), lSubsribeSto.size());
@@ -143,16 +182,32 @@ int main()
 
     // Send object dictionaries for event pools...
     QS_OBJ_DICTIONARY(sSmallPoolSto);
+    QS_OBJ_DICTIONARY(sMediumPoolSto);
+    QS_OBJ_DICTIONARY(sLargePoolSto);
     QS_FUN_DICTIONARY(&QP::QHsm::top);
 
     // Keep each objects alive until the end of the program.
+    // The SPI bus AO is started first: the others post to it from their initial transition.
     enum class ePrio
     {
         RTCC = 1,
         Mgr = 2,
-        GUI = 3
+        GUI = 3,
+        SPIBus = 4
     };
 
+    auto lSPIBusAO{StartSPIBus()};
+    if (lSPIBusAO) {
+        sSPIBusAO = lSPIBusAO.get();
+        static std::array<const QP::QEvt*, 8> sEventQSto{};
+        lSPIBusAO->start(
+            static_cast<int>(ePrio::SPIBus),
+            sEventQSto.data(),
+            sEventQSto.size(),
+            nullptr, 0U
+        );
+    }
+
     auto lPFPPAO{StartMgr()};
     if (lPFPPAO) {
         static std::array<const QP::QEvt*, 10> sEventQSto{};
@@ -166,6 +221,7 @@ int main()
 
     auto lGUIAO{StartGUI()};
     if (lGUIAO) {
+        sGUIAO = lGUIAO.get();
         static std::array<const QP::QEvt*, 10> sEventQSto{};
         lGUIAO->start(
             static_cast<int>(ePrio::GUI),
@@ -244,6 +300,13 @@ static void Init()
     sSSI2GPIO.SetPins();
     ROM_SysCtlPeripheralEnable(SYSCTL_PERIPH_SSI2);
 
+    // uDMA controller, serving the SSI2 transfers.
+    alignas(1024) static std::array<tDMAControlTable, 64> sDMAControlTable{};
+    ROM_SysCtlPeripheralEnable(SYSCTL_PERIPH_UDMA);
+    ROM_uDMAEnable();
+    ROM_uDMAControlBaseSet(sDMAControlTable.data());
+    sSPIDMAEngine.Init();
+
     // Call QS::onStartup().
     // Has to be setup early for dictionary entries to be set.
     QS_INIT(nullptr);
@@ -321,26 +384,56 @@ static auto StartGUI() noexcept -> std::unique_ptr<GUI::AO::Mgr>
     InitOutputGPIO(sLCDDisp);
     ROM_GPIOPinWrite(sLCDDisp.mBaseAddr, sLCDDisp.mPin, 0);
 
-    static constexpr CoreLink::SPISlaveCfg sLCDSPISlaveCfg{
-        .mProtocol{CoreLink::SPISlaveCfg::tProtocol::MOTO_0},
-        .mBitRate{1000000UL},
-        .mDataWidth{8},
-        .mCSn{GPIOE_BASE, GPIO_PIN_5, CoreLink::CSnGPIO::tCSPolarity::ActiveHigh}
+    // Its SSI registers computed at compile time: switching to it is register writes.
+    static constexpr auto sLCDSPISlaveCfg{
+        sSPIMasterDev.MakeCfg({
+            .mProtocol{CoreLink::SPISlaveCfg::tProtocol::MOTO_0},
+            .mBitRate{1000000UL},
+            .mDataWidth{8},
+            .mCSn{GPIOE_BASE, GPIO_PIN_5, CoreLink::CSnGPIO::tCSPolarity::ActiveHigh}
+        })
     };
+    static_assert(sLCDSPISlaveCfg.mSSIRegs.IsValid());
     InitOutputGPIO(sLCDSPISlaveCfg.mCSn);
     sLCDSPISlaveCfg.mCSn.DeassertCSn();
 
+    // Init() writes synchronously, before the SPI bus AO runs.
+    // Then the LCD writes go through the SPI bus AO, split line by line: a transaction
+    // of higher priority waits at most one line. Their completion comes back as GUI_LCD_WR_DONE_SIG,
+    // or GUI_LCD_WR_FAILED_SIG when the SPI bus AO drops them unsent.
     auto lLCD{
-        std::make_shared<Drivers::LS013B7>(
-            []() noexcept {sLCDSPISlaveCfg.mCSn.AssertCSn();},
-            []() noexcept {sLCDSPISlaveCfg.mCSn.DeassertCSn();},
+        std::make_shared<Drivers::LS013B7DH03>(
             [](std::span<const std::byte> aData, std::optional<std::byte> aAddr) noexcept
             {
                 sSPIMasterDev.WrData(sLCDSPISlaveCfg, aData, aAddr);
             },
-            [](const std::byte aByte) noexcept
+            Drivers::LS013B7DH03::AsyncSPI{
+                .mStartWr{
+                    [](const std::span<const std::span<const std::byte>> aSegments) noexcept
+                    {
+                        // Always taken: the SPI bus AO reports the transaction, sent or not.
+                        static const QP::QEvt sWrDoneEvt{GUI_LCD_WR_DONE_SIG};
+                        static const QP::QEvt sWrFailedEvt{GUI_LCD_WR_FAILED_SIG};
+                        const auto lTransactionEvt{Q_NEW(SPI::Event::Transaction, SPI_TRANSACTION_SIG)};
+                        lTransactionEvt->mTransaction = Utils::SPI::Transaction{
+                            .mSPICfg{&sLCDSPISlaveCfg},
+                            .mPriority{static_cast<unsigned int>(eSPIPrio::LCD)},
+                            .mSplitSize{Drivers::LS013B7DH03::sTxSplitSize},
+                            .mSplitTail{Drivers::LS013B7DH03::sTxSplitTail},
+                            .mRequester{sGUIAO},
+                            .mDoneEvt{&sWrDoneEvt},
+                            .mFailedEvt{&sWrFailedEvt}
+                        };
+                        std::copy(aSegments.begin(), aSegments.end(), lTransactionEvt->mTransaction.mTxSegments.begin());
+                        sSPIBusAO->POST(lTransactionEvt, &sOnLCDWr);
+                        return true;
+                    }
+                }
+            },
+            []() noexcept
             {
-                return sSPIMasterDev.PushPullByte(sLCDSPISlaveCfg, aByte);
+                static const QP::QEvt sFlushDoneEvt{GUI_FLUSH_DONE_SIG};
+                QP::QF::PUBLISH(&sFlushDoneEvt, &sSSI2_IRQHandler);
             },
             []() noexcept {ROM_GPIOPinWrite(sLCDDisp.mBaseAddr, sLCDDisp.mPin, sLCDDisp.mPin);},
             []() noexcept {ROM_GPIOPinWrite(sLCDDisp.mBaseAddr, sLCDDisp.mPin, 0);}
@@ -348,7 +441,30 @@ static auto StartGUI() noexcept -> std::unique_ptr<GUI::AO::Mgr>
     };
 
     lLCD->Init();
-    return std::make_unique<GUI::AO::Mgr>(lLCD, lLCD);
+
+    // Serves the grlib string renderer of the GUI.
+    static Drivers::GlyphCache sGlyphCache{
+        *lLCD,
+        [](
+            void* const aDisplayData,
+            const int32_t aX,
+            const int32_t aY,
+            const int32_t aPixelCount,
+            std::span<const uint32_t> aBits,
+            const uint32_t aColor,
+            std::optional<uint32_t> aBkColor
+        ) noexcept
+        {
+            static_cast<Drivers::LS013B7DH03*>(aDisplayData)->BitRowDraw(aX, aY, aPixelCount, aBits, aColor, aBkColor);
+        }
+    };
+
+    // Caps the GUI to 20 frames per second, coalescing draws in between.
+    // The COM inversion of the LCD wants at least 1 Hz: ticking every 500 ms inverts it at least every second.
+    using Ticks = std::chrono::duration<QP::QTimeEvtCtr, std::ratio<1, sBSPTicksPerSecond>>;
+    static constexpr auto sFramePeriod{std::chrono::duration_cast<Ticks>(std::chrono::milliseconds{50}).count()};
+    static constexpr auto sMaintenancePeriod{std::chrono::duration_cast<Ticks>(std::chrono::milliseconds{500}).count()};
+    return std::make_unique<GUI::AO::Mgr>(lLCD, lLCD, sFramePeriod, sMaintenancePeriod);
 }
 
 
@@ -357,13 +473,18 @@ static auto StartRTCC() noexcept -> std::unique_ptr<RTCC::AO::Mgr>
     // NOTE: Shared with the board function Blue LED. Do not use. May require patching RTCC board.
     [[maybe_unused]] static constexpr CoreLink::GPIO sRTCCRst{GPIOF_BASE, GPIO_PIN_4};
 
-    static constexpr CoreLink::SPISlaveCfg sRTCCSPISlaveCfg{
-        .mProtocol{CoreLink::SPISlaveCfg::tProtocol::MOTO_0},
-        .mBitRate{4000000UL},
-        .mDataWidth{8},
-        .mCSn{GPIOA_BASE, GPIO_PIN_3}
+    static constexpr auto sRTCCSPISlaveCfg{
+        sSPIMasterDev.MakeCfg({
+            .mProtocol{CoreLink::SPISlaveCfg::tProtocol::MOTO_0},
+            .mBitRate{4000000UL},
+            .mDataWidth{8},
+            .mCSn{GPIOA_BASE, GPIO_PIN_3}
+        })
     };
+    static_assert(sRTCCSPISlaveCfg.mSSIRegs.IsValid());
 
+    // NOTE: Synchronous, while the AO is not started: its reads are to go through
+    // the SPI bus AO, as eSPIPrio::RTCC transactions, once it runs.
     auto lRTCC{
         std::make_unique< Drivers::DS3234>(
             [](std::span<std::byte> aData, std::optional<std::byte> aAddr) noexcept
@@ -377,11 +498,27 @@ static auto StartRTCC() noexcept -> std::unique_ptr<RTCC::AO::Mgr>
         )
     };
 
+    // NOTE: The RTCC AO is not started, so RTCC_TICK is never published: the clock
+    // of the GUI status bar is not live, and stays at 00:00:00.
     //return std::make_unique<RTCC::AO::Mgr>(std::move(lRTCC));
     return nullptr;
 }
 
 
+static auto StartSPIBus() noexcept -> std::unique_ptr<SPI::AO::Bus>
+{
+    // Each transfer completion is handed over to the AO, from the SSI2 interrupt.
+    return std::make_unique<SPI::AO::Bus>(
+        sSPIDMAEngine,
+        []() noexcept
+        {
+            static const QP::QEvt sDoneEvt{SPI_DONE_SIG};
+            sSPIBusAO->POST(&sDoneEvt, &sSSI2_IRQHandler);
+        }
+    );
+}
+
+
 // QF callbacks ==============================================================
 void QP::QF::onStartup()
 {
@@ -398,9 +535,11 @@ void QP::QF::onStartup()
     // DO NOT LEAVE THE ISR PRIORITIES AT THE DEFAULT VALUE!
     //
     NVIC_SetPriority(SysTick_IRQn, QF_AWARE_ISR_CMSIS_PRI);
+    NVIC_SetPriority(SSI2_IRQn, QF_AWARE_ISR_CMSIS_PRI + 1U);
     // ...
 
     // enable IRQs...
+    NVIC_EnableIRQ(SSI2_IRQn);
 }
 
 
@@ -580,6 +719,15 @@ void SysTick_Handler(void)
     QV_ARM_ERRATUM_838869();
 }
 
+
+//............................................................................
+void SSI2_IRQHandler(void)
+{
+    // Raised by the uDMA completion of an SPI bus transaction.
+    sSPIDMAEngine.OnInterrupt();
+    QV_ARM_ERRATUM_838869();
+}
+
 } // extern "C"
 
 